@@ -0,0 +1,84 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/arena.hpp>
+#include <base/error.hpp>
+#include <base/stats.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace MathFin {
+
+  Arena::Arena(Size blockSize)
+    : blockSize_(blockSize), current_(0), offset_(0) {
+    MF_REQUIRE(blockSize > 0, "block size must be positive");
+  }
+
+  void* Arena::allocate(Size bytes, Size alignment) {
+    MF_REQUIRE(alignment > 0 && (alignment & (alignment - 1)) == 0,
+               "alignment (" << alignment << ") must be a power of two");
+    for (;;) {
+      if (current_ < blocks_.size()) {
+        Block& block = blocks_[current_];
+        const std::uintptr_t base =
+          reinterpret_cast<std::uintptr_t>(block.data.get());
+        const Size start =
+          Size(((base + offset_ + alignment - 1) & ~(alignment - 1)) - base);
+        if (start + bytes <= block.size) {
+          offset_ = start + bytes;
+          return block.data.get() + start;
+        }
+        if (current_ + 1 < blocks_.size()
+            && blocks_[current_ + 1].size >= bytes + alignment) {
+          ++current_;
+          offset_ = 0;
+          continue;
+        }
+      }
+      // a new block, placed right after the current one so that blocks
+      // kept for reuse stay in allocation order
+      MF_COUNT(ArenaBlocks);
+      Block block;
+      block.size = std::max(blockSize_, bytes + alignment);
+      block.data.reset(new char[block.size]);
+      const Size position = blocks_.empty() ? 0 : current_ + 1;
+      blocks_.insert(blocks_.begin() + position, std::move(block));
+      current_ = position;
+      offset_ = 0;
+    }
+  }
+
+  Size Arena::used() const {
+    Size total = offset_;
+    for (Size i = 0; i < current_ && i < blocks_.size(); ++i) {
+      total += blocks_[i].size;
+    }
+    return total;
+  }
+
+  Size Arena::capacity() const {
+    Size total = 0;
+    for (Size i = 0; i < blocks_.size(); ++i) {
+      total += blocks_[i].size;
+    }
+    return total;
+  }
+
+}
@@ -0,0 +1,165 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file arena.hpp
+ * @brief monotonic arena allocator
+ */
+
+#ifndef MATHFIN_ARENA_HPP
+#define MATHFIN_ARENA_HPP
+
+#include <base/types.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Monotonic memory arena.
+   *
+   * Memory is carved sequentially out of large blocks and is never freed
+   * individually; reset() makes the whole arena available again in
+   * constant time, keeping its blocks for reuse.  A batch job typically
+   * owns one arena and opens a Scope per work item, so that transient
+   * buffers cost a pointer increment and no call to the system allocator
+   * once the arena has warmed up.
+   *
+   * An arena is not thread safe; use one per thread.
+   */
+  class Arena {
+  public:
+    /**
+     * Arena allocating blocks of at least the given number of bytes.
+     */
+    explicit Arena(Size blockSize = 64 * 1024);
+
+    /**
+     * Returns <tt>bytes</tt> bytes aligned on <tt>alignment</tt>, which
+     * must be a power of two.
+     */
+    void* allocate(Size bytes, Size alignment = alignof(std::max_align_t));
+
+    /**
+     * Makes all the memory of the arena available again.  Memory
+     * previously handed out must no longer be used.
+     */
+    void reset() { rewind(Mark{0, 0}); }
+
+    /**
+     * Bytes handed out since the last reset, including alignment padding.
+     */
+    Size used() const;
+
+    /**
+     * Bytes held by the arena.
+     */
+    Size capacity() const;
+
+  private:
+    struct Mark {
+      Size block, offset;
+    };
+
+  public:
+    /**
+     * Releases, on destruction, the memory allocated during its lifetime.
+     * Scopes must be destroyed in reverse order of creation.
+     */
+    class Scope {
+    public:
+      explicit Scope(Arena& arena) : arena_(arena), mark_(arena.mark()) {}
+      ~Scope() { arena_.rewind(mark_); }
+
+    private:
+      Scope(const Scope&);
+      Scope& operator=(const Scope&);
+
+      Arena& arena_;
+      const Mark mark_;
+    };
+
+  private:
+    struct Block {
+      std::unique_ptr<char[]> data;
+      Size size;
+    };
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    Mark mark() const { return Mark{current_, offset_}; }
+    void rewind(const Mark& mark) {
+      current_ = mark.block;
+      offset_ = mark.offset;
+    }
+
+    const Size blockSize_;
+    std::vector<Block> blocks_;
+    Size current_, offset_;
+  };
+
+  /**
+   * Standard allocator drawing memory from an Arena; deallocation is a
+   * no-op.
+   */
+  template <class T>
+  class ArenaAllocator {
+  public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+    T* allocate(Size n) {
+      return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, Size) {}
+
+    Arena* arena() const { return arena_; }
+
+  private:
+    Arena* arena_;
+  };
+
+  /**
+   * @relates ArenaAllocator
+   */
+  template <class T, class U>
+  inline bool operator==(const ArenaAllocator<T>& a,
+                         const ArenaAllocator<U>& b) {
+    return a.arena() == b.arena();
+  }
+
+  /**
+   * @relates ArenaAllocator
+   */
+  template <class T, class U>
+  inline bool operator!=(const ArenaAllocator<T>& a,
+                         const ArenaAllocator<U>& b) {
+    return a.arena() != b.arena();
+  }
+
+}
+
+#endif /* MATHFIN_ARENA_HPP */
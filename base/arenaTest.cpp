@@ -0,0 +1,100 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdint>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/arena.hpp>
+#include <base/error.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Arena allocation and alignment", "[arena]") {
+  Arena arena(1024);
+  REQUIRE(arena.capacity() == 0);
+
+  void* a = arena.allocate(3, 1);
+  void* b = arena.allocate(8, 8);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(b) % 8 == 0);
+  REQUIRE(static_cast<char*>(b) >= static_cast<char*>(a) + 3);
+  REQUIRE(arena.capacity() == 1024);
+
+  // larger than a block
+  void* big = arena.allocate(5000, 64);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(big) % 64 == 0);
+  REQUIRE(arena.capacity() >= 1024 + 5000);
+
+  REQUIRE_THROWS_AS(arena.allocate(8, 3), Error);
+}
+
+TEST_CASE("Arena reset reuses memory", "[arena]") {
+  Arena arena(4096);
+  void* first = arena.allocate(100);
+  for (int i = 0; i < 100; ++i) {
+    arena.allocate(1000);
+  }
+  const Size capacity = arena.capacity();
+
+  arena.reset();
+  REQUIRE(arena.used() == 0);
+  REQUIRE(arena.allocate(100) == first);
+  for (int i = 0; i < 100; ++i) {
+    arena.allocate(1000);
+  }
+  REQUIRE(arena.capacity() == capacity);
+}
+
+TEST_CASE("Arena scopes", "[arena]") {
+  Arena arena(256);
+  arena.allocate(10);
+  const Size used = arena.used();
+  void* next = 0;
+  {
+    Arena::Scope scope(arena);
+    next = arena.allocate(16);
+    for (int i = 0; i < 50; ++i) {
+      arena.allocate(100);
+    }
+  }
+  REQUIRE(arena.used() == used);
+  REQUIRE(arena.allocate(16) == next);
+}
+
+TEST_CASE("Standard containers on an arena", "[arena]") {
+  Arena arena;
+  const Size capacity = [&]() {
+    Arena::Scope scope(arena);
+    std::vector<int, ArenaAllocator<int> > v{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 1000; ++i) {
+      v.push_back(i);
+    }
+    REQUIRE(v[999] == 999);
+    return arena.capacity();
+  }();
+
+  // the second work item finds the memory already there
+  Arena::Scope scope(arena);
+  std::vector<int, ArenaAllocator<int> > w{ArenaAllocator<int>(arena)};
+  for (int i = 0; i < 1000; ++i) {
+    w.push_back(i);
+  }
+  REQUIRE(arena.capacity() == capacity);
+  REQUIRE(ArenaAllocator<int>(arena) == ArenaAllocator<double>(arena));
+}
@@ -22,6 +22,9 @@
  * @brief Utility methods for type conversions.
  */
 
+#ifndef MATHFIN_CONVERSION_HPP
+#define MATHFIN_CONVERSION_HPP
+
 #include <type_traits>
 
 namespace MathFin {
@@ -44,3 +47,5 @@ namespace MathFin {
   }
 
 }
+
+#endif /* MATHFIN_CONVERSION_HPP */
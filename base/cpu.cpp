@@ -0,0 +1,103 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/cpu.hpp>
+#include <base/error.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MATHFIN_CPU_X86
+#endif
+
+namespace MathFin {
+
+  namespace {
+
+    const char* tierNames[cpuTierCount] = {
+      "scalar", "sse4.2", "avx2", "avx512" };
+
+    CpuTier queryCpuTier() {
+#ifdef MATHFIN_CPU_X86
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx512f")
+          && __builtin_cpu_supports("avx512bw")) {
+        return CpuTier::AVX512;
+      }
+      if (__builtin_cpu_supports("avx2")) {
+        return CpuTier::AVX2;
+      }
+      if (__builtin_cpu_supports("sse4.2")
+          && __builtin_cpu_supports("popcnt")) {
+        return CpuTier::SSE42;
+      }
+#endif
+      return CpuTier::Scalar;
+    }
+
+    CpuTier cappedCpuTier() {
+      CpuTier tier = queryCpuTier();
+      const char* cap = std::getenv("MATHFIN_CPU_TIER");
+      if (cap != 0) {
+        for (int i = 0; i < cpuTierCount; ++i) {
+          if (std::strcmp(cap, tierNames[i]) == 0 && i < as_integer(tier)) {
+            tier = CpuTier(i);
+          }
+        }
+      }
+      return tier;
+    }
+
+    // -1 when no tier is forced
+    std::atomic<int> forcedTier(-1);
+
+  }
+
+  std::ostream& operator<<(std::ostream& out, const CpuTier& tier) {
+    return out << tierNames[as_integer(tier)];
+  }
+
+  CpuTier detectedCpuTier() {
+    static const CpuTier tier = cappedCpuTier();
+    return tier;
+  }
+
+  CpuTier activeCpuTier() {
+    const int forced = forcedTier.load(std::memory_order_relaxed);
+    return forced < 0 ? detectedCpuTier() : CpuTier(forced);
+  }
+
+  bool cpuTierForced() {
+    return forcedTier.load(std::memory_order_relaxed) >= 0;
+  }
+
+  void forceCpuTier(CpuTier tier) {
+    MF_REQUIRE(tier <= detectedCpuTier(),
+               "tier " << tier << " not supported; the processor supports up to "
+               << detectedCpuTier());
+    forcedTier.store(as_integer(tier), std::memory_order_relaxed);
+  }
+
+  void resetCpuTier() {
+    forcedTier.store(-1, std::memory_order_relaxed);
+  }
+
+}
@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file cpu.hpp
+ * @brief run-time selection of instruction-set specific kernels
+ */
+
+#ifndef MATHFIN_CPU_HPP
+#define MATHFIN_CPU_HPP
+
+#include <base/conversion.hpp>
+
+#include <iostream>
+
+namespace MathFin {
+
+  /**
+   * Instruction-set tiers for which batch kernels may be specialised.
+   *
+   * Tiers are ordered: a processor supporting a tier supports all the
+   * lower ones.
+   */
+  enum class CpuTier {
+    Scalar = 0,  //!< portable C++
+    SSE42  = 1,  //!< SSE4.2 and POPCNT
+    AVX2   = 2,  //!< AVX2
+    AVX512 = 3   //!< AVX-512 foundation and byte/word instructions
+  };
+
+  /**
+   * Number of tiers in CpuTier.
+   */
+  const int cpuTierCount = 4;
+
+  /**
+   * @relates CpuTier
+   */
+  std::ostream& operator<<(std::ostream&, const CpuTier&);
+
+  /**
+   * Highest tier supported by the processor and the operating system.
+   *
+   * The processor is queried once, on first use.  Setting the environment
+   * variable <tt>MATHFIN_CPU_TIER</tt> to <tt>scalar</tt>, <tt>sse4.2</tt>,
+   * <tt>avx2</tt> or <tt>avx512</tt> caps the result, so that a lower tier
+   * can be exercised without recompiling.  Binaries built for other
+   * architectures always report CpuTier::Scalar.
+   */
+  CpuTier detectedCpuTier();
+
+  /**
+   * Tier whose kernels are currently used: the detected one unless a tier
+   * has been forced.
+   */
+  CpuTier activeCpuTier();
+
+  /**
+   * Whether a tier is currently forced.
+   */
+  bool cpuTierForced();
+
+  /**
+   * Forces kernels of the given tier to be used; meant for testing every
+   * variant on a single machine.  The tier must not exceed
+   * detectedCpuTier().
+   */
+  void forceCpuTier(CpuTier tier);
+
+  /**
+   * Reverts to the detected tier.
+   */
+  void resetCpuTier();
+
+  /**
+   * Forces a tier for the lifetime of the object, then restores whatever
+   * was forced before, or the detected tier if nothing was.
+   */
+  class ScopedCpuTier {
+  public:
+    explicit ScopedCpuTier(CpuTier tier)
+    : previous_(activeCpuTier()), wasForced_(cpuTierForced()) {
+      forceCpuTier(tier);
+    }
+    ~ScopedCpuTier() {
+      if (wasForced_)
+        forceCpuTier(previous_);
+      else
+        resetCpuTier();
+    }
+
+  private:
+    ScopedCpuTier(const ScopedCpuTier&);
+    ScopedCpuTier& operator=(const ScopedCpuTier&);
+
+    CpuTier previous_;
+    bool wasForced_;
+  };
+
+  /**
+   * Selects, among one variant per tier, the one for the active tier.
+   */
+  template <class T>
+  inline const T& selectForCpu(const T (&variants)[cpuTierCount]) {
+    return variants[as_integer(activeCpuTier())];
+  }
+
+}
+
+#endif /* MATHFIN_CPU_HPP */
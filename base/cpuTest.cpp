@@ -0,0 +1,66 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+
+#include <test/catch.hpp>
+#include <base/cpu.hpp>
+#include <base/error.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Forcing CPU tiers", "[cpu]") {
+  const CpuTier detected = detectedCpuTier();
+  REQUIRE(activeCpuTier() == detected);
+  REQUIRE_FALSE(cpuTierForced());
+
+  for (int i = 0; i <= as_integer(detected); ++i) {
+    ScopedCpuTier forced((CpuTier(i)));
+    REQUIRE(activeCpuTier() == CpuTier(i));
+    REQUIRE(cpuTierForced());
+  }
+  REQUIRE(activeCpuTier() == detected);
+  REQUIRE_FALSE(cpuTierForced());
+
+  forceCpuTier(CpuTier::Scalar);
+  REQUIRE(activeCpuTier() == CpuTier::Scalar);
+  {
+    ScopedCpuTier forced(detected);
+    REQUIRE(activeCpuTier() == detected);
+  }
+  REQUIRE(activeCpuTier() == CpuTier::Scalar);
+  REQUIRE(cpuTierForced());
+  resetCpuTier();
+  REQUIRE(activeCpuTier() == detected);
+  REQUIRE_FALSE(cpuTierForced());
+
+  if (detected != CpuTier::AVX512) {
+    REQUIRE_THROWS_AS(forceCpuTier(CpuTier::AVX512), Error);
+  }
+}
+
+TEST_CASE("Selecting variants", "[cpu]") {
+  const int variants[cpuTierCount] = { 10, 11, 12, 13 };
+  ScopedCpuTier forced(CpuTier::Scalar);
+  REQUIRE(selectForCpu(variants) == 10);
+
+  std::ostringstream out;
+  out << CpuTier::AVX2;
+  REQUIRE(out.str() == "avx2");
+}
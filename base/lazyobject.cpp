@@ -0,0 +1,92 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/lazyobject.hpp>
+
+namespace MathFin {
+
+  LazyObject::LazyObject()
+    : calculated_(false), frozen_(false), updatedWhileFrozen_(false),
+      alwaysForward_(false) {}
+
+  void LazyObject::update() {
+    if (frozen_) {
+      updatedWhileFrozen_ = true;
+    } else {
+      calculated_ = false;
+    }
+  }
+
+  Observable* LazyObject::forwardingObservable() {
+    // queried before update(): a dirty object has already passed on the
+    // change of its results
+    if (frozen_ || (!calculated_ && !alwaysForward_)) {
+      return 0;
+    }
+    return this;
+  }
+
+  void LazyObject::recalculate() {
+    const bool frozen = frozen_;
+    calculated_ = false;
+    frozen_ = false;
+    try {
+      calculate();
+    } catch (...) {
+      frozen_ = frozen;
+      notifyObservers();
+      throw;
+    }
+    frozen_ = frozen;
+    notifyObservers();
+  }
+
+  void LazyObject::freeze() {
+    frozen_ = true;
+  }
+
+  void LazyObject::unfreeze() {
+    if (frozen_) {
+      frozen_ = false;
+      if (updatedWhileFrozen_) {
+        updatedWhileFrozen_ = false;
+        calculated_ = false;
+        notifyObservers();
+      }
+    }
+  }
+
+  void LazyObject::alwaysForwardNotifications() {
+    alwaysForward_ = true;
+  }
+
+  void LazyObject::calculate() const {
+    if (!calculated_ && !frozen_) {
+      // set first to stop infinite recursion through dependencies
+      calculated_ = true;
+      try {
+        performCalculations();
+      } catch (...) {
+        calculated_ = false;
+        throw;
+      }
+    }
+  }
+
+}
@@ -0,0 +1,96 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file lazyobject.hpp
+ * @brief framework for calculations on demand and result caching
+ */
+
+#ifndef MATHFIN_LAZYOBJECT_HPP
+#define MATHFIN_LAZYOBJECT_HPP
+
+#include <base/observable.hpp>
+
+namespace MathFin {
+
+  /**
+   * Object whose results are recalculated only when asked for after one
+   * of its inputs changed.
+   *
+   * A notification marks the object dirty and is passed on to its own
+   * observers; nothing is recalculated until calculate() is called,
+   * usually by an inspector of the results.  A dirty object does not
+   * pass on further notifications, since its observers were already told
+   * that its results changed, unless alwaysForwardNotifications() was
+   * called.
+   *
+   * A frozen object keeps its results and passes on no notifications;
+   * when it is unfrozen after missing some, it becomes dirty and notifies
+   * its observers.
+   */
+  class LazyObject : public virtual Observable, public Observer {
+  public:
+    LazyObject();
+
+    void update();
+
+    /**
+     * Recalculates the results now, even if they are up to date.
+     */
+    void recalculate();
+
+    void freeze();
+    void unfreeze();
+    bool isFrozen() const { return frozen_; }
+
+    /**
+     * Whether the results are up to date.
+     */
+    bool isCalculated() const { return calculated_; }
+
+    /**
+     * Passes on every notification, also while dirty.
+     */
+    void alwaysForwardNotifications();
+
+  protected:
+    /**
+     * Calls performCalculations() if the results are not up to date and
+     * the object is not frozen.
+     */
+    void calculate() const;
+
+    /**
+     * Computes the results; called by calculate() at most once between
+     * notifications.
+     */
+    virtual void performCalculations() const = 0;
+
+    Observable* forwardingObservable();
+
+  private:
+    mutable bool calculated_;
+    bool frozen_;
+    bool updatedWhileFrozen_;
+    bool alwaysForward_;
+  };
+
+}
+
+#endif /* MATHFIN_LAZYOBJECT_HPP */
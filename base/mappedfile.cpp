@@ -0,0 +1,62 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/mappedfile.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace MathFin {
+
+  MappedFile::MappedFile(const std::string& path) : data_(0), size_(0) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    MF_REQUIRE(fd >= 0, "cannot open '" << path << "': "
+               << std::strerror(errno));
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      const int error = errno;
+      ::close(fd);
+      MF_FAIL("cannot stat '" << path << "': " << std::strerror(error));
+    }
+    size_ = Size(st.st_size);
+    if (size_ > 0) {
+      void* p = ::mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p == MAP_FAILED) {
+        const int error = errno;
+        ::close(fd);
+        MF_FAIL("cannot map '" << path << "': " << std::strerror(error));
+      }
+      data_ = static_cast<const unsigned char*>(p);
+    }
+    // the mapping stays valid once the descriptor is closed
+    ::close(fd);
+  }
+
+  MappedFile::~MappedFile() {
+    if (data_) {
+      ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+  }
+
+}
@@ -0,0 +1,62 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file mappedfile.hpp
+ * @brief read-only memory mapping of a file
+ */
+
+#ifndef MATHFIN_MAPPEDFILE_HPP
+#define MATHFIN_MAPPEDFILE_HPP
+
+#include <base/types.hpp>
+
+#include <string>
+
+namespace MathFin {
+
+  /**
+   * A file mapped read-only into memory.
+   *
+   * Pages are loaded by the operating system on first access, so that
+   * opening a large file costs a system call regardless of its size and
+   * the parts never read are never loaded.
+   */
+  class MappedFile {
+  public:
+    /**
+     * Maps the whole file; throws an Error if it cannot be opened.
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    const unsigned char* data() const { return data_; }
+    Size size() const { return size_; }
+
+  private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const unsigned char* data_;
+    Size size_;
+  };
+
+}
+
+#endif /* MATHFIN_MAPPEDFILE_HPP */
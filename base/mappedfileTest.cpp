@@ -0,0 +1,46 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <test/catch.hpp>
+#include <base/error.hpp>
+#include <base/mappedfile.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Mapped files expose the file contents", "[mappedfile]") {
+  const std::string path = "mappedfileTest.bin";
+  const std::string contents(10000, 'x');
+  {
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << contents << "end";
+  }
+  {
+    const MappedFile mapped(path);
+    REQUIRE(mapped.size() == contents.size() + 3);
+    REQUIRE(std::string(mapped.data(), mapped.data() + mapped.size())
+            == contents + "end");
+  }
+  std::remove(path.c_str());
+
+  REQUIRE_THROWS_AS(MappedFile("mappedfileTest.bin"), Error);
+}
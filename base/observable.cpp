@@ -0,0 +1,242 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/observable.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace MathFin {
+
+  namespace {
+
+    // observer being collected, the observable it forwards through and
+    // the next of its observers to visit
+    struct Frame {
+      Observer* observer;
+      Observable* forward;
+      Size next;
+    };
+
+    struct NotificationState {
+      NotificationState() : batches(0), delivering(false), wave(0) {}
+      Size batches;
+      bool delivering;
+      BigNatural wave;
+      std::vector<Observable*> pending;
+    };
+
+    // waves are numbered globally so that the marks left on objects by
+    // one thread are never mistaken for those of another
+    std::atomic<BigNatural> waves(0);
+
+    thread_local NotificationState state;
+
+    template <class T>
+    void erase(std::vector<T*>& v, T* x) {
+      typename std::vector<T*>::iterator i = std::find(v.begin(), v.end(), x);
+      if (i != v.end()) {
+        v.erase(i);
+      }
+    }
+
+  }
+
+  Observable::Observable() : wave_(0), pending_(false) {}
+
+  Observable::Observable(const Observable&) : wave_(0), pending_(false) {}
+
+  Observable& Observable::operator=(const Observable&) {
+    // the observers keep observing this object
+    return *this;
+  }
+
+  Observable::~Observable() {
+    for (Size i = 0; i < observers_.size(); ++i) {
+      erase(observers_[i]->observables_, this);
+    }
+    if (pending_) {
+      erase(state.pending, this);
+    }
+  }
+
+  void Observable::notifyObservers() {
+    Observable* self = this;
+    deliverNotifications(&self, 1);
+  }
+
+  void deliverNotifications(Observable* const* sources, Size n) {
+    if (state.batches > 0 || state.delivering) {
+      for (Size k = 0; k < n; ++k) {
+        Observable* source = sources[k];
+        // within a wave, observables it reached are already delivered
+        if (!source->pending_
+            && !(state.delivering && source->wave_ == state.wave)) {
+          source->pending_ = true;
+          state.pending.push_back(source);
+        }
+      }
+      return;
+    }
+
+    static thread_local std::vector<Frame> stack;
+    static thread_local std::vector<Observer*> order;
+    std::exception_ptr error;
+
+    auto deliver = [&](Observable* const* first, Size count) {
+      const BigNatural wave = ++waves;
+      state.wave = wave;
+      order.clear();
+      for (Size k = 0; k < count; ++k) {
+        Observable* source = first[k];
+        source->wave_ = wave;
+        source->pending_ = false;
+        for (Size i = 0; i < source->observers_.size(); ++i) {
+          Observer* root = source->observers_[i];
+          if (root->wave_ == wave) {
+            continue;
+          }
+          // depth-first collection; an observer is appended once all
+          // the observers depending on it are
+          root->wave_ = wave;
+          const Frame frame = { root, root->forwardingObservable(), 0 };
+          stack.push_back(frame);
+          while (!stack.empty()) {
+            Frame& top = stack.back();
+            if (top.forward && top.next < top.forward->observers_.size()) {
+              top.forward->wave_ = wave;
+              Observer* child = top.forward->observers_[top.next++];
+              if (child->wave_ != wave) {
+                child->wave_ = wave;
+                const Frame next = { child, child->forwardingObservable(), 0 };
+                stack.push_back(next);
+              }
+            } else {
+              if (top.forward) {
+                top.forward->wave_ = wave;
+              }
+              order.push_back(top.observer);
+              stack.pop_back();
+            }
+          }
+        }
+      }
+
+      // reverse post-order is a topological order
+      state.delivering = true;
+      for (Size k = order.size(); k > 0; --k) {
+        try {
+          order[k - 1]->update();
+        } catch (...) {
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+      state.delivering = false;
+    };
+
+    deliver(sources, n);
+    // observables notified from update() and not reached by the wave
+    std::vector<Observable*> next;
+    while (!state.pending.empty()) {
+      next.swap(state.pending);
+      state.pending.clear();
+      deliver(&next[0], next.size());
+      next.clear();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  Observer::Observer() : wave_(0) {}
+
+  Observer::Observer(const Observer& other) : wave_(0) {
+    for (Size i = 0; i < other.observables_.size(); ++i) {
+      registerWith(other.observables_[i]);
+    }
+  }
+
+  Observer& Observer::operator=(const Observer& other) {
+    if (this != &other) {
+      unregisterWithAll();
+      for (Size i = 0; i < other.observables_.size(); ++i) {
+        registerWith(other.observables_[i]);
+      }
+    }
+    return *this;
+  }
+
+  Observer::~Observer() {
+    unregisterWithAll();
+  }
+
+  void Observer::registerWith(Observable* observable) {
+    if (observable && std::find(observables_.begin(), observables_.end(),
+                                observable) == observables_.end()) {
+      observables_.push_back(observable);
+      observable->observers_.push_back(this);
+    }
+  }
+
+  void Observer::unregisterWith(Observable* observable) {
+    if (observable) {
+      erase(observables_, observable);
+      erase(observable->observers_, this);
+    }
+  }
+
+  void Observer::unregisterWithAll() {
+    for (Size i = 0; i < observables_.size(); ++i) {
+      erase(observables_[i]->observers_, this);
+    }
+    observables_.clear();
+  }
+
+  // ---------------------------------------------------------------------------
+
+  NotificationBatch::NotificationBatch() {
+    ++state.batches;
+  }
+
+  NotificationBatch::~NotificationBatch() noexcept(false) {
+    // from within update(), the wave being delivered takes them over
+    if (--state.batches > 0 || state.delivering || state.pending.empty()) {
+      return;
+    }
+    std::vector<Observable*> sources;
+    sources.swap(state.pending);
+    if (std::uncaught_exception()) {
+      try {
+        deliverNotifications(&sources[0], sources.size());
+      } catch (...) {}
+    } else {
+      deliverNotifications(&sources[0], sources.size());
+    }
+  }
+
+  bool NotificationBatch::active() {
+    return state.batches > 0;
+  }
+
+}
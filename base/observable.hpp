@@ -0,0 +1,165 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file observable.hpp
+ * @brief observer graph with coalesced, topologically ordered notification
+ */
+
+#ifndef MATHFIN_OBSERVABLE_HPP
+#define MATHFIN_OBSERVABLE_HPP
+
+#include <base/types.hpp>
+
+#include <vector>
+
+namespace MathFin {
+
+  class Observer;
+
+  /**
+   * Object whose changes are notified to its observers.
+   *
+   * Observables and observers form a graph, observers which are
+   * themselves observable (such as LazyObject) forwarding notifications
+   * further.  Instead of each object notifying its observers in turn,
+   * which in a graph with shared dependencies updates an object once per
+   * path reaching it, a notification is delivered as a wave: the
+   * observers reachable from the notified observables are collected
+   * first and each is updated exactly once, in topological order, so
+   * that an observer is updated after all the observers it depends on.
+   * Observables notified again from within update() while the wave is
+   * delivered are part of it and are ignored; others start a new wave.
+   *
+   * Within a NotificationBatch notifications are only recorded, and
+   * delivered as a single wave when the outermost batch ends.
+   *
+   * The graph is not thread safe; notification state is kept per
+   * thread.  Observers must not be destroyed from update().
+   */
+  class Observable {
+  public:
+    Observable();
+
+    /**
+     * A copy has no observers.
+     */
+    Observable(const Observable&);
+    Observable& operator=(const Observable&);
+
+    virtual ~Observable();
+
+    /**
+     * Notifies the observers, now or at the end of the current batch.
+     * If updates throw, all observers are still updated and the first
+     * exception is rethrown.
+     */
+    void notifyObservers();
+
+    Size observers() const { return observers_.size(); }
+
+  private:
+    friend class Observer;
+    friend class NotificationBatch;
+    friend void deliverNotifications(Observable* const*, Size);
+
+    std::vector<Observer*> observers_;
+    // wave which last reached the observable; pending in a batch
+    BigNatural wave_;
+    bool pending_;
+  };
+
+  /**
+   * Object updated when the observables it registered with change.
+   */
+  class Observer {
+  public:
+    virtual ~Observer();
+
+    void registerWith(Observable* observable);
+    void unregisterWith(Observable* observable);
+    void unregisterWithAll();
+
+    /**
+     * Called once per notification wave reaching the observer.
+     */
+    virtual void update() = 0;
+
+  protected:
+    Observer();
+
+    /**
+     * A copy observes the same observables.
+     */
+    Observer(const Observer&);
+    Observer& operator=(const Observer&);
+
+    /**
+     * The observable through which the observer passes notifications
+     * on, or null if it does not; it is queried when a wave is collected,
+     * before update() is called.
+     */
+    virtual Observable* forwardingObservable() { return 0; }
+
+  private:
+    friend class Observable;
+    friend void deliverNotifications(Observable* const*, Size);
+
+    std::vector<Observable*> observables_;
+    // wave which last collected the observer
+    BigNatural wave_;
+  };
+
+  /**
+   * Delivers one notification wave from the given observables.
+   * @relates Observable
+   */
+  void deliverNotifications(Observable* const* sources, Size n);
+
+  /**
+   * Defers notifications while alive.
+   *
+   * Bulk updates, such as moving every quote of a market, notify each
+   * changed observable within a batch; when the outermost batch ends,
+   * each observer reachable from any of them is updated once.  Batches
+   * nest and are per thread.
+   */
+  class NotificationBatch {
+  public:
+    NotificationBatch();
+
+    /**
+     * Delivers the deferred notifications if this is the outermost
+     * batch and no exception is propagating.
+     */
+    ~NotificationBatch() noexcept(false);
+
+    /**
+     * Whether notifications are currently deferred on this thread.
+     */
+    static bool active();
+
+  private:
+    NotificationBatch(const NotificationBatch&);
+    NotificationBatch& operator=(const NotificationBatch&);
+  };
+
+}
+
+#endif /* MATHFIN_OBSERVABLE_HPP */
@@ -0,0 +1,260 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/lazyobject.hpp>
+#include <base/observable.hpp>
+
+using namespace MathFin;
+
+namespace {
+
+  // records the order in which observers are updated
+  std::vector<std::string> updates;
+
+  class Quote : public Observable {
+  public:
+    explicit Quote(Real value) : value_(value) {}
+    Real value() const { return value_; }
+    void setValue(Real value) {
+      value_ = value;
+      notifyObservers();
+    }
+  private:
+    Real value_;
+  };
+
+  class Recorder : public Observer {
+  public:
+    explicit Recorder(const std::string& name) : name_(name), count_(0) {}
+    void update() {
+      updates.push_back(name_);
+      ++count_;
+    }
+    Size count() const { return count_; }
+  private:
+    std::string name_;
+    Size count_;
+  };
+
+  // sum of its inputs, each either a quote or another sum
+  class Sum : public LazyObject {
+  public:
+    explicit Sum(const std::string& name) : name_(name), calculations_(0) {}
+    void add(Quote* quote) {
+      quotes_.push_back(quote);
+      registerWith(quote);
+    }
+    void add(Sum* sum) {
+      sums_.push_back(sum);
+      registerWith(sum);
+    }
+    Real value() const {
+      calculate();
+      return value_;
+    }
+    Size calculations() const { return calculations_; }
+    void update() {
+      updates.push_back(name_);
+      LazyObject::update();
+    }
+  private:
+    void performCalculations() const {
+      ++calculations_;
+      value_ = 0.0;
+      for (Size i = 0; i < quotes_.size(); ++i) {
+        value_ += quotes_[i]->value();
+      }
+      for (Size i = 0; i < sums_.size(); ++i) {
+        value_ += sums_[i]->value();
+      }
+    }
+    std::string name_;
+    std::vector<Quote*> quotes_;
+    std::vector<Sum*> sums_;
+    mutable Real value_;
+    mutable Size calculations_;
+  };
+
+  class Failing : public Observer {
+  public:
+    void update() { throw std::runtime_error("failed update"); }
+  };
+
+  Size position(const std::string& name) {
+    for (Size i = 0; i < updates.size(); ++i) {
+      if (updates[i] == name) {
+        return i;
+      }
+    }
+    return updates.size();
+  }
+
+}
+
+TEST_CASE("Observers are updated once per notification", "[observable]") {
+  updates.clear();
+  Quote quote(1.0);
+  Recorder recorder("recorder");
+  recorder.registerWith(&quote);
+  recorder.registerWith(&quote);
+  REQUIRE(quote.observers() == 1);
+
+  quote.setValue(2.0);
+  REQUIRE(recorder.count() == 1);
+
+  recorder.unregisterWith(&quote);
+  quote.setValue(3.0);
+  REQUIRE(recorder.count() == 1);
+
+  // destroyed observables and observers unregister themselves
+  std::unique_ptr<Quote> temporary(new Quote(1.0));
+  recorder.registerWith(temporary.get());
+  {
+    Recorder other("other");
+    other.registerWith(temporary.get());
+    REQUIRE(temporary->observers() == 2);
+  }
+  REQUIRE(temporary->observers() == 1);
+  temporary.reset();
+  recorder.unregisterWithAll();
+}
+
+TEST_CASE("Shared dependencies are updated once, in dependency order",
+          "[observable]") {
+  // a -> b, c -> d, with d also observing a and a recorder on d
+  Quote a(1.0);
+  Sum b("b"), c("c"), d("d");
+  b.add(&a);
+  c.add(&a);
+  d.add(&b);
+  d.add(&c);
+  d.registerWith(&a);
+  Recorder top("top");
+  top.registerWith(&d);
+  REQUIRE(d.value() == 2.0);
+  REQUIRE(d.calculations() == 1);
+
+  updates.clear();
+  a.setValue(2.0);
+  REQUIRE(updates.size() == 4);
+  REQUIRE(position("b") < position("d"));
+  REQUIRE(position("c") < position("d"));
+  REQUIRE(position("d") < position("top"));
+  REQUIRE(!d.isCalculated());
+
+  // dirty objects pass on no further notifications
+  updates.clear();
+  a.setValue(3.0);
+  REQUIRE(top.count() == 1);
+  REQUIRE(d.value() == 6.0);
+  REQUIRE(d.value() == 6.0);
+  REQUIRE(d.calculations() == 2);
+}
+
+TEST_CASE("Batched notifications are coalesced", "[observable]") {
+  std::vector<Quote> quotes(50, Quote(1.0));
+  Sum total("total");
+  for (Size i = 0; i < quotes.size(); ++i) {
+    total.add(&quotes[i]);
+  }
+  Recorder recorder("recorder");
+  recorder.registerWith(&total);
+  REQUIRE(total.value() == 50.0);
+
+  {
+    NotificationBatch batch;
+    REQUIRE(NotificationBatch::active());
+    for (Size i = 0; i < quotes.size(); ++i) {
+      quotes[i].setValue(2.0);
+      {
+        NotificationBatch nested;
+        quotes[i].setValue(3.0);
+      }
+    }
+    REQUIRE(recorder.count() == 0);
+    REQUIRE(total.isCalculated());
+  }
+  REQUIRE(!NotificationBatch::active());
+  REQUIRE(recorder.count() == 1);
+  REQUIRE(total.value() == 150.0);
+  REQUIRE(total.calculations() == 2);
+}
+
+TEST_CASE("Frozen objects keep their results", "[observable]") {
+  Quote quote(1.0);
+  Sum sum("sum");
+  sum.add(&quote);
+  Recorder recorder("recorder");
+  recorder.registerWith(&sum);
+  REQUIRE(sum.value() == 1.0);
+
+  sum.freeze();
+  quote.setValue(2.0);
+  REQUIRE(sum.value() == 1.0);
+  REQUIRE(recorder.count() == 0);
+
+  sum.unfreeze();
+  REQUIRE(recorder.count() == 1);
+  REQUIRE(sum.value() == 2.0);
+
+  sum.recalculate();
+  REQUIRE(sum.calculations() == 3);
+  REQUIRE(recorder.count() == 2);
+}
+
+TEST_CASE("Long dependency chains are notified without recursion",
+          "[observable]") {
+  const Size n = 100000;
+  Quote quote(1.0);
+  std::vector<std::unique_ptr<Sum> > chain;
+  for (Size i = 0; i < n; ++i) {
+    chain.push_back(std::unique_ptr<Sum>(new Sum("link")));
+    if (i == 0) {
+      chain[i]->add(&quote);
+    } else {
+      chain[i]->add(chain[i - 1].get());
+    }
+    chain[i]->value();
+  }
+  Recorder recorder("recorder");
+  recorder.registerWith(chain.back().get());
+
+  updates.clear();
+  quote.setValue(2.0);
+  REQUIRE(updates.size() == n + 1);
+  REQUIRE(updates.back() == "recorder");
+  // destroying the chain from its head
+  chain.clear();
+}
+
+TEST_CASE("Failing updates do not stop the notification", "[observable]") {
+  Quote quote(1.0);
+  Failing failing;
+  Recorder recorder("recorder");
+  failing.registerWith(&quote);
+  recorder.registerWith(&quote);
+  REQUIRE_THROWS_AS(quote.setValue(2.0), std::runtime_error);
+  REQUIRE(recorder.count() == 1);
+}
@@ -0,0 +1,256 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file smallvector.hpp
+ * @brief vector with inline storage
+ */
+
+#ifndef MATHFIN_SMALLVECTOR_HPP
+#define MATHFIN_SMALLVECTOR_HPP
+
+#include <base/types.hpp>
+
+#include <algorithm>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace MathFin {
+
+  /**
+   * Sequence storing up to <tt>N</tt> elements inline, falling back to
+   * the heap beyond.
+   *
+   * Elements are only ever copy- or move-constructed and destroyed, never
+   * assigned, so that types without an assignment operator (such as Date)
+   * can be stored.  Like std::vector, growing invalidates iterators and
+   * references.
+   */
+  template <class T, Size N>
+  class SmallVector {
+    static_assert(N > 0, "inline capacity must be positive");
+
+  public:
+    typedef T value_type;
+    typedef Size size_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    SmallVector() : data_(inlineData()), size_(0), capacity_(N) {}
+
+    SmallVector(std::initializer_list<T> values)
+      : data_(inlineData()), size_(0), capacity_(N) {
+      reserve(values.size());
+      for (const T* p = values.begin(); p != values.end(); ++p) {
+        new (data_ + size_++) T(*p);
+      }
+    }
+
+    SmallVector(const SmallVector& other)
+      : data_(inlineData()), size_(0), capacity_(N) {
+      append(other);
+    }
+
+    SmallVector(SmallVector&& other)
+      : data_(inlineData()), size_(0), capacity_(N) {
+      steal(other);
+    }
+
+    ~SmallVector() {
+      clear();
+      release();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+      if (this != &other) {
+        clear();
+        append(other);
+      }
+      return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) {
+      if (this != &other) {
+        clear();
+        release();
+        steal(other);
+      }
+      return *this;
+    }
+
+    Size size() const { return size_; }
+    Size capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * Whether the elements are stored inline, i.e., no heap memory is
+     * used.
+     */
+    bool isInline() const { return data_ == inlineData(); }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    T& operator[](Size i) { return data_[i]; }
+    const T& operator[](Size i) const { return data_[i]; }
+    T& front() { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <class... Args>
+    void emplace_back(Args&&... args) {
+      if (size_ == capacity_) {
+        // construct first: the arguments may refer to current elements
+        T* buffer = allocate(capacity_ * 2);
+        new (buffer + size_) T(std::forward<Args>(args)...);
+        relocate(buffer, capacity_ * 2);
+      } else {
+        new (data_ + size_) T(std::forward<Args>(args)...);
+      }
+      ++size_;
+    }
+
+    void pop_back() {
+      data_[--size_].~T();
+    }
+
+    void clear() {
+      while (size_ > 0) {
+        pop_back();
+      }
+    }
+
+    void reserve(Size n) {
+      if (n > capacity_) {
+        relocate(allocate(n), n);
+      }
+    }
+
+    /**
+     * Shrinks or grows to <tt>n</tt> elements; new elements are
+     * value-initialised.
+     */
+    void resize(Size n) {
+      reserve(n);
+      while (size_ > n) {
+        pop_back();
+      }
+      while (size_ < n) {
+        new (data_ + size_) T();
+        ++size_;
+      }
+    }
+
+  private:
+    typedef typename std::aligned_storage<sizeof(T),
+                                          std::alignment_of<T>::value>::type
+      storage_type;
+
+    T* inlineData() { return reinterpret_cast<T*>(storage_); }
+    const T* inlineData() const {
+      return reinterpret_cast<const T*>(storage_);
+    }
+
+    static T* allocate(Size n) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    // moves the elements to the given buffer, which becomes the storage
+    void relocate(T* buffer, Size capacity) {
+      for (Size i = 0; i < size_; ++i) {
+        new (buffer + i) T(std::move(data_[i]));
+        data_[i].~T();
+      }
+      release();
+      data_ = buffer;
+      capacity_ = capacity;
+    }
+
+    void release() {
+      if (!isInline()) {
+        ::operator delete(data_);
+        data_ = inlineData();
+        capacity_ = N;
+      }
+    }
+
+    void append(const SmallVector& other) {
+      reserve(size_ + other.size_);
+      for (Size i = 0; i < other.size_; ++i) {
+        new (data_ + size_) T(other.data_[i]);
+        ++size_;
+      }
+    }
+
+    // takes over the heap buffer of other, or moves its inline elements
+    void steal(SmallVector& other) {
+      if (other.isInline()) {
+        for (Size i = 0; i < other.size_; ++i) {
+          new (data_ + i) T(std::move(other.data_[i]));
+        }
+        size_ = other.size_;
+        other.clear();
+      } else {
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inlineData();
+        other.size_ = 0;
+        other.capacity_ = N;
+      }
+    }
+
+    storage_type storage_[N];
+    T* data_;
+    Size size_, capacity_;
+  };
+
+  /**
+   * @relates SmallVector
+   */
+  template <class T, Size N>
+  inline bool operator==(const SmallVector<T, N>& a,
+                         const SmallVector<T, N>& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+
+  /**
+   * @relates SmallVector
+   */
+  template <class T, Size N>
+  inline bool operator!=(const SmallVector<T, N>& a,
+                         const SmallVector<T, N>& b) {
+    return !(a == b);
+  }
+
+}
+
+#endif /* MATHFIN_SMALLVECTOR_HPP */
@@ -0,0 +1,111 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <utility>
+
+#include <test/catch.hpp>
+#include <base/smallvector.hpp>
+
+using namespace MathFin;
+
+namespace {
+  // neither assignable nor default constructible
+  class Value {
+  public:
+    explicit Value(int v) : v_(v) { ++live; }
+    Value(const Value& other) : v_(other.v_) { ++live; }
+    ~Value() { --live; }
+    int value() const { return v_; }
+    static int live;
+  private:
+    Value& operator=(const Value&);
+    const int v_;
+  };
+  int Value::live = 0;
+}
+
+TEST_CASE("Small vector stays inline", "[smallvector]") {
+  SmallVector<int, 8> v;
+  REQUIRE(v.empty());
+  for (int i = 0; i < 8; ++i) {
+    v.push_back(i);
+  }
+  REQUIRE(v.isInline());
+  REQUIRE(v.size() == 8);
+  REQUIRE(v.capacity() == 8);
+
+  v.push_back(8);
+  REQUIRE(!v.isInline());
+  for (int i = 0; i < 9; ++i) {
+    REQUIRE(v[i] == i);
+  }
+
+  v.resize(3);
+  REQUIRE(v.size() == 3);
+  REQUIRE(v.back() == 2);
+  v.resize(5);
+  REQUIRE(v[4] == 0);
+}
+
+TEST_CASE("Small vector of non-assignable values", "[smallvector]") {
+  {
+    SmallVector<Value, 4> v;
+    for (int i = 0; i < 10; ++i) {
+      v.emplace_back(i);
+    }
+    // the argument refers to an element while the storage grows
+    SmallVector<Value, 4> w{Value(1), Value(2), Value(3), Value(4)};
+    w.push_back(w[0]);
+    REQUIRE(w.size() == 5);
+    REQUIRE(w[4].value() == 1);
+
+    SmallVector<Value, 4> copy(v);
+    REQUIRE(copy.size() == 10);
+    REQUIRE(copy[9].value() == 9);
+
+    copy = w;
+    REQUIRE(copy.size() == 5);
+
+    SmallVector<Value, 4> moved(std::move(v));
+    REQUIRE(moved.size() == 10);
+    REQUIRE(v.empty());
+    REQUIRE(v.isInline());
+  }
+  REQUIRE(Value::live == 0);
+}
+
+TEST_CASE("Moving inline and heap small vectors", "[smallvector]") {
+  SmallVector<std::string, 2> a{"one", "two"};
+  SmallVector<std::string, 2> b(std::move(a));
+  REQUIRE(b.isInline());
+  REQUIRE(b[1] == "two");
+
+  b.push_back("three");
+  SmallVector<std::string, 2> c;
+  c = std::move(b);
+  REQUIRE(!c.isInline());
+  REQUIRE(c.size() == 3);
+  REQUIRE(b.empty());
+
+  SmallVector<std::string, 2> d{"one", "two", "three"};
+  REQUIRE(c == d);
+  d.pop_back();
+  REQUIRE(c != d);
+}
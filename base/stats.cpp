@@ -0,0 +1,499 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/stats.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace MathFin {
+
+  namespace {
+
+    const char* counterNames[counterCount] = {
+      "calendar.isBusinessDay",
+      "calendar.adjust",
+      "calendar.advance",
+      "calendar.businessDaysBetween",
+      "daycounter.yearFraction",
+      "actualactual.recursions",
+      "schedule.generate",
+      "tickconverter.cursorHits",
+      "tickconverter.cursorMisses",
+      "arena.blocks",
+      "threadpool.tasks",
+      "threadpool.steals"
+    };
+
+    const char* timerNames[timerCount] = {
+      "calendar.adjust",
+      "calendar.advance",
+      "calendar.businessDaysBetween",
+      "daycounter.yearFraction",
+      "actualactual.recursion"
+    };
+
+    const Size otherEntry = Stats::implementationCapacity - 1;
+
+    struct Registry {
+      std::mutex mutex;
+      std::vector<Stats::Block*> live;
+      StatsSnapshot retired;
+    };
+
+    Registry& registry() {
+      static Registry instance;
+      return instance;
+    }
+
+    // e.g. MathFin::ActualActual::ISMA_Impl gives ActualActual::ISMA
+    std::string implementationName(const std::type_info& type) {
+      if (type == typeid(void)) {
+        return "other";
+      }
+      std::string name = type.name();
+#ifdef __GNUG__
+      int status = 0;
+      char* demangled = abi::__cxa_demangle(type.name(), 0, 0, &status);
+      if (status == 0) {
+        name = demangled;
+      }
+      std::free(demangled);
+#endif
+      const std::string prefix = "MathFin::";
+      if (name.compare(0, prefix.size(), prefix) == 0) {
+        name.erase(0, prefix.size());
+      }
+      const std::string suffix = "Impl";
+      if (name.size() > suffix.size()
+          && name.compare(name.size() - suffix.size(), suffix.size(),
+                          suffix) == 0) {
+        name.erase(name.size() - suffix.size());
+        if (name.size() > 2 && name.compare(name.size() - 2, 2, "::") == 0) {
+          name.erase(name.size() - 2);
+        } else if (name[name.size() - 1] == '_') {
+          name.erase(name.size() - 1);
+        }
+      }
+      return name;
+    }
+
+    void zero(std::atomic<BigNatural>* values, Size n) {
+      for (Size i = 0; i < n; ++i) {
+        values[i].store(0, std::memory_order_relaxed);
+      }
+    }
+
+#ifdef MATHFIN_ENABLE_STATS
+
+    Size bucket(BigInteger nanoseconds) {
+      Size i = 0;
+      while (nanoseconds > 1 && i + 1 < Histogram::bucketCount) {
+        nanoseconds >>= 1;
+        ++i;
+      }
+      return i;
+    }
+
+    void increment(std::atomic<BigNatural>& value, BigNatural n) {
+      value.store(value.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+    }
+
+    Stats::Block& localBlock() {
+      static thread_local Stats::Block block;
+      return block;
+    }
+
+    // only the owning thread claims entries
+    Stats::Entry& localEntry(const std::type_info& type) {
+      Stats::Block& block = localBlock();
+      const Size start =
+        Size((reinterpret_cast<std::uintptr_t>(&type) >> 4) % otherEntry);
+      for (Size k = 0; k < otherEntry; ++k) {
+        Stats::Entry& entry = block.entries[(start + k) % otherEntry];
+        const std::type_info* key =
+          entry.implementation.load(std::memory_order_relaxed);
+        if (key == &type) {
+          return entry;
+        }
+        if (key == nullptr) {
+          entry.implementation.store(&type, std::memory_order_release);
+          return entry;
+        }
+      }
+      return block.entries[otherEntry];
+    }
+
+#endif
+
+  }
+
+  const char* name(Counter counter) {
+    return counterNames[as_integer(counter)];
+  }
+
+  const char* name(Timer timer) {
+    return timerNames[as_integer(timer)];
+  }
+
+  // ---------------------------------------------------------------------------
+
+  const Size Histogram::bucketCount;
+  const Size Stats::implementationCapacity;
+
+  Histogram::Histogram() : nanoseconds_(0) {
+    std::fill(buckets_, buckets_ + bucketCount, 0);
+  }
+
+  BigNatural Histogram::count() const {
+    BigNatural n = 0;
+    for (Size i = 0; i < bucketCount; ++i) {
+      n += buckets_[i];
+    }
+    return n;
+  }
+
+  Real Histogram::mean() const {
+    const BigNatural n = count();
+    return n == 0 ? 0.0 : Real(nanoseconds_) / n;
+  }
+
+  BigNatural Histogram::percentile(Real p) const {
+    const BigNatural n = count();
+    if (n == 0) {
+      return 0;
+    }
+    const Real target = p * n;
+    BigNatural cumulated = 0;
+    for (Size i = 0; i < bucketCount; ++i) {
+      cumulated += buckets_[i];
+      if (buckets_[i] != 0 && cumulated >= target) {
+        return (BigNatural(2) << i) - 1;
+      }
+    }
+    return (BigNatural(2) << (bucketCount - 1)) - 1;
+  }
+
+  Histogram& Histogram::operator+=(const Histogram& other) {
+    for (Size i = 0; i < bucketCount; ++i) {
+      buckets_[i] += other.buckets_[i];
+    }
+    nanoseconds_ += other.nanoseconds_;
+    return *this;
+  }
+
+  Histogram Histogram::operator-(const Histogram& earlier) const {
+    Histogram result;
+    for (Size i = 0; i < bucketCount; ++i) {
+      result.buckets_[i] = buckets_[i] - earlier.buckets_[i];
+    }
+    result.nanoseconds_ = nanoseconds_ - earlier.nanoseconds_;
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  StatsSnapshot::Implementation::Implementation() {
+    std::fill(values, values + counterCount, 0);
+  }
+
+  StatsSnapshot::StatsSnapshot() {
+    std::fill(values_, values_ + counterCount, 0);
+  }
+
+  const StatsSnapshot::Implementation* StatsSnapshot::find(
+    const std::string& implementation) const {
+    for (Size i = 0; i < implementations_.size(); ++i) {
+      if (implementations_[i].name == implementation) {
+        return &implementations_[i];
+      }
+    }
+    return nullptr;
+  }
+
+  Histogram StatsSnapshot::operator[](Timer timer) const {
+    Histogram result;
+    for (Size i = 0; i < implementations_.size(); ++i) {
+      result += implementations_[i].histograms[as_integer(timer)];
+    }
+    return result;
+  }
+
+  std::vector<std::string> StatsSnapshot::implementations() const {
+    std::vector<std::string> result;
+    for (Size i = 0; i < implementations_.size(); ++i) {
+      result.push_back(implementations_[i].name);
+    }
+    return result;
+  }
+
+  BigNatural StatsSnapshot::count(Counter counter,
+                                  const std::string& implementation) const {
+    const Implementation* found = find(implementation);
+    return found ? found->values[as_integer(counter)] : 0;
+  }
+
+  Histogram StatsSnapshot::histogram(Timer timer,
+                                     const std::string& implementation) const {
+    const Implementation* found = find(implementation);
+    return found ? found->histograms[as_integer(timer)] : Histogram();
+  }
+
+  Real StatsSnapshot::hitRate(Counter hits, Counter misses) const {
+    const BigNatural lookups = (*this)[hits] + (*this)[misses];
+    return lookups == 0 ? 0.0 : Real((*this)[hits]) / lookups;
+  }
+
+  StatsSnapshot StatsSnapshot::operator-(const StatsSnapshot& earlier) const {
+    StatsSnapshot result;
+    for (Size i = 0; i < counterCount; ++i) {
+      result.values_[i] = values_[i] - earlier.values_[i];
+    }
+    result.implementations_ = implementations_;
+    for (Size k = 0; k < result.implementations_.size(); ++k) {
+      Implementation& current = result.implementations_[k];
+      if (const Implementation* before = earlier.find(current.name)) {
+        for (Size i = 0; i < counterCount; ++i) {
+          current.values[i] -= before->values[i];
+        }
+        for (Size i = 0; i < timerCount; ++i) {
+          current.histograms[i] = current.histograms[i] - before->histograms[i];
+        }
+      }
+    }
+    return result;
+  }
+
+  std::ostream& operator<<(std::ostream& out, const StatsSnapshot& s) {
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    for (Size i = 0; i < counterCount; ++i) {
+      if (s[Counter(i)] != 0) {
+        out << std::left << std::setw(40) << name(Counter(i))
+            << std::right << std::setw(16) << s[Counter(i)] << "\n";
+      }
+    }
+    if (s[Counter::TickCursorHits] + s[Counter::TickCursorMisses] != 0) {
+      out << std::left << std::setw(40) << "tickconverter.cursorHitRate"
+          << std::right << std::setw(16) << std::fixed << std::setprecision(4)
+          << s.hitRate(Counter::TickCursorHits, Counter::TickCursorMisses)
+          << "\n";
+    }
+    const std::vector<std::string> implementations = s.implementations();
+    for (Size k = 0; k < implementations.size(); ++k) {
+      const std::string& implementation = implementations[k];
+      for (Size i = 0; i < counterCount; ++i) {
+        const BigNatural n = s.count(Counter(i), implementation);
+        if (n != 0) {
+          out << std::left << std::setw(40)
+              << std::string(name(Counter(i))) + "[" + implementation + "]"
+              << std::right << std::setw(16) << n << "\n";
+        }
+      }
+      for (Size i = 0; i < timerCount; ++i) {
+        const Histogram h = s.histogram(Timer(i), implementation);
+        if (h.count() != 0) {
+          out << std::left << std::setw(40)
+              << std::string(name(Timer(i))) + "[" + implementation + "]"
+              << std::right << std::fixed << std::setprecision(1)
+              << " mean " << h.mean() << " ns, p50 < "
+              << h.percentile(0.5) + 1 << " ns, p99 < "
+              << h.percentile(0.99) + 1 << " ns\n";
+        }
+      }
+    }
+    out.flags(flags);
+    out.precision(precision);
+    return out;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  Stats::Block::Block() {
+    zero(values, counterCount);
+    for (Size k = 0; k < implementationCapacity; ++k) {
+      entries[k].implementation.store(nullptr, std::memory_order_relaxed);
+    }
+    entries[otherEntry].implementation.store(&typeid(void),
+                                             std::memory_order_relaxed);
+    clear(*this);
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+  }
+
+  Stats::Block::~Block() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    accumulate(r.retired, *this);
+    r.live.erase(std::find(r.live.begin(), r.live.end(), this));
+  }
+
+  void Stats::accumulate(StatsSnapshot& result, const Block& block) {
+    for (Size i = 0; i < counterCount; ++i) {
+      result.values_[i] += block.values[i].load(std::memory_order_relaxed);
+    }
+    std::vector<StatsSnapshot::Implementation>& implementations =
+      result.implementations_;
+    for (Size k = 0; k < implementationCapacity; ++k) {
+      const Entry& entry = block.entries[k];
+      const std::type_info* type =
+        entry.implementation.load(std::memory_order_acquire);
+      if (!type) {
+        continue;
+      }
+      StatsSnapshot::Implementation values;
+      bool recorded = false;
+      for (Size i = 0; i < counterCount; ++i) {
+        values.values[i] = entry.values[i].load(std::memory_order_relaxed);
+        recorded = recorded || values.values[i] != 0;
+      }
+      for (Size i = 0; i < timerCount; ++i) {
+        Histogram& h = values.histograms[i];
+        for (Size j = 0; j < Histogram::bucketCount; ++j) {
+          h.buckets_[j] = entry.buckets[i][j].load(std::memory_order_relaxed);
+          recorded = recorded || h.buckets_[j] != 0;
+        }
+        h.nanoseconds_ = entry.nanoseconds[i].load(std::memory_order_relaxed);
+      }
+      if (!recorded) {
+        continue;
+      }
+
+      values.name = implementationName(*type);
+      std::vector<StatsSnapshot::Implementation>::iterator i =
+        implementations.begin();
+      while (i != implementations.end() && i->name < values.name) {
+        ++i;
+      }
+      if (i == implementations.end() || i->name != values.name) {
+        i = implementations.insert(i, StatsSnapshot::Implementation());
+        i->name = values.name;
+      }
+      for (Size c = 0; c < counterCount; ++c) {
+        i->values[c] += values.values[c];
+      }
+      for (Size t = 0; t < timerCount; ++t) {
+        i->histograms[t] += values.histograms[t];
+      }
+    }
+  }
+
+  void Stats::clear(Block& block) {
+    zero(block.values, counterCount);
+    for (Size k = 0; k < implementationCapacity; ++k) {
+      Entry& entry = block.entries[k];
+      zero(entry.values, counterCount);
+      for (Size i = 0; i < timerCount; ++i) {
+        zero(entry.buckets[i], Histogram::bucketCount);
+      }
+      zero(entry.nanoseconds, timerCount);
+    }
+  }
+
+  bool Stats::enabled() {
+#ifdef MATHFIN_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void Stats::add(Counter counter, BigNatural n) {
+#ifdef MATHFIN_ENABLE_STATS
+    increment(localBlock().values[as_integer(counter)], n);
+#else
+    (void)counter;
+    (void)n;
+#endif
+  }
+
+  void Stats::add(Counter counter, const std::type_info& implementation) {
+#ifdef MATHFIN_ENABLE_STATS
+    increment(localBlock().values[as_integer(counter)], 1);
+    increment(localEntry(implementation).values[as_integer(counter)], 1);
+#else
+    (void)counter;
+    (void)implementation;
+#endif
+  }
+
+  void Stats::record(Timer timer,
+                     const std::type_info& implementation,
+                     BigInteger nanoseconds) {
+#ifdef MATHFIN_ENABLE_STATS
+    Entry& entry = localEntry(implementation);
+    increment(entry.buckets[as_integer(timer)][bucket(nanoseconds)], 1);
+    increment(entry.nanoseconds[as_integer(timer)],
+              BigNatural(std::max<BigInteger>(nanoseconds, 0)));
+#else
+    (void)timer;
+    (void)implementation;
+    (void)nanoseconds;
+#endif
+  }
+
+  StatsSnapshot Stats::snapshot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    StatsSnapshot result = r.retired;
+    for (Size j = 0; j < r.live.size(); ++j) {
+      accumulate(result, *r.live[j]);
+    }
+    return result;
+  }
+
+  void Stats::reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired = StatsSnapshot();
+    for (Size j = 0; j < r.live.size(); ++j) {
+      clear(*r.live[j]);
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  namespace {
+
+    BigInteger now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+  }
+
+  StatsTimer::StatsTimer(Timer timer, const std::type_info& implementation)
+    : timer_(timer), implementation_(implementation), start_(now()) {}
+
+  StatsTimer::~StatsTimer() {
+    Stats::record(timer_, implementation_, now() - start_);
+  }
+
+}
@@ -0,0 +1,352 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file stats.hpp
+ * @brief hot-path counters and timings
+ *
+ * Statistics are only collected when the library is configured with
+ * <tt>--enable-stats</tt>, which defines <tt>MATHFIN_ENABLE_STATS</tt> in
+ * the installed base/config.hpp; otherwise the MF_COUNT and MF_TIME macros
+ * expand to nothing and snapshots are all zeros.  Since the definition
+ * comes from the configured header rather than from the flags of the
+ * includer, inline functions counting events are the same in every
+ * translation unit.
+ *
+ * Events of calendars and day counters are also broken down by
+ * implementation class, which needs no name to be built on the hot path:
+ * the class is identified by its <tt>std::type_info</tt>, and only named
+ * when a snapshot is taken.
+ */
+
+#ifndef MATHFIN_STATS_HPP
+#define MATHFIN_STATS_HPP
+
+#include <base/config.hpp>
+#include <base/conversion.hpp>
+#include <base/types.hpp>
+
+#include <atomic>
+#include <iosfwd>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Counted events.
+   */
+  enum class Counter {
+    CalendarBusinessDayChecks,  //!< Calendar::isBusinessDay calls
+    CalendarAdjustments,        //!< Calendar::adjust calls
+    CalendarAdvances,           //!< Calendar::advance calls
+    CalendarBusinessDaysBetween,//!< Calendar::businessDaysBetween calls
+    DayCounterYearFractions,    //!< DayCounter::yearFraction calls
+    ActualActualRecursions,     //!< ISMA fractions split into sub-periods
+    ScheduleGenerations,        //!< schedules generated
+    TickCursorHits,             //!< ticks converted from the cursor cache
+    TickCursorMisses,           //!< ticks requiring a cursor seek
+    ArenaBlocks,                //!< blocks obtained by arenas
+    ThreadPoolTasks,            //!< chunks run by thread pools
+    ThreadPoolSteals,           //!< chunks stolen from another queue
+    Count                       //!< number of counters
+  };
+
+  /**
+   * Number of counters in Counter.
+   */
+  const Size counterCount = Size(Counter::Count);
+
+  /**
+   * Name of a counter.
+   * @relates Counter
+   */
+  const char* name(Counter counter);
+
+  /**
+   * Timed operations.
+   */
+  enum class Timer {
+    CalendarAdjust,             //!< Calendar::adjust
+    CalendarAdvance,            //!< Calendar::advance
+    CalendarBusinessDaysBetween,//!< Calendar::businessDaysBetween
+    DayCounterYearFraction,     //!< DayCounter::yearFraction
+    ActualActualRecursion,      //!< ISMA fractions split into sub-periods
+    Count                       //!< number of timers
+  };
+
+  /**
+   * Number of timers in Timer.
+   */
+  const Size timerCount = Size(Timer::Count);
+
+  /**
+   * Name of a timer.
+   * @relates Timer
+   */
+  const char* name(Timer timer);
+
+  /**
+   * Distribution of durations on a logarithmic scale: bucket <tt>i</tt>
+   * counts durations of 2<sup>i</sup> to 2<sup>i+1</sup> - 1 nanoseconds,
+   * the last one all longer durations as well.
+   */
+  class Histogram {
+  public:
+    static const Size bucketCount = 24;
+
+    Histogram();
+
+    BigNatural operator[](Size bucket) const { return buckets_[bucket]; }
+
+    /**
+     * Number of recorded durations.
+     */
+    BigNatural count() const;
+
+    BigNatural totalNanoseconds() const { return nanoseconds_; }
+
+    /**
+     * Mean duration in nanoseconds, or 0 if there is none.
+     */
+    Real mean() const;
+
+    /**
+     * Upper bound, in nanoseconds, of the bucket holding the given
+     * fraction of the durations, e.g. 0.99 for the 99th percentile; 0 if
+     * there is no duration.
+     */
+    BigNatural percentile(Real p) const;
+
+    Histogram& operator+=(const Histogram& other);
+    Histogram operator-(const Histogram& earlier) const;
+
+  private:
+    friend class Stats;
+    BigNatural buckets_[bucketCount];
+    BigNatural nanoseconds_;
+  };
+
+  /**
+   * Values of all counters and timers, summed over threads, at a point in
+   * time.
+   */
+  class StatsSnapshot {
+  public:
+    StatsSnapshot();
+
+    BigNatural operator[](Counter counter) const {
+      return values_[as_integer(counter)];
+    }
+
+    /**
+     * Durations of an operation over all implementations.
+     */
+    Histogram operator[](Timer timer) const;
+
+    /**
+     * Names of the calendar and day-counter classes with recorded events,
+     * e.g. <tt>TARGET</tt> or <tt>ActualActual::ISMA</tt>, sorted.
+     */
+    std::vector<std::string> implementations() const;
+
+    /**
+     * Events of the given implementation, as named by implementations();
+     * zero for events not broken down by implementation.
+     */
+    BigNatural count(Counter counter, const std::string& implementation) const;
+
+    /**
+     * Durations of an operation for the given implementation.
+     */
+    Histogram histogram(Timer timer, const std::string& implementation) const;
+
+    /**
+     * Fraction of lookups served by a cache, given the counters of its hits
+     * and misses, e.g. Counter::TickCursorHits and TickCursorMisses; 0 if
+     * there was no lookup.
+     */
+    Real hitRate(Counter hits, Counter misses) const;
+
+    /**
+     * Events between an earlier snapshot and this one.
+     */
+    StatsSnapshot operator-(const StatsSnapshot& earlier) const;
+
+  private:
+    friend class Stats;
+    struct Implementation {
+      Implementation();
+      std::string name;
+      BigNatural values[counterCount];
+      Histogram histograms[timerCount];
+    };
+    const Implementation* find(const std::string& implementation) const;
+    BigNatural values_[counterCount];
+    std::vector<Implementation> implementations_;   // sorted by name
+  };
+
+  /**
+   * Prints the non-zero counters, the hit rate of the tick cursor, the
+   * timers and the breakdown by implementation, one item per line.
+   * @relates StatsSnapshot
+   */
+  std::ostream& operator<<(std::ostream&, const StatsSnapshot&);
+
+  /**
+   * Statistics storage.
+   *
+   * Each thread records into its own block, aligned on a cache line so
+   * that threads never contend; increments are relaxed atomic stores
+   * without lock prefix.  A block holds the counters and a small
+   * open-addressing table of implementation classes, each with its own
+   * counters and histograms; classes beyond its capacity are recorded
+   * under <tt>other</tt>.  Snapshots sum the blocks of running threads and
+   * the totals left by finished ones.
+   */
+  class Stats {
+  public:
+    /**
+     * Whether the library was built with statistics.
+     */
+    static bool enabled();
+
+    static StatsSnapshot snapshot();
+
+    /**
+     * Sets all counters and histograms to zero; events racing with a reset
+     * may survive it.
+     */
+    static void reset();
+
+    /**
+     * Adds n occurrences to a counter of the calling thread.
+     */
+    static void add(Counter counter, BigNatural n);
+
+    /**
+     * Adds an occurrence to a counter of the calling thread, both in total
+     * and for the given implementation class.
+     */
+    static void add(Counter counter, const std::type_info& implementation);
+
+    /**
+     * Records a duration of an operation of the given implementation
+     * class.
+     */
+    static void record(Timer timer,
+                       const std::type_info& implementation,
+                       BigInteger nanoseconds);
+
+    /**
+     * Number of implementation classes a thread records separately.
+     */
+    static const Size implementationCapacity = 32;
+
+    /**
+     * Statistics of one implementation class on one thread.
+     */
+    struct Entry {
+      std::atomic<const std::type_info*> implementation;
+      std::atomic<BigNatural> values[counterCount];
+      std::atomic<BigNatural> buckets[timerCount][Histogram::bucketCount];
+      std::atomic<BigNatural> nanoseconds[timerCount];
+    };
+
+    /**
+     * Statistics of one thread.
+     */
+    struct alignas(64) Block {
+      Block();
+      ~Block();
+      std::atomic<BigNatural> values[counterCount];
+      Entry entries[implementationCapacity];
+    };
+
+  private:
+    static void accumulate(StatsSnapshot& result, const Block& block);
+    static void clear(Block& block);
+  };
+
+  /**
+   * Records the lifetime of the object with Stats::record().
+   */
+  class StatsTimer {
+  public:
+    StatsTimer(Timer timer, const std::type_info& implementation);
+    ~StatsTimer();
+
+  private:
+    StatsTimer(const StatsTimer&);
+    StatsTimer& operator=(const StatsTimer&);
+
+    const Timer timer_;
+    const std::type_info& implementation_;
+    const BigInteger start_;
+  };
+
+}
+
+#define MF_STATS_CONCAT_(a, b) a##b
+#define MF_STATS_CONCAT(a, b) MF_STATS_CONCAT_(a, b)
+
+#ifdef MATHFIN_ENABLE_STATS
+
+#define MF_COUNT_N(counter, n) \
+  MathFin::Stats::add(MathFin::Counter::counter, (n))
+
+#define MF_COUNT_FOR(counter, implementation) \
+  MathFin::Stats::add(MathFin::Counter::counter, (implementation))
+
+#define MF_TIME_FOR(timer, implementation)                         \
+  const MathFin::StatsTimer MF_STATS_CONCAT(mf_stats_timer_, __LINE__)( \
+    MathFin::Timer::timer, (implementation))
+
+#else
+
+#define MF_COUNT_N(counter, n) ((void)0)
+#define MF_COUNT_FOR(counter, implementation) ((void)0)
+#define MF_TIME_FOR(timer, implementation) ((void)0)
+
+#endif
+
+/**
+ * Counts one occurrence of the given Counter.
+ */
+#define MF_COUNT(counter) MF_COUNT_N(counter, 1)
+
+/**
+ * \def MF_COUNT_N(counter, n)
+ * Counts n occurrences of the given Counter.
+ */
+
+/**
+ * \def MF_COUNT_FOR(counter, implementation)
+ * Counts one occurrence of the given Counter for the implementation class
+ * identified by a <tt>std::type_info</tt>, e.g. <tt>typeid(*impl_)</tt>.
+ */
+
+/**
+ * \def MF_TIME_FOR(timer, implementation)
+ * Times the enclosing scope under the given Timer for the implementation
+ * class identified by a <tt>std::type_info</tt>.
+ */
+
+#endif /* MATHFIN_STATS_HPP */
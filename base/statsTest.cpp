@@ -0,0 +1,147 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/stats.hpp>
+
+using namespace MathFin;
+
+// named StatsTest in snapshots
+struct StatsTestImpl {};
+
+namespace {
+  template <int N>
+  struct Tag {
+    static void count() {
+      MF_COUNT_FOR(ArenaBlocks, typeid(Tag<N>));
+      Tag<N - 1>::count();
+    }
+  };
+
+  template <>
+  struct Tag<0> {
+    static void count() {}
+  };
+}
+
+TEST_CASE("Counters are summed over threads", "[stats]") {
+  const StatsSnapshot before = Stats::snapshot();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([]() {
+          for (int i = 0; i < 1000; ++i) {
+            MF_COUNT(TickCursorHits);
+          }
+          MF_COUNT_N(TickCursorMisses, 5);
+        }));
+  }
+  for (Size t = 0; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+  MF_COUNT(TickCursorMisses);
+
+  const StatsSnapshot delta = Stats::snapshot() - before;
+  if (!Stats::enabled()) {
+    REQUIRE(delta[Counter::TickCursorHits] == 0);
+    REQUIRE(delta[Counter::TickCursorMisses] == 0);
+    return;
+  }
+  REQUIRE(delta[Counter::TickCursorHits] == 4000);
+  REQUIRE(delta[Counter::TickCursorMisses] == 21);
+  REQUIRE(delta.hitRate(Counter::TickCursorHits, Counter::TickCursorMisses)
+          == 4000.0 / 4021);
+
+  std::ostringstream out;
+  out << delta;
+  REQUIRE(out.str().find("tickconverter.cursorHits") != std::string::npos);
+}
+
+TEST_CASE("Counters can be reset", "[stats]") {
+  MF_COUNT(ScheduleGenerations);
+  REQUIRE((Stats::snapshot()[Counter::ScheduleGenerations] > 0)
+          == Stats::enabled());
+  Stats::reset();
+  REQUIRE(Stats::snapshot()[Counter::ScheduleGenerations] == 0);
+  REQUIRE(std::string(name(Counter::ThreadPoolSteals)) == "threadpool.steals");
+}
+
+TEST_CASE("Counters and timings are broken down by implementation",
+          "[stats]") {
+  Stats::reset();
+  MF_COUNT_FOR(CalendarAdjustments, typeid(StatsTestImpl));
+  MF_COUNT_FOR(CalendarAdjustments, typeid(StatsTestImpl));
+  MF_COUNT_FOR(CalendarAdjustments, typeid(int));
+  {
+    MF_TIME_FOR(CalendarAdjust, typeid(StatsTestImpl));
+  }
+  // between 512 and 1023 nanoseconds
+  Stats::record(Timer::CalendarAdjust, typeid(StatsTestImpl), 1000);
+
+  const StatsSnapshot snapshot = Stats::snapshot();
+  if (!Stats::enabled()) {
+    REQUIRE(snapshot.implementations().empty());
+    REQUIRE(snapshot[Timer::CalendarAdjust].count() == 0);
+    return;
+  }
+  REQUIRE(snapshot[Counter::CalendarAdjustments] == 3);
+  REQUIRE(snapshot.implementations().size() == 2);
+  REQUIRE(snapshot.count(Counter::CalendarAdjustments, "StatsTest") == 2);
+  REQUIRE(snapshot.count(Counter::CalendarAdjustments, "int") == 1);
+  REQUIRE(snapshot.count(Counter::CalendarAdvances, "StatsTest") == 0);
+
+  const Histogram timings =
+    snapshot.histogram(Timer::CalendarAdjust, "StatsTest");
+  REQUIRE(timings.count() == 2);
+  REQUIRE(timings[9] >= 1);
+  REQUIRE(timings.totalNanoseconds() >= 1000);
+  REQUIRE(timings.percentile(1.0) >= 1023);
+  REQUIRE(snapshot[Timer::CalendarAdjust].count() == 2);
+
+  std::ostringstream out;
+  out << snapshot;
+  REQUIRE(out.str().find("calendar.adjust[StatsTest]") != std::string::npos);
+
+  const StatsSnapshot delta = Stats::snapshot() - snapshot;
+  REQUIRE(delta.count(Counter::CalendarAdjustments, "StatsTest") == 0);
+  REQUIRE(delta.histogram(Timer::CalendarAdjust, "StatsTest").count() == 0);
+}
+
+TEST_CASE("Implementations beyond the capacity are counted as other",
+          "[stats]") {
+  Stats::reset();
+  const int tags = 40;
+  std::thread counting([]() { Tag<tags>::count(); });
+  counting.join();
+
+  const StatsSnapshot snapshot = Stats::snapshot();
+  const Size other = tags - (Stats::implementationCapacity - 1);
+  REQUIRE(snapshot.count(Counter::ArenaBlocks, "other")
+          == (Stats::enabled() ? other : 0));
+  REQUIRE(snapshot[Counter::ArenaBlocks] == (Stats::enabled() ? tags : 0));
+}
+
+TEST_CASE("Per-thread blocks do not share cache lines", "[stats]") {
+  REQUIRE(alignof(Stats::Block) == 64);
+  REQUIRE(sizeof(Stats::Block) % 64 == 0);
+}
@@ -0,0 +1,60 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/status.hpp>
+
+namespace MathFin {
+
+  const char* description(ErrorCode code) {
+    switch (code) {
+    case ErrorCode::None:
+      return "no error";
+    case ErrorCode::NullImplementation:
+      return "no implementation provided";
+    case ErrorCode::NullDate:
+      return "null date";
+    case ErrorCode::YearOutOfRange:
+      return "year out of bound. It must be in [1901,2199]";
+    case ErrorCode::MonthOutOfRange:
+      return "month outside January-December range [1,12]";
+    case ErrorCode::DayOutOfRange:
+      return "day outside month day-range";
+    case ErrorCode::SerialOutOfRange:
+      return "serial number outside allowed range [367, ... ,109574]";
+    case ErrorCode::InvalidRange:
+      return "start of range later than its end";
+    case ErrorCode::InvalidArgument:
+      return "invalid argument";
+    case ErrorCode::ParseError:
+      return "malformed input";
+    default:
+      return "unknown error";
+    }
+  }
+
+  std::string Status::message() const {
+    if (ok()) {
+      return description(code_);
+    }
+    std::ostringstream msg;
+    msg << description(code_) << " (" << value_ << ")";
+    return msg.str();
+  }
+
+}
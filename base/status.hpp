@@ -0,0 +1,158 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file status.hpp
+ * @brief non-throwing error channel
+ */
+
+#ifndef MATHFIN_STATUS_HPP
+#define MATHFIN_STATUS_HPP
+
+#include <base/error.hpp>
+#include <base/types.hpp>
+
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace MathFin {
+
+  /**
+   * Error codes reported through Status.
+   *
+   * Each code has a static description; see description(ErrorCode).
+   */
+  enum class ErrorCode {
+    None = 0,            //!< no error
+    NullImplementation,  //!< no implementation provided
+    NullDate,            //!< null date
+    YearOutOfRange,      //!< year outside [1901, 2199]
+    MonthOutOfRange,     //!< month outside [1, 12]
+    DayOutOfRange,       //!< day outside the month
+    SerialOutOfRange,    //!< serial number outside the allowed range
+    InvalidRange,        //!< start of a range later than its end
+    InvalidArgument,     //!< argument outside its domain
+    ParseError           //!< malformed input
+  };
+
+  /**
+   * Static description of an error code.
+   * @relates Status
+   */
+  const char* description(ErrorCode code);
+
+  /**
+   * Outcome of an operation that reports errors without throwing.
+   *
+   * A Status holds an error code and the offending value, if any.  It
+   * never allocates: the human-readable message is only formatted when
+   * message() is called, so that validating bulk input costs no more
+   * than comparing integers even when most of the input is invalid.
+   */
+  class Status {
+  public:
+    /**
+     * Successful outcome.
+     */
+    Status() : code_(ErrorCode::None), value_(0) {}
+
+    /**
+     * Failed outcome with the given code and offending value.
+     */
+    explicit Status(ErrorCode code, BigInteger value = 0)
+      : code_(code), value_(value) {}
+
+    bool ok() const { return code_ == ErrorCode::None; }
+    ErrorCode code() const { return code_; }
+    BigInteger value() const { return value_; }
+
+    /**
+     * Formats the description of the error and the offending value.
+     */
+    std::string message() const;
+
+  private:
+    ErrorCode code_;
+    BigInteger value_;
+  };
+
+  /**
+   * Either a value or the Status explaining why there is none.
+   *
+   * The value is constructed in place, so that types without an
+   * assignment operator (such as Date) can be returned.
+   */
+  template <class T>
+  class Expected {
+  public:
+    Expected(const T& value) : status_() {
+      new (&storage_) T(value);
+    }
+
+    Expected(const Status& status) : status_(status) {
+      MF_REQUIRE(!status.ok(), "an error status is required");
+    }
+
+    Expected(const Expected& other) : status_(other.status_) {
+      if (status_.ok()) {
+        new (&storage_) T(*other.get());
+      }
+    }
+
+    ~Expected() {
+      if (status_.ok()) {
+        get()->~T();
+      }
+    }
+
+    bool ok() const { return status_.ok(); }
+    const Status& status() const { return status_; }
+
+    /**
+     * The value; throws an Error carrying the status message if there is
+     * none.
+     */
+    const T& value() const {
+      MF_REQUIRE(status_.ok(), status_.message());
+      return *get();
+    }
+
+    /**
+     * The value, or the given default if there is none.
+     */
+    T valueOr(const T& defaultValue) const {
+      return status_.ok() ? *get() : defaultValue;
+    }
+
+  private:
+    Expected& operator=(const Expected&);
+
+    const T* get() const { return reinterpret_cast<const T*>(&storage_); }
+    T* get() { return reinterpret_cast<T*>(&storage_); }
+
+    Status status_;
+    typename std::aligned_storage<sizeof(T),
+                                  std::alignment_of<T>::value>::type storage_;
+  };
+
+}
+
+#endif /* MATHFIN_STATUS_HPP */
@@ -0,0 +1,58 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+
+#include <test/catch.hpp>
+#include <base/error.hpp>
+#include <base/status.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Status codes and messages", "[status]") {
+  Status success;
+  REQUIRE(success.ok());
+  REQUIRE(success.code() == ErrorCode::None);
+  REQUIRE(success.message() == "no error");
+
+  Status failure(ErrorCode::MonthOutOfRange, 13);
+  REQUIRE(!failure.ok());
+  REQUIRE(failure.code() == ErrorCode::MonthOutOfRange);
+  REQUIRE(failure.value() == 13);
+  REQUIRE(failure.message() ==
+          std::string(description(ErrorCode::MonthOutOfRange)) + " (13)");
+}
+
+TEST_CASE("Expected values", "[status]") {
+  Expected<std::string> value(std::string("value"));
+  REQUIRE(value.ok());
+  REQUIRE(value.value() == "value");
+  REQUIRE(value.valueOr("default") == "value");
+
+  Expected<std::string> copy(value);
+  REQUIRE(copy.value() == "value");
+
+  Expected<std::string> error(Status(ErrorCode::ParseError, 3));
+  REQUIRE(!error.ok());
+  REQUIRE(error.status().code() == ErrorCode::ParseError);
+  REQUIRE(error.valueOr("default") == "default");
+  REQUIRE_THROWS_AS(error.value(), Error);
+
+  REQUIRE_THROWS_AS(Expected<std::string>{Status()}, Error);
+}
@@ -0,0 +1,186 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/stats.hpp>
+#include <base/threadpool.hpp>
+#include <base/trace.hpp>
+
+#include <deque>
+#include <exception>
+
+namespace MathFin {
+
+  namespace {
+    // pool and queue owned by the current thread, if it is a worker
+    thread_local const ThreadPool* currentPool = 0;
+    thread_local Size currentQueue = 0;
+  }
+
+  struct ThreadPool::Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  ThreadPool::ThreadPool(Size workers) : queued_(0), stop_(false) {
+    for (Size i = 0; i < workers; ++i) {
+      queues_.push_back(std::unique_ptr<Queue>(new Queue));
+    }
+    for (Size i = 0; i < workers; ++i) {
+      workers_.push_back(std::thread(&ThreadPool::work, this, i));
+    }
+  }
+
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (Size i = 0; i < workers_.size(); ++i) {
+      workers_[i].join();
+    }
+  }
+
+  Size ThreadPool::defaultWorkers() {
+    const Size threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 0;
+  }
+
+  void ThreadPool::push(std::vector<Task>& tasks) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queued_ += tasks.size();
+    }
+    if (currentPool == this) {
+      // nested call: keep the work local, idle workers will steal it
+      Queue& queue = *queues_[currentQueue];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      for (Size i = 0; i < tasks.size(); ++i) {
+        queue.tasks.push_back(std::move(tasks[i]));
+      }
+    } else {
+      // contiguous blocks of chunks per queue
+      const Size n = tasks.size(), q = queues_.size();
+      for (Size k = 0; k < q; ++k) {
+        Queue& queue = *queues_[k];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        for (Size i = k * n / q; i < (k + 1) * n / q; ++i) {
+          queue.tasks.push_back(std::move(tasks[i]));
+        }
+      }
+    }
+    wake_.notify_all();
+  }
+
+  bool ThreadPool::runOne(Size home) {
+    Task task;
+    const Size q = queues_.size();
+    for (Size k = 0; k < q && !task; ++k) {
+      Queue& queue = *queues_[(home + k) % q];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()) {
+        // owners take from the head, thieves from the tail
+        if (k == 0) {
+          task = std::move(queue.tasks.front());
+          queue.tasks.pop_front();
+        } else {
+          task = std::move(queue.tasks.back());
+          queue.tasks.pop_back();
+          MF_COUNT(ThreadPoolSteals);
+        }
+      }
+    }
+    if (!task) {
+      return false;
+    }
+    --queued_;
+    MF_COUNT(ThreadPoolTasks);
+    task();
+    return true;
+  }
+
+  void ThreadPool::work(Size index) {
+    currentPool = this;
+    currentQueue = index;
+    for (;;) {
+      if (runOne(index)) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this]() { return stop_ || queued_ > 0; });
+      if (stop_ && queued_ == 0) {
+        return;
+      }
+    }
+  }
+
+  void ThreadPool::execute(Size chunks,
+                           const std::function<void(Size)>& chunk) {
+    if (workers_.empty() || chunks == 1) {
+      std::exception_ptr error;
+      for (Size i = 0; i < chunks; ++i) {
+        try {
+          chunk(i);
+        } catch (...) {
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      }
+      if (error) {
+        std::rethrow_exception(error);
+      }
+      return;
+    }
+
+    std::atomic<Size> remaining(chunks);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    std::vector<Task> tasks;
+    tasks.reserve(chunks);
+    for (Size i = 0; i < chunks; ++i) {
+      tasks.push_back([&, i]() {
+          try {
+            MF_TRACE_SPAN("ThreadPool::chunk", "threadpool");
+            chunk(i);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+              error = std::current_exception();
+            }
+          }
+          // last access to this frame
+          remaining.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    push(tasks);
+
+    const Size home = currentPool == this ? currentQueue : 0;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+      if (!runOne(home)) {
+        std::this_thread::yield();
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+}
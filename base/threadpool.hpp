@@ -0,0 +1,153 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file threadpool.hpp
+ * @brief work-stealing thread pool for batch operations
+ */
+
+#ifndef MATHFIN_THREADPOOL_HPP
+#define MATHFIN_THREADPOOL_HPP
+
+#include <base/types.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Work-stealing thread pool.
+   *
+   * Ranges are cut into chunks of <tt>grain</tt> consecutive indices; each
+   * worker owns a queue of contiguous chunks, which it runs in order, and
+   * steals from the tail of the other queues when its own is empty.  The
+   * calling thread runs chunks too while it waits, so that nested calls
+   * from within a chunk cannot deadlock.
+   *
+   * Chunk boundaries depend only on the range and the grain, and
+   * parallelReduce() combines the chunk results in chunk order: results
+   * are reproducible whatever the number of threads, including when the
+   * pool has no worker and everything runs on the calling thread.
+   *
+   * If a chunk throws, the remaining chunks still run and the first
+   * exception is rethrown to the caller.
+   */
+  class ThreadPool {
+  public:
+    /**
+     * Pool with the given number of worker threads, in addition to the
+     * calling thread.
+     */
+    explicit ThreadPool(Size workers = defaultWorkers());
+    ~ThreadPool();
+
+    /**
+     * One less than the number of hardware threads.
+     */
+    static Size defaultWorkers();
+
+    Size workers() const { return workers_.size(); }
+
+    /**
+     * Calls <tt>f(lo, hi)</tt> for the chunks <tt>[lo, hi)</tt> covering
+     * <tt>[begin, end)</tt>, in parallel.
+     */
+    template <class F>
+    void parallelFor(Size begin, Size end, Size grain, const F& f) {
+      if (begin >= end) {
+        return;
+      }
+      grain = std::max<Size>(grain, 1);
+      execute((end - begin + grain - 1) / grain, [&](Size chunk) {
+          const Size lo = begin + chunk * grain;
+          f(lo, std::min(end, lo + grain));
+        });
+    }
+
+    /**
+     * Reduces <tt>map(lo, hi)</tt> over the chunks covering
+     * <tt>[begin, end)</tt>: the chunk results are computed in parallel,
+     * then folded with <tt>combine</tt> from left to right starting from
+     * <tt>identity</tt>.
+     */
+    template <class T, class Map, class Combine>
+    T parallelReduce(Size begin, Size end, Size grain, const T& identity,
+                     const Map& map, const Combine& combine) {
+      if (begin >= end) {
+        return identity;
+      }
+      grain = std::max<Size>(grain, 1);
+      const Size chunks = (end - begin + grain - 1) / grain;
+      std::vector<T> partial(chunks, identity);
+      execute(chunks, [&](Size chunk) {
+          const Size lo = begin + chunk * grain;
+          partial[chunk] = map(lo, std::min(end, lo + grain));
+        });
+      T result = identity;
+      for (Size i = 0; i < chunks; ++i) {
+        result = combine(result, partial[i]);
+      }
+      return result;
+    }
+
+  private:
+    typedef std::function<void()> Task;
+    struct Queue;
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    void execute(Size chunks, const std::function<void(Size)>& chunk);
+    void push(std::vector<Task>& tasks);
+    bool runOne(Size home);
+    void work(Size index);
+
+    std::vector<std::unique_ptr<Queue> > queues_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<Size> queued_;
+    bool stop_;
+  };
+
+  /**
+   * Runs <tt>f(lo, hi)</tt> over <tt>[begin, end)</tt> on the given pool,
+   * or sequentially on the calling thread if there is none.
+   * @relates ThreadPool
+   */
+  template <class F>
+  inline void parallelFor(ThreadPool* pool, Size begin, Size end, Size grain,
+                          const F& f) {
+    if (pool) {
+      pool->parallelFor(begin, end, grain, f);
+    } else if (begin < end) {
+      f(begin, end);
+    }
+  }
+
+}
+
+#endif /* MATHFIN_THREADPOOL_HPP */
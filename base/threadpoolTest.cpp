@@ -0,0 +1,116 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/threadpool.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Parallel for covers the range once", "[threadpool]") {
+  ThreadPool pool(3);
+  REQUIRE(pool.workers() == 3);
+
+  std::vector<std::atomic<int> > visits(100003);
+  pool.parallelFor(3, visits.size(), 1000, [&](Size lo, Size hi) {
+      REQUIRE(hi - lo <= 1000);
+      for (Size i = lo; i < hi; ++i) {
+        ++visits[i];
+      }
+    });
+  for (Size i = 0; i < visits.size(); ++i) {
+    REQUIRE(visits[i] == (i < 3 ? 0 : 1));
+  }
+
+  // empty range
+  pool.parallelFor(5, 5, 10, [&](Size, Size) { FAIL("unexpected chunk"); });
+}
+
+TEST_CASE("Parallel reduction is reproducible", "[threadpool]") {
+  // terms of very different magnitudes, so that the result depends on the
+  // order of summation
+  std::vector<double> terms(200000);
+  for (Size i = 0; i < terms.size(); ++i) {
+    terms[i] = std::sin(double(i)) * std::pow(10.0, double(i % 17) - 8.0);
+  }
+  auto sum = [&](ThreadPool& pool) {
+    return pool.parallelReduce(
+      0, terms.size(), 4096, 0.0,
+      [&](Size lo, Size hi) {
+        double s = 0.0;
+        for (Size i = lo; i < hi; ++i) {
+          s += terms[i];
+        }
+        return s;
+      },
+      [](double a, double b) { return a + b; });
+  };
+
+  ThreadPool sequential(0);
+  const double expected = sum(sequential);
+  for (Size workers = 1; workers <= 8; workers *= 2) {
+    ThreadPool pool(workers);
+    for (int trial = 0; trial < 5; ++trial) {
+      REQUIRE(sum(pool) == expected);
+    }
+  }
+}
+
+TEST_CASE("Nested parallel loops", "[threadpool]") {
+  ThreadPool pool(2);
+  std::atomic<Size> total(0);
+  pool.parallelFor(0, 8, 1, [&](Size, Size) {
+      pool.parallelFor(0, 1000, 10, [&](Size lo, Size hi) {
+          total += hi - lo;
+        });
+    });
+  REQUIRE(total == 8000);
+}
+
+TEST_CASE("Exceptions reach the caller", "[threadpool]") {
+  ThreadPool pool(2);
+  std::atomic<Size> done(0);
+  REQUIRE_THROWS_AS(
+    pool.parallelFor(0, 100, 1, [&](Size lo, Size) {
+        if (lo == 42) {
+          throw std::runtime_error("chunk failed");
+        }
+        ++done;
+      }),
+    std::runtime_error);
+  REQUIRE(done == 99);
+}
+
+TEST_CASE("Exceptions reach the caller without workers", "[threadpool]") {
+  ThreadPool pool(0);
+  std::atomic<Size> done(0);
+  REQUIRE_THROWS_WITH(
+    pool.parallelFor(0, 100, 1, [&](Size lo, Size) {
+        if (lo == 42 || lo == 57) {
+          throw std::runtime_error(lo == 42 ? "first" : "second");
+        }
+        ++done;
+      }),
+    "first");
+  REQUIRE(done == 98);
+}
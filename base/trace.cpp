@@ -0,0 +1,259 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace MathFin {
+
+  namespace {
+
+    struct Event {
+      const char* name;
+      const char* category;
+      BigInteger begin, end;
+    };
+
+    // Single-writer ring buffer.  Each slot is a seqlock: its sequence is
+    // odd while the writer fills it and 2 (n + 1) once it holds event n,
+    // so that readers can copy events concurrently and discard those
+    // overwritten meanwhile.  Fields are relaxed atomics, which compile to
+    // plain moves.
+    struct Slot {
+      Slot() : sequence(0), name(nullptr), category(nullptr),
+               begin(0), end(0) {}
+      std::atomic<Size> sequence;
+      std::atomic<const char*> name;
+      std::atomic<const char*> category;
+      std::atomic<BigInteger> begin, end;
+    };
+
+    struct Buffer {
+      explicit Buffer(Size id) : id(id), slots(Trace::bufferCapacity),
+                                 head(0), tail(0), live(true),
+                                 exported(false), released(0) {}
+      Size id;
+      std::vector<Slot> slots;
+      std::atomic<Size> head;   // events ever written
+      std::atomic<Size> tail;   // events before this one were cleared
+      // guarded by the registry mutex
+      bool live;                // a running thread writes into it
+      bool exported;            // written out since its thread finished
+      Size released;            // order in which its thread finished
+    };
+
+    struct Registry {
+      Registry() : lastId(0), releases(0) {}
+      std::mutex mutex;
+      std::vector<std::unique_ptr<Buffer> > buffers;
+      Size lastId;
+      Size releases;
+    };
+
+    Registry& registry() {
+      static Registry instance;
+      return instance;
+    }
+
+    // Buffers outlive their threads so that their events can be exported.
+    // A new thread takes over the buffer of a finished one once its events
+    // were exported or cleared, or else the oldest one when more than
+    // Trace::idleBufferLimit are kept.
+    Buffer& acquireBuffer() {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      Buffer* oldest = nullptr;
+      Size idle = 0;
+      for (Size i = 0; i < r.buffers.size(); ++i) {
+        Buffer* buffer = r.buffers[i].get();
+        if (buffer->live) {
+          continue;
+        }
+        const bool drained = buffer->exported
+          || buffer->tail.load(std::memory_order_relaxed)
+             == buffer->head.load(std::memory_order_relaxed);
+        if (drained) {
+          oldest = buffer;
+          idle = Trace::idleBufferLimit;
+          break;
+        }
+        if (!oldest || buffer->released < oldest->released) {
+          oldest = buffer;
+        }
+        ++idle;
+      }
+      if (oldest && idle >= Trace::idleBufferLimit) {
+        oldest->id = ++r.lastId;
+        oldest->tail.store(oldest->head.load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+        oldest->live = true;
+        oldest->exported = false;
+        return *oldest;
+      }
+      r.buffers.push_back(std::unique_ptr<Buffer>(new Buffer(++r.lastId)));
+      return *r.buffers.back();
+    }
+
+    void releaseBuffer(Buffer& buffer) {
+      Registry& r = registry();
+      std::lock_guard<std::mutex> lock(r.mutex);
+      buffer.live = false;
+      buffer.released = ++r.releases;
+    }
+
+    struct LocalBuffer {
+      LocalBuffer() : buffer(nullptr) {}
+      ~LocalBuffer() {
+        if (buffer) {
+          releaseBuffer(*buffer);
+        }
+      }
+      Buffer* buffer;
+    };
+
+    Buffer& localBuffer() {
+      static thread_local LocalBuffer local;
+      if (!local.buffer) {
+        local.buffer = &acquireBuffer();
+      }
+      return *local.buffer;
+    }
+
+    void collect(const Buffer& buffer, std::vector<Event>& result) {
+      const Size capacity = Trace::bufferCapacity;
+      const Size head = buffer.head.load(std::memory_order_acquire);
+      Size first = buffer.tail.load(std::memory_order_relaxed);
+      if (head > capacity && head - capacity > first) {
+        first = head - capacity;
+      }
+      for (Size i = first; i < head; ++i) {
+        const Slot& slot = buffer.slots[i % capacity];
+        const Size sequence = 2 * (i + 1);
+        if (slot.sequence.load(std::memory_order_acquire) != sequence) {
+          continue;     // overwritten by a later event
+        }
+        Event event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.category = slot.category.load(std::memory_order_relaxed);
+        event.begin = slot.begin.load(std::memory_order_relaxed);
+        event.end = slot.end.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+          result.push_back(event);
+        }
+      }
+    }
+
+    const BigInteger origin = Trace::now();
+
+  }
+
+  std::atomic<bool> Trace::enabled_(false);
+
+  const Size Trace::bufferCapacity;
+  const Size Trace::idleBufferLimit;
+
+  BigInteger Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  void Trace::record(const char* name, const char* category,
+                     BigInteger begin, BigInteger end) {
+    Buffer& buffer = localBuffer();
+    const Size head = buffer.head.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[head % bufferCapacity];
+    slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.sequence.store(2 * (head + 1), std::memory_order_release);
+    buffer.head.store(head + 1, std::memory_order_release);
+  }
+
+  Size Trace::size() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Size total = 0;
+    for (Size i = 0; i < r.buffers.size(); ++i) {
+      const Buffer& buffer = *r.buffers[i];
+      const Size head = buffer.head.load(std::memory_order_acquire);
+      const Size tail = buffer.tail.load(std::memory_order_relaxed);
+      total += std::min(head - tail, bufferCapacity);
+    }
+    return total;
+  }
+
+  Size Trace::bufferCount() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.buffers.size();
+  }
+
+  void Trace::writeJson(std::ostream& out) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << "{\"traceEvents\":[";
+    const char* separator = "\n";
+    std::vector<Event> events;
+    for (Size i = 0; i < r.buffers.size(); ++i) {
+      events.clear();
+      collect(*r.buffers[i], events);
+      if (!r.buffers[i]->live) {
+        r.buffers[i]->exported = true;
+      }
+      for (Size j = 0; j < events.size(); ++j) {
+        const Event& e = events[j];
+        out << separator
+            << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << r.buffers[i]->id
+            << std::fixed << std::setprecision(3)
+            << ",\"ts\":" << (e.begin - origin) / 1000.0
+            << ",\"dur\":" << (e.end - e.begin) / 1000.0 << "}";
+        separator = ",\n";
+      }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  void Trace::clear() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (Size i = 0; i < r.buffers.size(); ++i) {
+      Buffer& buffer = *r.buffers[i];
+      buffer.tail.store(buffer.head.load(std::memory_order_acquire),
+                        std::memory_order_relaxed);
+    }
+  }
+
+}
@@ -0,0 +1,138 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file trace.hpp
+ * @brief tracing spans exportable as Chrome trace events
+ */
+
+#ifndef MATHFIN_TRACE_HPP
+#define MATHFIN_TRACE_HPP
+
+#include <base/types.hpp>
+
+#include <atomic>
+#include <iosfwd>
+
+namespace MathFin {
+
+  /**
+   * Process-wide tracing switch and export.
+   *
+   * Spans are recorded into per-thread ring buffers holding the most
+   * recent events; writing a span involves no lock and no allocation once
+   * the buffer of the thread exists.  When a thread finishes, its buffer
+   * is kept for export and then handed to a later thread, so that
+   * short-lived threads do not grow the trace.  writeJson() produces the
+   * Chrome trace-event format read by chrome://tracing and Perfetto.
+   *
+   * Tracing is disabled by default; a disabled span costs one relaxed
+   * atomic load.
+   */
+  class Trace {
+  public:
+    static void enable() { enabled_.store(true, std::memory_order_relaxed); }
+    static void disable() { enabled_.store(false, std::memory_order_relaxed); }
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    /**
+     * Events kept per thread; older ones are overwritten.
+     */
+    static const Size bufferCapacity = 16384;
+
+    /**
+     * Buffers of finished threads kept until their events are exported or
+     * cleared; beyond it, new threads take over the oldest ones.
+     */
+    static const Size idleBufferLimit = 16;
+
+    /**
+     * Nanoseconds on the monotonic clock used for timestamps.
+     */
+    static BigInteger now();
+
+    /**
+     * Records a complete event.  The name and category must be string
+     * literals or otherwise outlive the trace.
+     */
+    static void record(const char* name, const char* category,
+                       BigInteger begin, BigInteger end);
+
+    /**
+     * Number of events currently held in all buffers.
+     */
+    static Size size();
+
+    /**
+     * Number of buffers allocated, for running threads and for finished
+     * ones whose buffer was not taken over yet.
+     */
+    static Size bufferCount();
+
+    /**
+     * Writes the recorded events as a Chrome trace-event JSON document.
+     */
+    static void writeJson(std::ostream& out);
+
+    /**
+     * Discards the recorded events.
+     */
+    static void clear();
+
+  private:
+    static std::atomic<bool> enabled_;
+  };
+
+  /**
+   * Records the lifetime of the object as a trace event, if tracing is
+   * enabled when it is created.
+   */
+  class TraceSpan {
+  public:
+    explicit TraceSpan(const char* name, const char* category = "mathfin")
+      : name_(name), category_(category),
+        begin_(Trace::enabled() ? Trace::now() : -1) {}
+
+    ~TraceSpan() {
+      if (begin_ >= 0) {
+        Trace::record(name_, category_, begin_, Trace::now());
+      }
+    }
+
+  private:
+    TraceSpan(const TraceSpan&);
+    TraceSpan& operator=(const TraceSpan&);
+
+    const char* name_;
+    const char* category_;
+    const BigInteger begin_;
+  };
+
+}
+
+#define MF_TRACE_CONCAT_(a, b) a##b
+#define MF_TRACE_CONCAT(a, b) MF_TRACE_CONCAT_(a, b)
+
+/**
+ * Traces the enclosing scope under the given name and category.
+ */
+#define MF_TRACE_SPAN(name, category) \
+  MathFin::TraceSpan MF_TRACE_CONCAT(mf_trace_span_, __LINE__)(name, category)
+
+#endif /* MATHFIN_TRACE_HPP */
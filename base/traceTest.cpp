@@ -0,0 +1,154 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/trace.hpp>
+
+using namespace MathFin;
+
+namespace {
+  Size occurrences(const std::string& text, const std::string& pattern) {
+    Size n = 0;
+    for (std::string::size_type i = text.find(pattern);
+         i != std::string::npos; i = text.find(pattern, i + 1)) {
+      ++n;
+    }
+    return n;
+  }
+}
+
+TEST_CASE("Disabled spans record nothing", "[trace]") {
+  Trace::disable();
+  Trace::clear();
+  {
+    MF_TRACE_SPAN("disabled", "test");
+  }
+  REQUIRE(Trace::size() == 0);
+
+  // a span started while disabled is not recorded even if tracing is
+  // enabled before it ends
+  {
+    MF_TRACE_SPAN("disabled", "test");
+    Trace::enable();
+  }
+  REQUIRE(Trace::size() == 0);
+  Trace::disable();
+}
+
+TEST_CASE("Spans from several threads are exported", "[trace]") {
+  Trace::clear();
+  Trace::enable();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.push_back(std::thread([]() {
+          for (int i = 0; i < 10; ++i) {
+            MF_TRACE_SPAN("worker", "test");
+          }
+        }));
+  }
+  for (Size t = 0; t < threads.size(); ++t) {
+    threads[t].join();
+  }
+  {
+    MF_TRACE_SPAN("main", "test");
+  }
+  Trace::disable();
+  REQUIRE(Trace::size() == 41);
+
+  std::ostringstream out;
+  Trace::writeJson(out);
+  const std::string json = out.str();
+  REQUIRE(json.find("{\"traceEvents\":[") == 0);
+  REQUIRE(occurrences(json, "\"ph\":\"X\"") == 41);
+  REQUIRE(occurrences(json, "\"name\":\"worker\"") == 40);
+  REQUIRE(occurrences(json, "\"name\":\"main\",\"cat\":\"test\"") == 1);
+
+  Trace::clear();
+  REQUIRE(Trace::size() == 0);
+  std::ostringstream empty;
+  Trace::writeJson(empty);
+  REQUIRE(occurrences(empty.str(), "\"ph\"") == 0);
+}
+
+TEST_CASE("Trace buffers keep the most recent events", "[trace]") {
+  Trace::clear();
+  for (Size i = 0; i < Trace::bufferCapacity + 100; ++i) {
+    Trace::record("event", "test", BigInteger(i), BigInteger(i + 1));
+  }
+  REQUIRE(Trace::size() == Trace::bufferCapacity);
+
+  std::ostringstream out;
+  Trace::writeJson(out);
+  REQUIRE(occurrences(out.str(), "\"ph\":\"X\"") == Trace::bufferCapacity);
+  Trace::clear();
+}
+
+TEST_CASE("Events are exported consistently while being written",
+          "[trace]") {
+  Trace::clear();
+  std::atomic<bool> done(false);
+  std::thread writer([&done]() {
+      for (BigInteger i = 0; !done.load(std::memory_order_relaxed); ++i) {
+        Trace::record("event", "test", 1000 * i, 1000 * (i + 1));
+      }
+    });
+  for (int k = 0; k < 20; ++k) {
+    std::ostringstream out;
+    Trace::writeJson(out);
+    // a torn copy would mix the times of two events
+    const std::string json = out.str();
+    REQUIRE(occurrences(json, "\"dur\":1.000}")
+            == occurrences(json, "\"ph\":\"X\""));
+    REQUIRE(occurrences(json, "\"ph\":\"X\"") <= Trace::bufferCapacity);
+  }
+  done.store(true, std::memory_order_relaxed);
+  writer.join();
+  Trace::clear();
+}
+
+TEST_CASE("Buffers of finished threads are reused", "[trace]") {
+  Trace::clear();
+  Trace::enable();
+  const Size initial = Trace::bufferCount();
+  for (int t = 0; t < 200; ++t) {
+    std::thread([]() { MF_TRACE_SPAN("job", "test"); }).join();
+    if (t % 50 == 49) {
+      std::ostringstream out;
+      Trace::writeJson(out);
+    }
+  }
+  // unexported buffers are taken over beyond the limit
+  for (int t = 0; t < 200; ++t) {
+    std::thread([]() { MF_TRACE_SPAN("job", "test"); }).join();
+  }
+  Trace::disable();
+  REQUIRE(Trace::bufferCount() <= initial + Trace::idleBufferLimit + 1);
+  REQUIRE(Trace::size() <= Trace::idleBufferLimit + 1);
+
+  std::ostringstream out;
+  Trace::writeJson(out);
+  REQUIRE(occurrences(out.str(), "\"name\":\"job\"") == Trace::size());
+  Trace::clear();
+}
@@ -0,0 +1,172 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file perfcheck.cpp
+ * @brief performance regression check of the hot operations
+ *
+ * Run by <tt>make check-perf</tt>, it fails if a benchmark is slower than
+ * its baseline in baselines.json by more than MATHFIN_PERF_TOLERANCE
+ * percent (25 by default), e.g.
+ *
+ *   make check-perf MATHFIN_PERF_TOLERANCE=10
+ *
+ * It is kept out of <tt>make check</tt>: timings taken alongside parallel
+ * test jobs, or on a machine other than the one that recorded the
+ * baselines, say nothing about regressions.
+ *
+ * <tt>perfcheck --update</tt> rewrites the baselines from the current
+ * timings.
+ */
+
+#include "runner.hpp"
+
+#include <time/calendars/target.hpp>
+#include <time/datekernels.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actual365fixed.hpp>
+#include <time/daycounters/actualactual.hpp>
+#include <time/daycounters/business252.hpp>
+#include <time/daycounters/one.hpp>
+#include <time/daycounters/simpledaycounter.hpp>
+#include <time/daycounters/thirty360.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace MathFin;
+
+namespace {
+
+  const Size batchSize = 4096;
+
+  // pseudo-random dates in 2000-2030, with d1 <= d2
+  struct Dates {
+    Dates() : d1(batchSize), d2(batchSize), result(batchSize) {
+      const Date::serial_type first = Date(1, Month::January, 2000).serialNumber();
+      boost::uint32_t x = 12345;
+      for (Size i = 0; i < batchSize; ++i) {
+        x = x * 1664525u + 1013904223u;
+        d1[i] = first + Date::serial_type(x % 7300);
+        x = x * 1664525u + 1013904223u;
+        d2[i] = d1[i] + Date::serial_type(x % 3650);
+      }
+    }
+    std::vector<Date::serial_type> d1, d2;
+    std::vector<Time> result;
+  };
+
+  void addDayCounter(BenchmarkRunner& runner, const DayCounter& dayCounter,
+                     Dates& dates, Size n = batchSize) {
+    runner.add("yearFractions " + dayCounter.name(), [dayCounter, &dates, n]() {
+        dayCounter.yearFractions(&dates.d1[0], &dates.d2[0], n,
+                                 &dates.result[0]);
+        return dates.result[n - 1];
+      });
+  }
+
+  Real tolerance() {
+    const char* value = std::getenv("MATHFIN_PERF_TOLERANCE");
+    return value && *value ? std::atof(value) : 25.0;
+  }
+
+  std::string baselinesPath() {
+    const char* value = std::getenv("MATHFIN_PERF_BASELINES");
+    return value && *value ? value : "baselines.json";
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+  const bool update = argc > 1 && std::strcmp(argv[1], "--update") == 0;
+
+  BenchmarkRunner runner;
+  Dates dates;
+
+  const Calendar target = TARGET();
+  const Date from(1, Month::January, 2010), to(1, Month::January, 2020);
+  runner.add("businessDaysBetween 10y", [target, from, to]() {
+      return Real(target.businessDaysBetween(from, to));
+    });
+
+  std::vector<Year> years(batchSize);
+  std::vector<Integer> months(batchSize);
+  std::vector<Day> days(batchSize);
+  runner.add("decompose Date", [&]() {
+      for (Size i = 0; i < batchSize; ++i) {
+        const Date d = Date::unchecked(dates.d1[i]);
+        years[i] = d.year();
+        months[i] = Integer(d.month());
+        days[i] = d.dayOfMonth();
+      }
+      return Real(years[batchSize - 1] + months[0] + days[1]);
+    });
+  runner.add("decompose batch", [&]() {
+      kernels::decompose(&dates.d1[0], batchSize,
+                         &years[0], &months[0], &days[0]);
+      return Real(years[batchSize - 1] + months[0] + days[1]);
+    });
+
+  addDayCounter(runner, Actual360(), dates);
+  addDayCounter(runner, Actual365Fixed(), dates);
+  addDayCounter(runner, ActualActual(ActualActual::Convention::ISDA), dates);
+  addDayCounter(runner, ActualActual(ActualActual::Convention::ISMA), dates);
+  addDayCounter(runner, ActualActual(ActualActual::Convention::AFB), dates);
+  // business days are counted one by one: a smaller batch will do
+  addDayCounter(runner, Business252(target), dates, 64);
+  addDayCounter(runner, OneDayCounter(), dates);
+  addDayCounter(runner, SimpleDayCounter(), dates);
+  addDayCounter(runner, Thirty360(Thirty360::Convention::USA), dates);
+  addDayCounter(runner, Thirty360(Thirty360::Convention::European), dates);
+  addDayCounter(runner, Thirty360(Thirty360::Convention::Italian), dates);
+
+  try {
+    const std::string path = baselinesPath();
+
+    if (update) {
+      std::ofstream out(path.c_str());
+      writeBaselines(out, runner.run());
+      std::cout << "baselines written to " << path << std::endl;
+      return out ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    Baselines baselines;
+    std::ifstream in(path.c_str());
+    if (in) {
+      baselines = readBaselines(in);
+    } else {
+      std::cout << "no baselines in " << path << std::endl;
+    }
+    // a regression must show in a second run too, as a busy machine can
+    // slow down one of them
+    for (int run = 0; run < 2; ++run) {
+      if (compareBaselines(std::cout, runner.run(), baselines, tolerance())) {
+        return EXIT_SUCCESS;
+      }
+      std::cout << std::endl;
+    }
+    return EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,273 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "runner.hpp"
+
+#include <base/error.hpp>
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <istream>
+#include <ostream>
+
+namespace MathFin {
+
+  namespace {
+
+    volatile Real sink = 0.0;
+
+    Real scale(boost::uint64_t x) {
+      return Real(x & 0xffff) * 0.5;
+    }
+
+    Real (*volatile scaleFunction)(boost::uint64_t) = scale;
+
+    // integer arithmetic, indirect calls and array traffic, in proportions
+    // resembling those of the library, whose speed tracks that of the
+    // machine rather than that of the library
+    Real calibration() {
+      static volatile boost::uint64_t seed = 88172645463325252ULL;
+      static std::vector<Real> values(4096);
+      Real (*f)(boost::uint64_t) = scaleFunction;
+      boost::uint64_t x = seed;
+      for (Size i = 0; i < values.size(); ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        values[i] = f(x);
+      }
+      return values[values.size() - 1];
+    }
+
+    Real seconds(Size iterations, const BenchmarkRunner::Operation& f) {
+      typedef std::chrono::steady_clock clock;
+      const clock::time_point start = clock::now();
+      Real total = 0.0;
+      for (Size i = 0; i < iterations; ++i) {
+        total += f();
+      }
+      const clock::time_point end = clock::now();
+      sink = sink + total;
+      return std::chrono::duration<Real>(end - start).count();
+    }
+
+    Real median(std::vector<Real> values) {
+      const Size n = values.size();
+      std::nth_element(values.begin(), values.begin() + n / 2, values.end());
+      const Real upper = values[n / 2];
+      if (n % 2 == 1) {
+        return upper;
+      }
+      return (upper + *std::max_element(values.begin(),
+                                        values.begin() + n / 2)) / 2.0;
+    }
+
+    void skipSpace(std::istream& in) {
+      in >> std::ws;
+    }
+
+    void expect(std::istream& in, char c) {
+      skipSpace(in);
+      MF_REQUIRE(in.get() == c, "malformed baselines: '" << c << "' expected");
+    }
+
+    std::string readString(std::istream& in) {
+      expect(in, '"');
+      std::string result;
+      for (int c = in.get(); c != '"'; c = in.get()) {
+        MF_REQUIRE(c != std::char_traits<char>::eof(),
+                   "malformed baselines: unterminated string");
+        if (c == '\\') {
+          c = in.get();
+        }
+        result += char(c);
+      }
+      return result;
+    }
+
+    void writeString(std::ostream& out, const std::string& s) {
+      out << '"';
+      for (Size i = 0; i < s.size(); ++i) {
+        if (s[i] == '"' || s[i] == '\\') {
+          out << '\\';
+        }
+        out << s[i];
+      }
+      out << '"';
+    }
+
+  }
+
+  BenchmarkRunner::BenchmarkRunner(Size trials, Real trialSeconds)
+    : trials_(trials), trialSeconds_(trialSeconds) {
+    MF_REQUIRE(trials > 0, "at least one trial required");
+  }
+
+  void BenchmarkRunner::add(const std::string& name,
+                            const Operation& operation) {
+    benchmarks_.push_back(std::make_pair(name, operation));
+  }
+
+  Size BenchmarkRunner::iterations(const Operation& operation) const {
+    // these untimed runs also warm up caches and branch predictors
+    Size n = 1;
+    while (seconds(n, operation) < trialSeconds_ && n < (Size(1) << 30)) {
+      n *= 2;
+    }
+    return n;
+  }
+
+  BenchmarkResult BenchmarkRunner::measure(const std::string& name,
+                                           const Operation& operation) const {
+    const Size n = iterations(operation);
+    const Size calibrationIterations = iterations(calibration);
+
+    // each trial is paired with a run of the calibration loop, so that
+    // the machine slowing down for a while affects both alike
+    std::vector<Real> times(trials_), ratios(trials_);
+    for (Size i = 0; i < trials_; ++i) {
+      const Real unit = seconds(calibrationIterations, calibration)
+        / calibrationIterations;
+      times[i] = seconds(n, operation) / n;
+      ratios[i] = times[i] / unit;
+    }
+
+    const Real m = median(ratios);
+    std::vector<Real> deviations(trials_);
+    for (Size i = 0; i < trials_; ++i) {
+      deviations[i] = std::fabs(ratios[i] - m);
+    }
+    const Real limit = 3.0 * median(deviations);
+    std::vector<Real> keptTimes, keptRatios;
+    for (Size i = 0; i < trials_; ++i) {
+      if (deviations[i] <= limit) {
+        keptTimes.push_back(times[i]);
+        keptRatios.push_back(ratios[i]);
+      }
+    }
+
+    BenchmarkResult result;
+    result.name = name;
+    result.iterations = n;
+    result.trials = keptRatios.size();
+    result.nanoseconds = median(keptTimes) * 1.0e9;
+    result.normalized = median(keptRatios);
+    return result;
+  }
+
+  std::vector<BenchmarkResult> BenchmarkRunner::run() const {
+    std::vector<BenchmarkResult> results;
+    for (Size i = 0; i < benchmarks_.size(); ++i) {
+      results.push_back(measure(benchmarks_[i].first, benchmarks_[i].second));
+    }
+    return results;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  Baselines readBaselines(std::istream& in) {
+    Baselines result;
+    expect(in, '{');
+    skipSpace(in);
+    if (in.peek() == '}') {
+      in.get();
+      return result;
+    }
+    for (;;) {
+      const std::string name = readString(in);
+      expect(in, ':');
+      Real value;
+      in >> value;
+      MF_REQUIRE(in, "malformed baselines: number expected for " << name);
+      result[name] = value;
+      skipSpace(in);
+      const int c = in.get();
+      if (c == '}') {
+        return result;
+      }
+      MF_REQUIRE(c == ',', "malformed baselines: ',' or '}' expected");
+    }
+  }
+
+  void writeBaselines(std::ostream& out,
+                      const std::vector<BenchmarkResult>& results) {
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << "{";
+    for (Size i = 0; i < results.size(); ++i) {
+      out << (i == 0 ? "\n  " : ",\n  ");
+      writeString(out, results[i].name);
+      out << ": " << std::setprecision(6) << results[i].normalized;
+    }
+    out << "\n}\n";
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  bool compareBaselines(std::ostream& out,
+                        const std::vector<BenchmarkResult>& results,
+                        const Baselines& baselines,
+                        Real tolerance) {
+    Size width = 9;
+    for (Size i = 0; i < results.size(); ++i) {
+      width = std::max(width, results[i].name.size());
+    }
+
+    const std::ios_base::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << std::left << std::setw(int(width)) << "benchmark" << std::right
+        << std::setw(12) << "ns/iter"
+        << std::setw(12) << "baseline"
+        << std::setw(12) << "current"
+        << std::setw(10) << "change"
+        << "  status\n"
+        << std::string(width + 54, '-') << "\n"
+        << std::fixed;
+
+    bool passed = true;
+    for (Size i = 0; i < results.size(); ++i) {
+      const BenchmarkResult& r = results[i];
+      out << std::left << std::setw(int(width)) << r.name << std::right
+          << std::setprecision(1) << std::setw(12) << r.nanoseconds;
+      Baselines::const_iterator b = baselines.find(r.name);
+      if (b == baselines.end()) {
+        out << std::setw(12) << "-"
+            << std::setprecision(3) << std::setw(12) << r.normalized
+            << std::setw(10) << "-" << "  new\n";
+        continue;
+      }
+      const Real change = (r.normalized / b->second - 1.0) * 100.0;
+      const bool slower = change > tolerance;
+      passed = passed && !slower;
+      out << std::setprecision(3) << std::setw(12) << b->second
+          << std::setw(12) << r.normalized
+          << std::setprecision(1) << std::setw(9) << std::showpos << change
+          << std::noshowpos << "%"
+          << (slower ? "  SLOWER" : "  ok") << "\n";
+    }
+    out << "\ntolerance: " << std::setprecision(1) << tolerance << "%\n";
+    out.flags(flags);
+    out.precision(precision);
+    return passed;
+  }
+
+}
@@ -0,0 +1,115 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file runner.hpp
+ * @brief benchmark runner comparing timings against stored baselines
+ *
+ * Each benchmark is timed over repeated trials, each paired with a run of
+ * a fixed calibration loop.  Timings are divided by that of the loop, so
+ * that baselines recorded on one machine remain meaningful on another;
+ * trials further than three median absolute deviations from the median
+ * are discarded as outliers and the median of the remaining ones is kept.
+ */
+
+#ifndef MATHFIN_BENCHMARK_RUNNER_HPP
+#define MATHFIN_BENCHMARK_RUNNER_HPP
+
+#include <base/types.hpp>
+
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Outcome of a benchmark.
+   */
+  struct BenchmarkResult {
+    std::string name;
+    Size iterations;      //!< iterations per trial
+    Size trials;          //!< trials kept after outlier rejection
+    Real nanoseconds;     //!< median time per iteration
+    Real normalized;      //!< median ratio to the calibration loop
+  };
+
+  /**
+   * Normalized timings by benchmark name.
+   */
+  typedef std::map<std::string, Real> Baselines;
+
+  class BenchmarkRunner {
+  public:
+    /**
+     * An operation returns a value depending on its work, so that the
+     * compiler cannot discard it.
+     */
+    typedef std::function<Real()> Operation;
+
+    /**
+     * @param trials number of timed trials per benchmark
+     * @param trialSeconds minimum duration of a trial; the number of
+     *        iterations is doubled until it is reached
+     */
+    explicit BenchmarkRunner(Size trials = 15, Real trialSeconds = 0.005);
+
+    void add(const std::string& name, const Operation& operation);
+
+    /**
+     * Times every benchmark in the order in which they were added.
+     */
+    std::vector<BenchmarkResult> run() const;
+
+  private:
+    Size iterations(const Operation& operation) const;
+    BenchmarkResult measure(const std::string& name,
+                            const Operation& operation) const;
+
+    Size trials_;
+    Real trialSeconds_;
+    std::vector<std::pair<std::string, Operation> > benchmarks_;
+  };
+
+  /**
+   * Reads baselines from a flat JSON object of numbers.
+   */
+  Baselines readBaselines(std::istream& in);
+
+  /**
+   * Writes the normalized timings as a flat JSON object.
+   */
+  void writeBaselines(std::ostream& out,
+                      const std::vector<BenchmarkResult>& results);
+
+  /**
+   * Prints a table of the results against the baselines and returns
+   * whether none is slower than its baseline by more than the given
+   * tolerance, in percent.  Benchmarks without a baseline never fail.
+   */
+  bool compareBaselines(std::ostream& out,
+                        const std::vector<BenchmarkResult>& results,
+                        const Baselines& baselines,
+                        Real tolerance);
+
+}
+
+#endif /* MATHFIN_BENCHMARK_RUNNER_HPP */
@@ -0,0 +1,173 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Exercises the C interface from C.
+ */
+
+#include <capi/mathfin.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                \
+  do {                                                                  \
+    if (!(condition)) {                                                 \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,  \
+              #condition);                                              \
+      ++failures;                                                       \
+    }                                                                   \
+  } while (0)
+
+/* serial numbers of a few dates */
+enum {
+  FRI_2016_12_23 = 42727,
+  SUN_2016_12_25 = 42729,
+  MON_2016_12_26 = 42730,
+  TUE_2016_12_27 = 42731,
+  FRI_2016_12_30 = 42734,
+  MON_2017_01_02 = 42737,
+  TUE_2017_01_03 = 42738,
+  FRI_2017_03_31 = 42825,
+  FRI_2017_06_30 = 42916
+};
+
+static void testHandles(void) {
+  mf_calendar* calendar = 0;
+  mf_daycounter* dayCounter = 0;
+
+  CHECK(mf_abi_version() == MF_ABI_VERSION);
+
+  CHECK(mf_calendar_create("Atlantis", &calendar) == MF_ERROR_UNKNOWN_NAME);
+  CHECK(calendar == 0);
+  CHECK(strstr(mf_last_error(), "Atlantis") != 0);
+  CHECK(mf_calendar_create(0, &calendar) == MF_ERROR_NULL_ARGUMENT);
+  CHECK(mf_daycounter_create("Actual/999", &dayCounter)
+        == MF_ERROR_UNKNOWN_NAME);
+
+  CHECK(mf_calendar_create("UK settlement", &calendar) == MF_OK);
+  CHECK(mf_daycounter_create_business252(calendar, &dayCounter) == MF_OK);
+  mf_daycounter_destroy(dayCounter);
+  mf_calendar_destroy(calendar);
+
+  /* destroying null handles is harmless */
+  mf_calendar_destroy(0);
+  mf_daycounter_destroy(0);
+  CHECK(strcmp(mf_status_string(MF_OK), "no error") == 0);
+}
+
+static void testCalendar(void) {
+  mf_calendar* target = 0;
+  int32_t dates[] = { FRI_2016_12_23, SUN_2016_12_25, MON_2016_12_26,
+                      TUE_2016_12_27, FRI_2016_12_30, MON_2017_01_02 };
+  const size_t n = sizeof(dates) / sizeof(dates[0]);
+  uint8_t business[6];
+  int32_t adjusted[6], advanced[6], counts[6];
+  int32_t to[6];
+  size_t i;
+
+  CHECK(mf_calendar_create("TARGET", &target) == MF_OK);
+
+  CHECK(mf_is_business_day(target, dates, n, business) == MF_OK);
+  CHECK(business[0] == 1 && business[1] == 0 && business[2] == 0
+        && business[3] == 1 && business[4] == 1 && business[5] == 1);
+
+  CHECK(mf_adjust(target, dates, n, MF_FOLLOWING, adjusted) == MF_OK);
+  CHECK(adjusted[1] == TUE_2016_12_27 && adjusted[2] == TUE_2016_12_27);
+  CHECK(mf_adjust(target, dates, n, MF_PRECEDING, adjusted) == MF_OK);
+  CHECK(adjusted[1] == FRI_2016_12_23);
+
+  /* 2 business days after Friday 23rd: Tuesday 27th, Wednesday 28th */
+  CHECK(mf_advance(target, dates, 1, 2, MF_DAYS, MF_FOLLOWING, 0, advanced)
+        == MF_OK);
+  CHECK(advanced[0] == TUE_2016_12_27 + 1);
+  /* end of month is kept */
+  dates[0] = FRI_2017_03_31;
+  CHECK(mf_advance(target, dates, 1, 3, MF_MONTHS, MF_MODIFIED_FOLLOWING, 1,
+                   advanced) == MF_OK);
+  CHECK(advanced[0] == FRI_2017_06_30);
+  dates[0] = FRI_2016_12_23;
+
+  for (i = 0; i < n; ++i) {
+    to[i] = TUE_2017_01_03;
+  }
+  CHECK(mf_business_days_between(target, dates, to, n, 1, 0, counts)
+        == MF_OK);
+  /* 23, 27, 28, 29, 30 December and 2 January */
+  CHECK(counts[0] == 6);
+  CHECK(counts[5] == 1);
+  CHECK(mf_business_days_between(target, to, dates, 1, 1, 0, counts)
+        == MF_OK);
+  CHECK(counts[0] == -6);
+
+  /* errors are reported, not thrown */
+  dates[3] = 12;
+  CHECK(mf_is_business_day(target, dates, n, business)
+        == MF_ERROR_OUT_OF_RANGE);
+  CHECK(strstr(mf_last_error(), "dates[3]") != 0);
+  dates[3] = TUE_2016_12_27;
+  CHECK(mf_adjust(target, dates, n, (mf_convention) 42, adjusted)
+        == MF_ERROR_INVALID_ARGUMENT);
+  CHECK(mf_adjust(0, dates, n, MF_FOLLOWING, adjusted)
+        == MF_ERROR_NULL_ARGUMENT);
+  CHECK(mf_adjust(target, dates, n, MF_FOLLOWING, 0)
+        == MF_ERROR_NULL_ARGUMENT);
+  /* advancing past 2199 */
+  CHECK(mf_advance(target, dates, n, 300, MF_YEARS, MF_FOLLOWING, 0, advanced)
+        == MF_ERROR_OUT_OF_RANGE);
+  /* empty buffers */
+  CHECK(mf_adjust(target, 0, 0, MF_FOLLOWING, 0) == MF_OK);
+
+  mf_calendar_destroy(target);
+}
+
+static void testDayCounter(void) {
+  mf_daycounter* dayCounter = 0;
+  const int32_t d1[] = { FRI_2016_12_23, MON_2017_01_02 };
+  const int32_t d2[] = { MON_2017_01_02, FRI_2017_06_30 };
+  double fractions[2];
+
+  CHECK(mf_daycounter_create("Actual/360", &dayCounter) == MF_OK);
+  CHECK(mf_year_fraction(dayCounter, d1, d2, 2, fractions) == MF_OK);
+  CHECK(fabs(fractions[0] - 10.0 / 360.0) < 1.0e-15);
+  CHECK(fabs(fractions[1] - 179.0 / 360.0) < 1.0e-15);
+  CHECK(mf_year_fraction(dayCounter, d1, 0, 2, fractions)
+        == MF_ERROR_NULL_ARGUMENT);
+  mf_daycounter_destroy(dayCounter);
+
+  CHECK(mf_daycounter_create("Actual/Actual (ISDA)", &dayCounter) == MF_OK);
+  CHECK(mf_year_fraction(dayCounter, d1, d2, 1, fractions) == MF_OK);
+  CHECK(fabs(fractions[0] - (9.0 / 366.0 + 1.0 / 365.0)) < 1.0e-15);
+  mf_daycounter_destroy(dayCounter);
+}
+
+int main(void) {
+  testHandles();
+  testCalendar();
+  testDayCounter();
+  if (failures != 0) {
+    fprintf(stderr, "%d failed checks\n", failures);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,416 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <capi/mathfin.h>
+
+#include <base/error.hpp>
+#include <time/businessdaybitmap.hpp>
+#include <time/calendars/registry.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actual365fixed.hpp>
+#include <time/daycounters/actualactual.hpp>
+#include <time/daycounters/business252.hpp>
+#include <time/daycounters/one.hpp>
+#include <time/daycounters/simpledaycounter.hpp>
+#include <time/daycounters/thirty360.hpp>
+
+#include <new>
+#include <sstream>
+#include <string>
+
+using namespace MathFin;
+
+// the handles keep the precomputed business days of the calendar, which
+// answer isBusinessDay and businessDaysBetween without evaluating rules
+struct mf_calendar {
+  explicit mf_calendar(const Calendar& c) : calendar(c), bitmap(c) {}
+  const Calendar calendar;
+  const BusinessDayBitmap bitmap;
+};
+
+struct mf_daycounter {
+  explicit mf_daycounter(const DayCounter& d) : dayCounter(d) {}
+  const DayCounter dayCounter;
+};
+
+namespace {
+
+  thread_local std::string lastError;
+
+  mf_status fail(mf_status status, const std::string& message) {
+    lastError = message;
+    return status;
+  }
+
+  // runs f, translating any exception into a status
+  template <class F>
+  mf_status guard(const char* function, const F& f) {
+    try {
+      return f();
+    } catch (std::bad_alloc&) {
+      return fail(MF_ERROR_INTERNAL, std::string(function) + ": out of memory");
+    } catch (std::exception& e) {
+      return fail(MF_ERROR_INTERNAL, std::string(function) + ": " + e.what());
+    } catch (...) {
+      return fail(MF_ERROR_INTERNAL, std::string(function) + ": unknown error");
+    }
+  }
+
+  mf_status failAt(mf_status status, const char* function, size_t i,
+                   const std::string& message) {
+    std::ostringstream out;
+    out << function << ": element " << i << ": " << message;
+    return fail(status, out.str());
+  }
+
+  mf_status nullArgument(const char* function, const char* argument) {
+    return fail(MF_ERROR_NULL_ARGUMENT,
+                std::string(function) + ": null " + argument);
+  }
+
+  mf_status checkDates(const char* function, const char* argument,
+                       const int32_t* dates, size_t n) {
+    if (n > 0 && !dates) {
+      return nullArgument(function, argument);
+    }
+    const Date::serial_type first = Date::minDate().serialNumber();
+    const Date::serial_type last = Date::maxDate().serialNumber();
+    for (size_t i = 0; i < n; ++i) {
+      if (dates[i] < first || dates[i] > last) {
+        std::ostringstream out;
+        out << function << ": " << argument << "[" << i << "] ("
+            << dates[i] << ") outside [" << first << ", " << last << "]";
+        return fail(MF_ERROR_OUT_OF_RANGE, out.str());
+      }
+    }
+    return MF_OK;
+  }
+
+  bool convert(mf_convention c, BusinessDayConvention& result) {
+    switch (c) {
+    case MF_FOLLOWING:
+      result = BusinessDayConvention::Following;
+      return true;
+    case MF_MODIFIED_FOLLOWING:
+      result = BusinessDayConvention::ModifiedFollowing;
+      return true;
+    case MF_PRECEDING:
+      result = BusinessDayConvention::Preceding;
+      return true;
+    case MF_MODIFIED_PRECEDING:
+      result = BusinessDayConvention::ModifiedPreceding;
+      return true;
+    case MF_UNADJUSTED:
+      result = BusinessDayConvention::Unadjusted;
+      return true;
+    case MF_HALF_MONTH_MODIFIED_FOLLOWING:
+      result = BusinessDayConvention::HalfMonthModifiedFollowing;
+      return true;
+    case MF_NEAREST:
+      result = BusinessDayConvention::Nearest;
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  bool convert(mf_time_unit u, TimeUnit& result) {
+    switch (u) {
+    case MF_DAYS:
+      result = TimeUnit::Days;
+      return true;
+    case MF_WEEKS:
+      result = TimeUnit::Weeks;
+      return true;
+    case MF_MONTHS:
+      result = TimeUnit::Months;
+      return true;
+    case MF_YEARS:
+      result = TimeUnit::Years;
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  DayCounter dayCounterNamed(const std::string& name) {
+    const DayCounter dayCounters[] = {
+      Actual360(), Actual365Fixed(),
+      ActualActual(ActualActual::Convention::ISMA),
+      ActualActual(ActualActual::Convention::ISDA),
+      ActualActual(ActualActual::Convention::AFB),
+      OneDayCounter(), SimpleDayCounter(),
+      Thirty360(Thirty360::Convention::USA),
+      Thirty360(Thirty360::Convention::European),
+      Thirty360(Thirty360::Convention::Italian)
+    };
+    for (Size i = 0; i < sizeof(dayCounters) / sizeof(dayCounters[0]); ++i) {
+      if (dayCounters[i].name() == name) {
+        return dayCounters[i];
+      }
+    }
+    return DayCounter();
+  }
+
+}
+
+// -----------------------------------------------------------------------------
+
+int mf_abi_version(void) {
+  return MF_ABI_VERSION;
+}
+
+const char* mf_status_string(mf_status status) {
+  switch (status) {
+  case MF_OK:
+    return "no error";
+  case MF_ERROR_NULL_ARGUMENT:
+    return "null argument";
+  case MF_ERROR_UNKNOWN_NAME:
+    return "unknown name";
+  case MF_ERROR_OUT_OF_RANGE:
+    return "date out of range";
+  case MF_ERROR_INVALID_ARGUMENT:
+    return "invalid argument";
+  case MF_ERROR_INTERNAL:
+    return "internal error";
+  default:
+    return "unknown status";
+  }
+}
+
+const char* mf_last_error(void) {
+  return lastError.c_str();
+}
+
+mf_status mf_calendar_create(const char* name, mf_calendar** calendar) {
+  return guard("mf_calendar_create", [&]() {
+      if (!name) {
+        return nullArgument("mf_calendar_create", "name");
+      }
+      if (!calendar) {
+        return nullArgument("mf_calendar_create", "calendar");
+      }
+      const Calendar c = calendarNamed(name);
+      if (c.empty()) {
+        return fail(MF_ERROR_UNKNOWN_NAME,
+                    std::string("mf_calendar_create: unknown calendar '")
+                    + name + "'");
+      }
+      *calendar = new mf_calendar(c);
+      return MF_OK;
+    });
+}
+
+void mf_calendar_destroy(mf_calendar* calendar) {
+  delete calendar;
+}
+
+mf_status mf_daycounter_create(const char* name, mf_daycounter** dayCounter) {
+  return guard("mf_daycounter_create", [&]() {
+      if (!name) {
+        return nullArgument("mf_daycounter_create", "name");
+      }
+      if (!dayCounter) {
+        return nullArgument("mf_daycounter_create", "dayCounter");
+      }
+      const DayCounter d = dayCounterNamed(name);
+      if (d.empty()) {
+        return fail(MF_ERROR_UNKNOWN_NAME,
+                    std::string("mf_daycounter_create: unknown day counter '")
+                    + name + "'");
+      }
+      *dayCounter = new mf_daycounter(d);
+      return MF_OK;
+    });
+}
+
+mf_status mf_daycounter_create_business252(const mf_calendar* calendar,
+                                           mf_daycounter** dayCounter) {
+  return guard("mf_daycounter_create_business252", [&]() {
+      if (!calendar) {
+        return nullArgument("mf_daycounter_create_business252", "calendar");
+      }
+      if (!dayCounter) {
+        return nullArgument("mf_daycounter_create_business252",
+                            "dayCounter");
+      }
+      *dayCounter = new mf_daycounter(Business252(calendar->calendar));
+      return MF_OK;
+    });
+}
+
+void mf_daycounter_destroy(mf_daycounter* dayCounter) {
+  delete dayCounter;
+}
+
+// -----------------------------------------------------------------------------
+
+mf_status mf_is_business_day(const mf_calendar* calendar,
+                             const int32_t* dates, size_t n,
+                             uint8_t* result) {
+  const char* function = "mf_is_business_day";
+  return guard(function, [&]() {
+      if (!calendar) {
+        return nullArgument(function, "calendar");
+      }
+      if (n > 0 && !result) {
+        return nullArgument(function, "result");
+      }
+      const mf_status status = checkDates(function, "dates", dates, n);
+      if (status != MF_OK) {
+        return status;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        result[i] = calendar->bitmap.isBusinessDay(dates[i]) ? 1 : 0;
+      }
+      return MF_OK;
+    });
+}
+
+mf_status mf_adjust(const mf_calendar* calendar,
+                    const int32_t* dates, size_t n,
+                    mf_convention convention,
+                    int32_t* result) {
+  const char* function = "mf_adjust";
+  return guard(function, [&]() {
+      if (!calendar) {
+        return nullArgument(function, "calendar");
+      }
+      if (n > 0 && !result) {
+        return nullArgument(function, "result");
+      }
+      BusinessDayConvention c;
+      if (!convert(convention, c)) {
+        return fail(MF_ERROR_INVALID_ARGUMENT,
+                    "mf_adjust: invalid business-day convention");
+      }
+      const mf_status status = checkDates(function, "dates", dates, n);
+      if (status != MF_OK) {
+        return status;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        try {
+          result[i] = int32_t(calendar->calendar.adjust(
+                                Date::unchecked(dates[i]), c).serialNumber());
+        } catch (Error& e) {
+          return failAt(MF_ERROR_OUT_OF_RANGE, function, i, e.what());
+        }
+      }
+      return MF_OK;
+    });
+}
+
+mf_status mf_advance(const mf_calendar* calendar,
+                     const int32_t* dates, size_t n,
+                     int32_t length, mf_time_unit unit,
+                     mf_convention convention, int endOfMonth,
+                     int32_t* result) {
+  const char* function = "mf_advance";
+  return guard(function, [&]() {
+      if (!calendar) {
+        return nullArgument(function, "calendar");
+      }
+      if (n > 0 && !result) {
+        return nullArgument(function, "result");
+      }
+      BusinessDayConvention c;
+      TimeUnit u;
+      if (!convert(convention, c)) {
+        return fail(MF_ERROR_INVALID_ARGUMENT,
+                    "mf_advance: invalid business-day convention");
+      }
+      if (!convert(unit, u)) {
+        return fail(MF_ERROR_INVALID_ARGUMENT, "mf_advance: invalid time unit");
+      }
+      const mf_status status = checkDates(function, "dates", dates, n);
+      if (status != MF_OK) {
+        return status;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        try {
+          result[i] = int32_t(calendar->calendar.advance(
+                                Date::unchecked(dates[i]), length, u, c,
+                                endOfMonth != 0).serialNumber());
+        } catch (Error& e) {
+          return failAt(MF_ERROR_OUT_OF_RANGE, function, i, e.what());
+        }
+      }
+      return MF_OK;
+    });
+}
+
+mf_status mf_business_days_between(const mf_calendar* calendar,
+                                   const int32_t* from, const int32_t* to,
+                                   size_t n,
+                                   int includeFirst, int includeLast,
+                                   int32_t* result) {
+  const char* function = "mf_business_days_between";
+  return guard(function, [&]() {
+      if (!calendar) {
+        return nullArgument(function, "calendar");
+      }
+      if (n > 0 && !result) {
+        return nullArgument(function, "result");
+      }
+      mf_status status = checkDates(function, "from", from, n);
+      if (status == MF_OK) {
+        status = checkDates(function, "to", to, n);
+      }
+      if (status != MF_OK) {
+        return status;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        result[i] = int32_t(calendar->bitmap.businessDaysBetween(
+                              from[i], to[i],
+                              includeFirst != 0, includeLast != 0));
+      }
+      return MF_OK;
+    });
+}
+
+mf_status mf_year_fraction(const mf_daycounter* dayCounter,
+                           const int32_t* d1, const int32_t* d2, size_t n,
+                           double* result) {
+  const char* function = "mf_year_fraction";
+  return guard(function, [&]() {
+      if (!dayCounter) {
+        return nullArgument(function, "dayCounter");
+      }
+      if (n > 0 && !result) {
+        return nullArgument(function, "result");
+      }
+      mf_status status = checkDates(function, "d1", d1, n);
+      if (status == MF_OK) {
+        status = checkDates(function, "d2", d2, n);
+      }
+      if (status != MF_OK) {
+        return status;
+      }
+      for (size_t i = 0; i < n; ++i) {
+        try {
+          result[i] = dayCounter->dayCounter.yearFractionUnchecked(
+            Date::unchecked(d1[i]), Date::unchecked(d2[i]));
+        } catch (Error& e) {
+          return failAt(MF_ERROR_OUT_OF_RANGE, function, i, e.what());
+        }
+      }
+      return MF_OK;
+    });
+}
@@ -0,0 +1,171 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file mathfin.h
+ * @brief C interface to calendars and day counters
+ *
+ * A stable C ABI for callers in other languages holding dates in columnar
+ * arrays.  Calendars and day counters are opaque handles; every function
+ * works on caller-provided buffers of serial numbers (as in Excel, from
+ * 367 for 1901-01-01 to 109574 for 2199-12-31) and writes its results in
+ * place, so that nothing is copied across the boundary.
+ *
+ * No exception crosses the boundary: every function returns an
+ * mf_status, and mf_last_error() describes the last failure on the
+ * calling thread.  When a batch function fails, the contents of its
+ * result buffer are unspecified.
+ *
+ * Handles are immutable once created and may be used concurrently.
+ */
+
+#ifndef MATHFIN_H
+#define MATHFIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Version of the interface, incremented on incompatible changes.
+ */
+#define MF_ABI_VERSION 1
+
+typedef enum {
+  MF_OK = 0,
+  MF_ERROR_NULL_ARGUMENT,   /**< a required pointer is null */
+  MF_ERROR_UNKNOWN_NAME,    /**< no calendar or day counter of that name */
+  MF_ERROR_OUT_OF_RANGE,    /**< a date or result outside 1901-2199 */
+  MF_ERROR_INVALID_ARGUMENT,/**< an enumeration value out of range */
+  MF_ERROR_INTERNAL         /**< any other failure */
+} mf_status;
+
+typedef enum {
+  MF_FOLLOWING = 0,
+  MF_MODIFIED_FOLLOWING,
+  MF_PRECEDING,
+  MF_MODIFIED_PRECEDING,
+  MF_UNADJUSTED,
+  MF_HALF_MONTH_MODIFIED_FOLLOWING,
+  MF_NEAREST
+} mf_convention;
+
+typedef enum {
+  MF_DAYS = 0,
+  MF_WEEKS,
+  MF_MONTHS,
+  MF_YEARS
+} mf_time_unit;
+
+typedef struct mf_calendar mf_calendar;
+typedef struct mf_daycounter mf_daycounter;
+
+/**
+ * MF_ABI_VERSION of the library actually loaded.
+ */
+int mf_abi_version(void);
+
+/**
+ * Static description of a status.
+ */
+const char* mf_status_string(mf_status status);
+
+/**
+ * Description of the last failure on the calling thread; valid until the
+ * next call failing on that thread.
+ */
+const char* mf_last_error(void);
+
+/**
+ * Creates a calendar by name, as returned by its name() method in C++:
+ * "TARGET", "Australia", "Brazil", "BOVESPA", "UK settlement",
+ * "London stock exchange", "London metals exchange", "US settlement",
+ * "New York stock exchange", "US government bond market",
+ * "North American Energy Reliability Council" or "Null".
+ */
+mf_status mf_calendar_create(const char* name, mf_calendar** calendar);
+
+void mf_calendar_destroy(mf_calendar* calendar);
+
+/**
+ * Creates a day counter by name, as returned by its name() method in C++,
+ * e.g. "Actual/360", "Actual/365 (Fixed)", "Actual/Actual (ISDA)",
+ * "Actual/Actual (ISMA)", "Actual/Actual (AFB)", "30/360 (Bond Basis)",
+ * "30E/360 (Eurobond Basis)", "30/360 (Italian)", "Simple" or "1/1".
+ */
+mf_status mf_daycounter_create(const char* name, mf_daycounter** dayCounter);
+
+/**
+ * Creates a Business/252 day counter over the given calendar.
+ */
+mf_status mf_daycounter_create_business252(const mf_calendar* calendar,
+                                           mf_daycounter** dayCounter);
+
+void mf_daycounter_destroy(mf_daycounter* dayCounter);
+
+/**
+ * result[i] = 1 if dates[i] is a business day, 0 otherwise.
+ */
+mf_status mf_is_business_day(const mf_calendar* calendar,
+                             const int32_t* dates, size_t n,
+                             uint8_t* result);
+
+/**
+ * result[i] = dates[i] adjusted according to the convention.
+ */
+mf_status mf_adjust(const mf_calendar* calendar,
+                    const int32_t* dates, size_t n,
+                    mf_convention convention,
+                    int32_t* result);
+
+/**
+ * result[i] = dates[i] advanced by the given number of units; days are
+ * business days, other units are adjusted according to the convention.
+ */
+mf_status mf_advance(const mf_calendar* calendar,
+                     const int32_t* dates, size_t n,
+                     int32_t length, mf_time_unit unit,
+                     mf_convention convention, int endOfMonth,
+                     int32_t* result);
+
+/**
+ * result[i] = number of business days between from[i] and to[i],
+ * negative if from[i] is later than to[i].
+ */
+mf_status mf_business_days_between(const mf_calendar* calendar,
+                                   const int32_t* from, const int32_t* to,
+                                   size_t n,
+                                   int includeFirst, int includeLast,
+                                   int32_t* result);
+
+/**
+ * result[i] = year fraction between d1[i] and d2[i].
+ */
+mf_status mf_year_fraction(const mf_daycounter* dayCounter,
+                           const int32_t* d1, const int32_t* d2, size_t n,
+                           double* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MATHFIN_H */
@@ -0,0 +1,201 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file hotpath.hpp
+ * @brief allocation and exception accounting for hot-path test cases
+ *
+ * Replaces the global allocation functions and, where the C++ runtime
+ * allows it, the function raising exceptions, so that a test can assert
+ * that a block of code neither touches the heap nor throws.  Like
+ * CATCH_CONFIG_MAIN, exactly one source file of a test program must
+ * define MATHFIN_HOTPATH_HOOKS before including this header.
+ *
+ * @code
+ * TEST_CASE("...", "[hotpath]") {
+ *   Calendar calendar = TARGET();
+ *   Date d(15, Month::June, 2017);
+ *   calendar.isBusinessDay(d);          // warm up
+ *   REQUIRE_HOT_PATH(calendar.isBusinessDay(d));
+ * }
+ * @endcode
+ */
+
+#ifndef MATHFIN_HOTPATH_HPP
+#define MATHFIN_HOTPATH_HPP
+
+#include <cstddef>
+
+namespace MathFin {
+
+  namespace test {
+
+    /**
+     * Allocations and exceptions observed on a thread.
+     */
+    struct HotPathCounts {
+      std::size_t allocations;
+      std::size_t exceptions;
+    };
+
+    /**
+     * Counts on the calling thread since it started.
+     */
+    HotPathCounts hotPathCounts();
+
+    /**
+     * Whether thrown exceptions are counted on this platform.
+     */
+    bool hotPathCountsExceptions();
+
+    /**
+     * Records the allocations and exceptions of the calling thread during
+     * its lifetime.
+     */
+    class HotPathGuard {
+    public:
+      HotPathGuard() : start_(hotPathCounts()) {}
+
+      std::size_t allocations() const {
+        return hotPathCounts().allocations - start_.allocations;
+      }
+
+      std::size_t exceptions() const {
+        return hotPathCounts().exceptions - start_.exceptions;
+      }
+
+    private:
+      HotPathCounts start_;
+    };
+
+  }
+
+}
+
+/**
+ * Evaluates the expression and requires it to have neither allocated nor
+ * thrown.  An exception escaping from the expression is a failure on every
+ * platform, whether or not thrown exceptions are counted.
+ */
+#define REQUIRE_HOT_PATH(expr)                                          \
+  do {                                                                  \
+    std::size_t mf_hotpath_allocations = 0, mf_hotpath_exceptions = 0; \
+    bool mf_hotpath_escaped = false;                                    \
+    {                                                                   \
+      MathFin::test::HotPathGuard mf_hotpath_guard;                    \
+      try {                                                             \
+        static_cast<void>(expr);                                        \
+      } catch (...) {                                                   \
+        mf_hotpath_escaped = true;                                      \
+      }                                                                 \
+      mf_hotpath_allocations = mf_hotpath_guard.allocations();          \
+      mf_hotpath_exceptions = mf_hotpath_guard.exceptions();            \
+    }                                                                   \
+    INFO("hot path: " #expr);                                           \
+    REQUIRE_FALSE(mf_hotpath_escaped);                                  \
+    REQUIRE(mf_hotpath_allocations == 0);                               \
+    REQUIRE(mf_hotpath_exceptions == 0);                                \
+  } while (false)
+
+#ifdef MATHFIN_HOTPATH_HOOKS
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBCXX__) && defined(__linux__)
+#include <dlfcn.h>
+#define MATHFIN_HOTPATH_EXCEPTIONS
+#endif
+
+namespace MathFin {
+
+  namespace test {
+
+    namespace {
+      thread_local std::size_t allocationCount = 0;
+      thread_local std::size_t exceptionCount = 0;
+
+      void* allocate(std::size_t size) {
+        ++allocationCount;
+        if (void* p = std::malloc(size == 0 ? 1 : size)) {
+          return p;
+        }
+        throw std::bad_alloc();
+      }
+    }
+
+    HotPathCounts hotPathCounts() {
+      HotPathCounts counts = { allocationCount, exceptionCount };
+      return counts;
+    }
+
+    bool hotPathCountsExceptions() {
+#ifdef MATHFIN_HOTPATH_EXCEPTIONS
+      return true;
+#else
+      return false;
+#endif
+    }
+
+  }
+
+}
+
+void* operator new(std::size_t size) {
+  return MathFin::test::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+  return MathFin::test::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  ++MathFin::test::allocationCount;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+  ++MathFin::test::allocationCount;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#ifdef MATHFIN_HOTPATH_EXCEPTIONS
+
+// every throw expression calls the runtime's __cxa_throw, which the
+// executable preempts; the original is looked up on first use
+extern "C" __attribute__((noreturn))
+void __cxa_throw(void* object, void* type, void (*destroy)(void*)) {
+  typedef void (*Throw)(void*, void*, void (*)(void*));
+  static const Throw original =
+    reinterpret_cast<Throw>(dlsym(RTLD_NEXT, "__cxa_throw"));
+  ++MathFin::test::exceptionCount;
+  original(object, type, destroy);
+  std::abort();
+}
+
+#endif
+
+#endif /* MATHFIN_HOTPATH_HOOKS */
+
+#endif /* MATHFIN_HOTPATH_HPP */
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/threadpool.hpp>
+#include <base/trace.hpp>
+#include <time/accruedinterest.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MathFin {
+
+  namespace {
+    // settlements per parallel chunk
+    const Size batchGrain = 1024;
+
+    // relative difference accepted between the year fraction and the
+    // proportional day count
+    const Real proportionalityTolerance = 1.0e-12;
+  }
+
+  AccruedInterest::AccruedInterest() : dateOffsets_(1, 0) {}
+
+  Size AccruedInterest::add(const Leg& leg) {
+    const std::vector<Date::serial_type>& dates =
+      leg.schedule().serialNumbers();
+    const DayCounter& dayCounter = leg.dayCounter();
+
+    for (Size i = 0; i < leg.size(); ++i) {
+      const Date start = Date::unchecked(dates[i]);
+      const Date end = Date::unchecked(dates[i + 1]);
+      Date::serial_type refStart, refEnd;
+      leg.referencePeriod(i, refStart, refEnd);
+      const Date referenceStart = Date::unchecked(refStart);
+      const Date referenceEnd = Date::unchecked(refEnd);
+      const Real amount = leg.notional(i) * (leg.rate(i) + leg.spread());
+      const Time fraction = dayCounter.yearFraction(start, end,
+                                                    referenceStart,
+                                                    referenceEnd);
+      const Date::serial_type days = dayCounter.dayCount(start, end);
+
+      Mode mode = days > 0 ? ActualDays : YearFraction;
+      for (Date::serial_type d = dates[i] + 1;
+           d < dates[i + 1] && mode != YearFraction; ++d) {
+        const Date settlement = Date::unchecked(d);
+        const Date::serial_type count = dayCounter.dayCount(start, settlement);
+        const Time expected =
+          dayCounter.yearFraction(start, settlement,
+                                  referenceStart, referenceEnd);
+        if (std::fabs(expected - fraction * count / days)
+            > proportionalityTolerance * std::fabs(fraction)) {
+          mode = YearFraction;
+        } else if (count != d - dates[i]) {
+          mode = DayCount;
+        }
+      }
+      modes_.push_back(mode);
+      referenceStarts_.push_back(refStart);
+      referenceEnds_.push_back(refEnd);
+      factors_.push_back(mode == YearFraction ? amount
+                         : amount * fraction / days);
+    }
+
+    dates_.insert(dates_.end(), dates.begin(), dates.end());
+    dateOffsets_.push_back(dates_.size());
+    dayCounters_.push_back(dayCounter);
+    return dayCounters_.size() - 1;
+  }
+
+  Real AccruedInterest::accrued(Size bond,
+                                Date::serial_type settlement) const {
+    const Date::serial_type* first = &dates_[0] + dateOffsets_[bond];
+    const Date::serial_type* last = &dates_[0] + dateOffsets_[bond + 1];
+    if (settlement <= *first || settlement >= *(last - 1)) {
+      return 0.0;
+    }
+    // the period i starting at first[i] contains the settlement date
+    const Size i = Size(std::upper_bound(first, last, settlement) - first) - 1;
+    const Size period = dateOffsets_[bond] - bond + i;
+    const Date::serial_type start = first[i];
+    switch (modes_[period]) {
+    case ActualDays:
+      return factors_[period] * (settlement - start);
+    case DayCount:
+      return factors_[period] * dayCounters_[bond].dayCount(
+        Date::unchecked(start), Date::unchecked(settlement));
+    default:
+      return factors_[period] * dayCounters_[bond].yearFraction(
+        Date::unchecked(start), Date::unchecked(settlement),
+        Date::unchecked(referenceStarts_[period]),
+        Date::unchecked(referenceEnds_[period]));
+    }
+  }
+
+  Real AccruedInterest::operator()(Size bond, const Date& settlement) const {
+    MF_REQUIRE(bond < size(), "bond " << bond << " out of range [0, "
+               << size() << ")");
+    return accrued(bond, settlement.serialNumber());
+  }
+
+  void AccruedInterest::accrued(const Size* bonds,
+                                const Date::serial_type* settlements,
+                                Size n,
+                                Real* result,
+                                ThreadPool* pool) const {
+    MF_TRACE_SPAN("AccruedInterest::accrued", "accrued");
+    for (Size k = 0; k < n; ++k) {
+      MF_REQUIRE(bonds[k] < size(), "bond " << bonds[k]
+                 << " out of range [0, " << size() << ")");
+    }
+    parallelFor(pool, 0, n, batchGrain, [&](Size lo, Size hi) {
+        for (Size k = lo; k < hi; ++k) {
+          result[k] = accrued(bonds[k], settlements[k]);
+        }
+      });
+  }
+
+}
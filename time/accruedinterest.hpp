@@ -0,0 +1,109 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file accruedinterest.hpp
+ * @brief accrued interest of many bonds at arbitrary settlement dates
+ */
+
+#ifndef MATHFIN_ACCRUEDINTEREST_HPP
+#define MATHFIN_ACCRUEDINTEREST_HPP
+
+#include <time/legengine.hpp>
+
+#include <vector>
+
+namespace MathFin {
+
+  class ThreadPool;
+
+  /**
+   * Accrued interest of a book of bonds.
+   *
+   * Each bond is given by its coupon Leg.  The accrued interest at a
+   * settlement date is that of the coupon whose accrual period contains
+   * it, from the start of the period to the settlement date, with the
+   * reference period of the coupon (see Leg::referencePeriod()); it is
+   * zero outside the schedule.
+   *
+   * The schedules of all bonds are kept in one sorted array of serial
+   * numbers, so that the current period is found by a binary search over
+   * a few dozen integers.  On construction each period is checked
+   * against its day counter: when the year fraction within the period is
+   * proportional to the day count, as for the 30/360, Actual/360,
+   * Actual/365 and Actual/Actual (ISMA) conventions, the accrued interest
+   * per day is cached and a lookup costs one multiplication (and the
+   * day count, if it is not the number of calendar days); otherwise the
+   * day counter is called.
+   *
+   * @ingroup datetime
+   */
+  class AccruedInterest {
+  public:
+    AccruedInterest();
+
+    /**
+     * Adds a bond and returns its index; the leg is not referenced
+     * afterwards.
+     */
+    Size add(const Leg& leg);
+
+    /**
+     * Number of bonds.
+     */
+    Size size() const { return dayCounters_.size(); }
+
+    /**
+     * Accrued interest of the given bond at the settlement date.
+     */
+    Real operator()(Size bond, const Date& settlement) const;
+
+    /**
+     * Accrued interest of <tt>n</tt> (bond, settlement date) pairs.
+     */
+    void accrued(const Size* bonds,
+                 const Date::serial_type* settlements,
+                 Size n,
+                 Real* result,
+                 ThreadPool* pool = 0) const;
+
+  private:
+    enum Mode {
+      ActualDays,    // factor times calendar days
+      DayCount,      // factor times day count
+      YearFraction   // amount times year fraction
+    };
+
+    Real accrued(Size bond, Date::serial_type settlement) const;
+
+    // schedule dates of bond b from dateOffsets_[b] to dateOffsets_[b + 1];
+    // its periods start at dateOffsets_[b] - b
+    std::vector<Date::serial_type> dates_;
+    std::vector<Size> dateOffsets_;
+    std::vector<DayCounter> dayCounters_;
+    // by period
+    std::vector<unsigned char> modes_;
+    std::vector<Real> factors_;
+    std::vector<Date::serial_type> referenceStarts_;
+    std::vector<Date::serial_type> referenceEnds_;
+  };
+
+}
+
+#endif /* MATHFIN_ACCRUEDINTEREST_HPP */
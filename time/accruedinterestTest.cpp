@@ -0,0 +1,147 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <vector>
+
+#include <base/threadpool.hpp>
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/accruedinterest.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actualactual.hpp>
+#include <time/daycounters/thirty360.hpp>
+
+using namespace MathFin;
+
+namespace {
+
+  Schedule makeSchedule(const Date& start, const Date& end,
+                        const Period& tenor, const Calendar& calendar) {
+    return Schedule(start, end, tenor, calendar,
+                    BusinessDayConvention::Unadjusted,
+                    BusinessDayConvention::Unadjusted,
+                    DateGeneration::Backward, false);
+  }
+
+  // accrued interest computed from the coupon period of the settlement
+  Real expectedAccrued(const Leg& leg, const Date& settlement) {
+    const Schedule& schedule = leg.schedule();
+    for (Size i = 0; i < leg.size(); ++i) {
+      if (schedule[i] < settlement && settlement < schedule[i + 1]) {
+        Date::serial_type refStart, refEnd;
+        leg.referencePeriod(i, refStart, refEnd);
+        return leg.notional(i) * (leg.rate(i) + leg.spread())
+          * leg.dayCounter().yearFraction(schedule[i], settlement,
+                                          Date(refStart), Date(refEnd));
+      }
+    }
+    return 0.0;
+  }
+
+}
+
+TEST_CASE("Accrued interest matches the day counters", "[accruedinterest]") {
+  const Schedule semiannual =
+    makeSchedule(Date(15, Month::February, 2015),
+                 Date(15, Month::February, 2025),
+                 Period(6, TimeUnit::Months), UnitedStates::GovernmentBond());
+  const Schedule annual =
+    makeSchedule(Date(31, Month::January, 2016), Date(31, Month::January, 2023),
+                 Period(1, TimeUnit::Years), TARGET());
+  const Schedule quarterly =
+    makeSchedule(Date(10, Month::November, 2015),
+                 Date(10, Month::November, 2020),
+                 Period(3, TimeUnit::Months), TARGET());
+
+  std::vector<Real> amortizing;
+  for (Size i = 0; i + 1 < quarterly.size(); ++i) {
+    amortizing.push_back(100.0 - 5.0 * i);
+  }
+  std::vector<Leg> legs;
+  legs.push_back(Leg(semiannual, std::vector<Real>(1, 100.0), 0.02125,
+                     ActualActual(ActualActual::Convention::ISMA)));
+  legs.push_back(Leg(annual, std::vector<Real>(1, 100.0), 0.0075,
+                     Thirty360(Thirty360::Convention::European)));
+  legs.push_back(Leg(quarterly, amortizing, 0.015, Actual360()));
+  // short first coupon
+  const Schedule stubs(Date(15, Month::February, 2017),
+                       Date(31, Month::December, 2020),
+                       Period(6, TimeUnit::Months), TARGET(),
+                       BusinessDayConvention::Unadjusted,
+                       BusinessDayConvention::Unadjusted,
+                       DateGeneration::Backward, false);
+  legs.push_back(Leg(stubs, std::vector<Real>(1, 100.0), 0.03,
+                     ActualActual(ActualActual::Convention::ISMA)));
+  // not proportional across year ends: computed by the day counter
+  legs.push_back(Leg(annual, std::vector<Real>(1, 100.0), 0.01,
+                     ActualActual(ActualActual::Convention::ISDA)));
+  // short first coupon starting four days after the regular period
+  const Schedule nearlyRegular(Date(19, Month::December, 2016),
+                               Date(15, Month::December, 2017),
+                               Period(3, TimeUnit::Months), TARGET(),
+                               BusinessDayConvention::ModifiedFollowing,
+                               BusinessDayConvention::ModifiedFollowing,
+                               DateGeneration::Backward, false);
+  legs.push_back(Leg(nearlyRegular, std::vector<Real>(1, 100.0), 0.04,
+                     ActualActual(ActualActual::Convention::ISMA)));
+
+  AccruedInterest accrued;
+  for (Size j = 0; j < legs.size(); ++j) {
+    REQUIRE(accrued.add(legs[j]) == j);
+  }
+  REQUIRE(accrued.size() == legs.size());
+
+  std::vector<Size> bonds;
+  std::vector<Date::serial_type> settlements;
+  std::vector<Real> expected;
+  for (Date::serial_type s = Date(1, Month::January, 2015).serialNumber();
+       s <= Date(1, Month::March, 2025).serialNumber(); ++s) {
+    for (Size j = 0; j < legs.size(); ++j) {
+      const Real value = expectedAccrued(legs[j], Date(s));
+      REQUIRE(std::fabs(accrued(j, Date(s)) - value) <= 1.0e-12);
+      bonds.push_back(j);
+      settlements.push_back(s);
+      expected.push_back(value);
+    }
+  }
+
+  const Size n = bonds.size();
+  std::vector<Real> result(n);
+  ThreadPool pool(3);
+  accrued.accrued(&bonds[0], &settlements[0], n, &result[0], &pool);
+  for (Size k = 0; k < n; ++k) {
+    REQUIRE(std::fabs(result[k] - expected[k]) <= 1.0e-12);
+  }
+
+  // lookups neither allocate nor throw
+  REQUIRE_HOT_PATH(accrued.accrued(&bonds[0], &settlements[0], n,
+                                   &result[0]));
+
+  // 28 days of the 182 from 30-Dec-2016 to 30-Jun-2017
+  REQUIRE(std::fabs(accrued(3, Date(15, Month::March, 2017))
+                    - 100.0 * 0.03 * 0.5 * 28 / 182) <= 1.0e-12);
+  // 44 days of the 90 from 15-Dec-2016 to 15-Mar-2017
+  REQUIRE(std::fabs(accrued(5, Date(1, Month::February, 2017))
+                    - 100.0 * 0.04 * 0.25 * 44 / 90) <= 1.0e-12);
+
+  REQUIRE_THROWS_AS(accrued(legs.size(), Date(1, Month::March, 2016)), Error);
+}
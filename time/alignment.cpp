@@ -0,0 +1,177 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/threadpool.hpp>
+#include <base/trace.hpp>
+#include <time/alignment.hpp>
+#include <time/civil.hpp>
+
+#include <limits>
+
+namespace MathFin {
+
+  namespace {
+    const Real missing = std::numeric_limits<Real>::quiet_NaN();
+  }
+
+  AlignmentGrid::AlignmentGrid(const std::vector<Date::serial_type>& dates)
+    : dates_(dates) {
+    for (Size i = 1; i < dates_.size(); ++i) {
+      MF_REQUIRE(dates_[i - 1] < dates_[i],
+                 "grid dates not increasing at position " << i);
+    }
+  }
+
+  AlignmentGrid AlignmentGrid::businessDays(const Calendar& calendar,
+                                            const Date& from,
+                                            const Date& to) {
+    MF_REQUIRE(from <= to, "'from' date (" << from
+               << ") must not be later than 'to' date (" << to << ")");
+    std::vector<Date::serial_type> dates;
+    for (Date::serial_type d = from.serialNumber(); d <= to.serialNumber();
+         ++d) {
+      if (calendar.isBusinessDayUnchecked(Date::unchecked(d))) {
+        dates.push_back(d);
+      }
+    }
+    return AlignmentGrid(dates);
+  }
+
+  AlignmentGrid AlignmentGrid::weekly(const Calendar& calendar,
+                                      const Date& from,
+                                      const Date& to) {
+    MF_REQUIRE(from <= to, "'from' date (" << from
+               << ") must not be later than 'to' date (" << to << ")");
+    std::vector<Date::serial_type> dates;
+    Date::serial_type latest = 0;
+    for (Date::serial_type d = from.serialNumber(); d <= to.serialNumber();
+         ++d) {
+      if (calendar.isBusinessDayUnchecked(Date::unchecked(d))) {
+        latest = d;
+      }
+      // Sunday closes the week
+      if (latest != 0 && (detail::weekdayFromSerial(d) == 1
+                          || d == to.serialNumber())) {
+        dates.push_back(latest);
+        latest = 0;
+      }
+    }
+    return AlignmentGrid(dates);
+  }
+
+  AlignmentGrid AlignmentGrid::monthly(const Calendar& calendar,
+                                       const Date& from,
+                                       const Date& to) {
+    MF_REQUIRE(from <= to, "'from' date (" << from
+               << ") must not be later than 'to' date (" << to << ")");
+    std::vector<Date::serial_type> dates;
+    Integer y, m, d;
+    detail::civilFromSerial(from.serialNumber(), y, m, d);
+    for (;;) {
+      const Date::serial_type monthEnd = Date::serial_type(
+        detail::serialFromCivil(y, m, detail::daysInMonth(y, m)));
+      const Date::serial_type end = calendar.endOfMonth(
+        Date::unchecked(monthEnd)).serialNumber();
+      if (end > to.serialNumber()) {
+        break;
+      }
+      if (end >= from.serialNumber()) {
+        dates.push_back(end);
+      }
+      if (monthEnd >= to.serialNumber()) {
+        break;
+      }
+      if (++m > 12) {
+        m = 1;
+        ++y;
+      }
+    }
+    return AlignmentGrid(dates);
+  }
+
+  void AlignmentGrid::align(const Date::serial_type* dates,
+                            const Real* values,
+                            Size n,
+                            AlignmentFill fill,
+                            Real* result) const {
+    const Size size = dates_.size();
+    const bool forward = fill == AlignmentFill::Forward;
+    Real current = missing;
+    Size k = 0;
+    for (Size i = 0; i < size; ++i) {
+      const Date::serial_type g = dates_[i];
+      while (k < n && dates[k] < g) {
+        current = values[k++];
+      }
+      if (k < n && dates[k] == g) {
+        current = values[k++];
+        result[i] = current;
+      } else {
+        result[i] = forward ? current : missing;
+      }
+    }
+  }
+
+  void AlignmentGrid::align(const TimeSeriesView* series,
+                            Size n,
+                            AlignmentFill fill,
+                            Real* result,
+                            ThreadPool* pool) const {
+    MF_TRACE_SPAN("AlignmentGrid::align", "timeseries");
+    const Size size = dates_.size();
+    if (size == 0) {
+      return;
+    }
+    const Date first = Date::unchecked(dates_.front());
+    const Date last = Date::unchecked(dates_.back());
+    parallelFor(pool, 0, n, 1, [&](Size lo, Size hi) {
+        std::vector<Date::serial_type> dates;
+        std::vector<Real> values;
+        for (Size j = lo; j < hi; ++j) {
+          dates.clear();
+          values.clear();
+          // the observation filling the grid until the series starts
+          Date::serial_type latest;
+          Real value;
+          if (fill == AlignmentFill::Forward
+              && series[j].findLatest(first, latest, value)
+              && latest < first.serialNumber()) {
+            dates.push_back(latest);
+            values.push_back(value);
+          }
+          series[j].scan(first, last, dates, values);
+          align(dates.empty() ? 0 : &dates[0],
+                values.empty() ? 0 : &values[0],
+                dates.size(), fill, result + j * size);
+        }
+      });
+  }
+
+  void AlignmentGrid::align(const std::vector<TimeSeriesView>& series,
+                            AlignmentFill fill,
+                            std::vector<Real>& result,
+                            ThreadPool* pool) const {
+    result.resize(series.size() * dates_.size());
+    if (!result.empty()) {
+      align(&series[0], series.size(), fill, &result[0], pool);
+    }
+  }
+
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file alignment.hpp
+ * @brief alignment of time series on a common calendar grid
+ */
+
+#ifndef MATHFIN_ALIGNMENT_HPP
+#define MATHFIN_ALIGNMENT_HPP
+
+#include <time/calendar.hpp>
+#include <time/timeseries.hpp>
+
+#include <vector>
+
+namespace MathFin {
+
+  class ThreadPool;
+
+  /**
+   * Value given to a grid date by an aligned series.
+   */
+  enum class AlignmentFill {
+    Exact,   //!< the observation at the grid date, NaN if there is none
+    Forward  //!< the latest observation on or before the grid date, NaN
+             //!< before the first observation
+  };
+
+  /**
+   * Increasing dates on which time series are aligned.
+   *
+   * The grid is built once, typically from a calendar, and each series
+   * is mapped onto it in a single merge of its observations with the
+   * grid dates.  Observations off the grid (on holidays, for instance)
+   * are dropped, or carried to the following grid date when filling
+   * forward; on a weekly or monthly grid filling forward gives the last
+   * observation of each period.
+   *
+   * Aligned series are written as columns of a single array: the value
+   * of series <tt>j</tt> at grid date <tt>i</tt> is at position
+   * <tt>j * size() + i</tt>.
+   *
+   * @ingroup datetime
+   */
+  class AlignmentGrid {
+  public:
+    /**
+     * Grid of the given increasing serial numbers.
+     */
+    explicit AlignmentGrid(const std::vector<Date::serial_type>& dates);
+
+    /**
+     * The business days of the calendar between <tt>from</tt> and
+     * <tt>to</tt>, both included.
+     */
+    static AlignmentGrid businessDays(const Calendar& calendar,
+                                      const Date& from,
+                                      const Date& to);
+
+    /**
+     * The last business day of each week, from Monday to Sunday, between
+     * <tt>from</tt> and <tt>to</tt>; a week cut by <tt>to</tt> gives its
+     * last business day until then.
+     */
+    static AlignmentGrid weekly(const Calendar& calendar,
+                                const Date& from,
+                                const Date& to);
+
+    /**
+     * The last business day of each month, as given by
+     * Calendar::endOfMonth(), between <tt>from</tt> and <tt>to</tt>.
+     */
+    static AlignmentGrid monthly(const Calendar& calendar,
+                                 const Date& from,
+                                 const Date& to);
+
+    Size size() const { return dates_.size(); }
+    bool empty() const { return dates_.empty(); }
+    Date operator[](Size i) const { return Date::unchecked(dates_[i]); }
+    const std::vector<Date::serial_type>& serialNumbers() const {
+      return dates_;
+    }
+
+    /**
+     * Aligns <tt>n</tt> observations with increasing dates into the
+     * size() values at <tt>result</tt>.
+     */
+    void align(const Date::serial_type* dates,
+               const Real* values,
+               Size n,
+               AlignmentFill fill,
+               Real* result) const;
+
+    /**
+     * Aligns <tt>n</tt> series into as many columns at <tt>result</tt>;
+     * when a thread pool is given the series are aligned in parallel.
+     */
+    void align(const TimeSeriesView* series,
+               Size n,
+               AlignmentFill fill,
+               Real* result,
+               ThreadPool* pool = 0) const;
+
+    /**
+     * Aligns the series into <tt>result</tt>, which is resized as needed.
+     */
+    void align(const std::vector<TimeSeriesView>& series,
+               AlignmentFill fill,
+               std::vector<Real>& result,
+               ThreadPool* pool = 0) const;
+
+  private:
+    std::vector<Date::serial_type> dates_;
+  };
+
+}
+
+#endif /* MATHFIN_ALIGNMENT_HPP */
@@ -0,0 +1,192 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include <base/threadpool.hpp>
+#include <test/catch.hpp>
+#include <time/alignment.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/calendars/unitedstates.hpp>
+
+using namespace MathFin;
+
+namespace {
+
+  // NaN compares equal to NaN
+  bool same(Real x, Real y) {
+    return x == y || (std::isnan(x) && std::isnan(y));
+  }
+
+  Real expectedValue(const std::map<Date::serial_type, Real>& history,
+                     Date::serial_type d,
+                     AlignmentFill fill) {
+    std::map<Date::serial_type, Real>::const_iterator i =
+      history.upper_bound(d);
+    if (i == history.begin()) {
+      return std::nan("");
+    }
+    --i;
+    if (fill == AlignmentFill::Exact && i->first != d) {
+      return std::nan("");
+    }
+    return i->second;
+  }
+
+}
+
+TEST_CASE("Alignment grids follow the calendar", "[alignment]") {
+  const Calendar calendar = UnitedKingdom();
+  const Date from(3, Month::January, 2016);
+  const Date to(17, Month::November, 2017);
+
+  const AlignmentGrid daily = AlignmentGrid::businessDays(calendar, from, to);
+  std::vector<Date::serial_type> expected;
+  for (Date::serial_type d = from.serialNumber(); d <= to.serialNumber();
+       ++d) {
+    if (calendar.isBusinessDay(Date(d))) {
+      expected.push_back(d);
+    }
+  }
+  REQUIRE(daily.serialNumbers() == expected);
+
+  // the next business day of a weekly date falls in another week
+  const AlignmentGrid weekly = AlignmentGrid::weekly(calendar, from, to);
+  REQUIRE(weekly.size() == 98);
+  REQUIRE(weekly[0] == Date(8, Month::January, 2016));
+  REQUIRE(weekly[weekly.size() - 1] == to);
+  for (Size i = 0; i + 1 < weekly.size(); ++i) {
+    REQUIRE(calendar.isBusinessDay(weekly[i]));
+    const Date next = calendar.advance(weekly[i], 1, TimeUnit::Days);
+    const Date sunday = weekly[i] + (8 - Integer(weekly[i].weekday())) % 7;
+    REQUIRE(next > sunday);
+    REQUIRE(weekly[i + 1] <= sunday + 7);
+  }
+
+  const AlignmentGrid monthly = AlignmentGrid::monthly(calendar, from, to);
+  REQUIRE(monthly.size() == 22);
+  for (Size i = 0; i < monthly.size(); ++i) {
+    REQUIRE(monthly[i] == calendar.endOfMonth(monthly[i]));
+  }
+  REQUIRE(monthly[2] == Date(31, Month::March, 2016));
+  // Good Friday before a weekend ending the month
+  const AlignmentGrid easter = AlignmentGrid::monthly(
+    calendar, Date(1, Month::March, 2013), Date(30, Month::April, 2013));
+  REQUIRE(easter.size() == 2);
+  REQUIRE(easter[0] == Date(28, Month::March, 2013));
+
+  std::vector<Date::serial_type> decreasing(2, from.serialNumber());
+  REQUIRE_THROWS_AS(AlignmentGrid grid(decreasing), Error);
+}
+
+TEST_CASE("Series are aligned on the grid", "[alignment]") {
+  const AlignmentGrid grid = AlignmentGrid::businessDays(
+    TARGET(), Date(21, Month::December, 2016), Date(3, Month::January, 2017));
+  // 21, 22, 23, 27, 28, 29, 30 December and 2, 3 January
+  REQUIRE(grid.size() == 9);
+
+  // observations before the grid, on a holiday and on grid dates
+  const Date::serial_type dates[] = {
+    Date(20, Month::December, 2016).serialNumber(),
+    Date(22, Month::December, 2016).serialNumber(),
+    Date(26, Month::December, 2016).serialNumber(),
+    Date(30, Month::December, 2016).serialNumber(),
+    Date(3, Month::January, 2017).serialNumber()
+  };
+  const Real values[] = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+  const Real nan = std::nan("");
+
+  std::vector<Real> exact(grid.size()), forward(grid.size());
+  grid.align(dates, values, 5, AlignmentFill::Exact, &exact[0]);
+  grid.align(dates, values, 5, AlignmentFill::Forward, &forward[0]);
+  const Real expectedExact[] = { nan, 2.0, nan, nan, nan, nan, 4.0, nan, 5.0 };
+  const Real expectedForward[] = { 1.0, 2.0, 2.0, 3.0, 3.0, 3.0, 4.0, 4.0,
+                                   5.0 };
+  for (Size i = 0; i < grid.size(); ++i) {
+    REQUIRE(same(exact[i], expectedExact[i]));
+    REQUIRE(same(forward[i], expectedForward[i]));
+  }
+
+  // nothing to fill from before the first observation
+  grid.align(dates + 1, values + 1, 4, AlignmentFill::Forward, &forward[0]);
+  REQUIRE(std::isnan(forward[0]));
+  REQUIRE(forward[1] == 2.0);
+}
+
+TEST_CASE("Stored series are aligned in parallel", "[alignment]") {
+  const Calendar calendars[] = {
+    TARGET(), UnitedKingdom(), UnitedStates::NYSE() };
+  std::vector<std::map<Date::serial_type, Real> > histories;
+  std::vector<TimeSeries> series;
+  boost::uint32_t state = 2017;
+  for (Size j = 0; j < 12; ++j) {
+    const Calendar& calendar = calendars[j % 3];
+    std::map<Date::serial_type, Real> history;
+    TimeSeries s(calendar);
+    // series starting at different dates, some with gaps
+    for (Date::serial_type d = Date(1, Month::March, 2010).serialNumber()
+           + Date::serial_type(90 * j);
+         d <= Date(30, Month::June, 2018).serialNumber(); ++d) {
+      state = state * 1664525u + 1013904223u;
+      if (calendar.isBusinessDay(Date(d)) && state % 16 != 0) {
+        history[d] = Real(state >> 12);
+        s.append(Date(d), history[d]);
+      }
+    }
+    histories.push_back(history);
+    series.push_back(s);
+  }
+  std::vector<TimeSeriesView> views;
+  for (Size j = 0; j < series.size(); ++j) {
+    views.push_back(series[j].view());
+  }
+
+  const Date from(1, Month::January, 2011);
+  const Date to(31, Month::December, 2017);
+  const AlignmentGrid grids[] = {
+    AlignmentGrid::businessDays(TARGET(), from, to),
+    AlignmentGrid::weekly(UnitedKingdom(), from, to),
+    AlignmentGrid::monthly(UnitedStates::NYSE(), from, to)
+  };
+  const AlignmentFill fills[] = {
+    AlignmentFill::Exact, AlignmentFill::Forward };
+
+  ThreadPool pool(3);
+  for (Size g = 0; g < 3; ++g) {
+    const AlignmentGrid& grid = grids[g];
+    for (Size f = 0; f < 2; ++f) {
+      std::vector<Real> sequential, parallel;
+      grid.align(views, fills[f], sequential);
+      grid.align(views, fills[f], parallel, &pool);
+      REQUIRE(sequential.size() == views.size() * grid.size());
+      for (Size j = 0; j < views.size(); ++j) {
+        for (Size i = 0; i < grid.size(); ++i) {
+          const Size k = j * grid.size() + i;
+          const Real expected = expectedValue(
+            histories[j], grid.serialNumbers()[i], fills[f]);
+          REQUIRE(same(sequential[k], expected));
+          REQUIRE(same(parallel[k], expected));
+        }
+      }
+    }
+  }
+}
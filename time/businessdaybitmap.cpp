@@ -0,0 +1,119 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/businessdaybitmap.hpp>
+#include <time/datekernels.hpp>
+
+#include <algorithm>
+
+namespace MathFin {
+
+  BusinessDayBitmap::BusinessDayBitmap(const Calendar& calendar)
+    : BusinessDayBitmap(calendar,
+                        Date(Date::minDate().serialNumber()),
+                        Date(Date::maxDate().serialNumber())) {}
+
+  BusinessDayBitmap::BusinessDayBitmap(
+    const Calendar& calendar,
+    const Date& from,
+    const Date& to
+    ) : calendar_(calendar), first_(from.serialNumber()),
+        last_(to.serialNumber()) {
+    MF_REQUIRE(!calendar.empty(), "no calendar provided");
+    MF_REQUIRE(from <= to, "'from' date ("
+               << from << ") must not be later than 'to' date ("
+               << to << ")");
+
+    MF_TRACE_SPAN("BusinessDayBitmap::BusinessDayBitmap", "calendar");
+    const Size n = Size(last_ - first_ + 1);
+    words_.assign((n + 63) / 64, 0);
+    for (Size i = 0; i < n; ++i) {
+      if (calendar.isBusinessDayUnchecked(
+            Date::unchecked(first_ + Date::serial_type(i)))) {
+        words_[i / 64] |= boost::uint64_t(1) << (i % 64);
+      }
+    }
+  }
+
+  void BusinessDayBitmap::check(Date::serial_type serialNumber) const {
+    MF_REQUIRE(serialNumber >= first_ && serialNumber <= last_,
+               "serial number (" << serialNumber << ") outside bitmap range ["
+               << first_ << ", " << last_ << "]");
+  }
+
+  Date::serial_type BusinessDayBitmap::businessDaysBetween(
+    Date::serial_type from,
+    Date::serial_type to,
+    bool includeFirst,
+    bool includeLast
+    ) const {
+    check(from);
+    check(to);
+    if (from == to) {
+      return 0;
+    }
+    const Date::serial_type lo = std::min(from, to) - first_;
+    const Date::serial_type hi = std::max(from, to) - first_;
+    Date::serial_type wd = Date::serial_type(
+      kernels::countBits(&words_[0], Size(lo), Size(hi) + 1));
+    if (!includeFirst && isBusinessDay(from)) {
+      --wd;
+    }
+    if (!includeLast && isBusinessDay(to)) {
+      --wd;
+    }
+    return from > to ? -wd : wd;
+  }
+
+  void BusinessDayBitmap::businessDaysBetween(const Date::serial_type* from,
+                                              const Date::serial_type* to,
+                                              Size n,
+                                              Date::serial_type* result,
+                                              bool includeFirst,
+                                              bool includeLast) const {
+    MF_TRACE_SPAN("BusinessDayBitmap::businessDaysBetween[batch]", "calendar");
+    for (Size i = 0; i < n; ++i) {
+      result[i] = businessDaysBetween(from[i], to[i], includeFirst, includeLast);
+    }
+  }
+
+  Date::serial_type BusinessDayBitmap::following(
+    Date::serial_type serialNumber) const {
+    check(serialNumber);
+    const Size size = Size(last_ - first_ + 1);
+    const Size i =
+      kernels::nextSetBit(&words_[0], Size(serialNumber - first_), size);
+    MF_REQUIRE(i < size, "no business day on or after serial number "
+               << serialNumber << " within the bitmap");
+    return first_ + Date::serial_type(i);
+  }
+
+  Date::serial_type BusinessDayBitmap::preceding(
+    Date::serial_type serialNumber) const {
+    check(serialNumber);
+    const Size i =
+      kernels::previousSetBit(&words_[0], Size(serialNumber - first_));
+    MF_REQUIRE(i != Size(-1), "no business day on or before serial number "
+               << serialNumber << " within the bitmap");
+    return first_ + Date::serial_type(i);
+  }
+
+}
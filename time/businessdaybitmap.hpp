@@ -0,0 +1,109 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file businessdaybitmap.hpp
+ * @brief precomputed business days of a calendar
+ */
+
+#ifndef MATHFIN_BUSINESSDAYBITMAP_HPP
+#define MATHFIN_BUSINESSDAYBITMAP_HPP
+
+#include <time/calendar.hpp>
+
+#include <boost/cstdint.hpp>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * One bit per day telling whether it is a business day for a calendar.
+   *
+   * Business-day counts become population counts over the bitmap and
+   * adjustments become bit scans; both use the kernels selected for the
+   * processor (see datekernels.hpp).  The bitmap is a snapshot: holidays
+   * added to the calendar afterwards are not reflected.
+   *
+   * @ingroup datetime
+   */
+  class BusinessDayBitmap {
+  public:
+    /**
+     * Bitmap over the whole range of valid dates.
+     */
+    explicit BusinessDayBitmap(const Calendar& calendar);
+
+    /**
+     * Bitmap over the dates between <tt>from</tt> and <tt>to</tt>, both
+     * included.
+     */
+    BusinessDayBitmap(const Calendar& calendar, const Date& from, const Date& to);
+
+    const Calendar& calendar() const { return calendar_; }
+    Date::serial_type firstSerialNumber() const { return first_; }
+    Date::serial_type lastSerialNumber() const { return last_; }
+
+    /**
+     * Whether the date is a business day; the serial number must lie
+     * within the bitmap.
+     */
+    bool isBusinessDay(Date::serial_type serialNumber) const {
+      const Size i = Size(serialNumber - first_);
+      return (words_[i / 64] >> (i % 64)) & 1;
+    }
+
+    /**
+     * As Calendar::businessDaysBetween().
+     */
+    Date::serial_type businessDaysBetween(Date::serial_type from,
+                                          Date::serial_type to,
+                                          bool includeFirst = true,
+                                          bool includeLast = false) const;
+
+    /**
+     * As Calendar::businessDaysBetween(), over arrays of serial numbers.
+     */
+    void businessDaysBetween(const Date::serial_type* from,
+                             const Date::serial_type* to,
+                             Size n,
+                             Date::serial_type* result,
+                             bool includeFirst = true,
+                             bool includeLast = false) const;
+
+    /**
+     * First business day on or after the given date.
+     */
+    Date::serial_type following(Date::serial_type serialNumber) const;
+
+    /**
+     * Last business day on or before the given date.
+     */
+    Date::serial_type preceding(Date::serial_type serialNumber) const;
+
+  private:
+    void check(Date::serial_type serialNumber) const;
+
+    Calendar calendar_;
+    Date::serial_type first_, last_;
+    std::vector<boost::uint64_t> words_;
+  };
+
+}
+
+#endif /* MATHFIN_BUSINESSDAYBITMAP_HPP */
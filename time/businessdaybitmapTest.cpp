@@ -0,0 +1,77 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <test/catch.hpp>
+#include <base/cpu.hpp>
+#include <base/error.hpp>
+#include <time/businessdaybitmap.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedstates.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Bitmap matches calendar", "[businessdaybitmap]") {
+  Calendar calendar = UnitedStates::NYSE();
+  Date from(1, Month::January, 2000), to(31, Month::December, 2030);
+  BusinessDayBitmap bitmap(calendar, from, to);
+
+  for (Date::serial_type i = from.serialNumber(); i <= to.serialNumber(); ++i) {
+    REQUIRE(bitmap.isBusinessDay(i) == calendar.isBusinessDay(Date(i)));
+  }
+
+  for (int tier = 0; tier <= as_integer(detectedCpuTier()); ++tier) {
+    ScopedCpuTier forced((CpuTier(tier)));
+    for (Date::serial_type i = from.serialNumber();
+         i <= to.serialNumber(); i += 211) {
+      for (Date::serial_type j = i - 900; j <= i + 900; j += 97) {
+        if (j < from.serialNumber() || j > to.serialNumber()) {
+          continue;
+        }
+        for (int flags = 0; flags < 4; ++flags) {
+          const bool includeFirst = flags & 1, includeLast = flags & 2;
+          REQUIRE(bitmap.businessDaysBetween(i, j, includeFirst, includeLast)
+                  == calendar.businessDaysBetween(Date(i), Date(j),
+                                                  includeFirst, includeLast));
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Bitmap adjustment", "[businessdaybitmap]") {
+  Calendar calendar = TARGET();
+  BusinessDayBitmap bitmap(calendar);
+  REQUIRE(bitmap.firstSerialNumber() == Date::minDate().serialNumber());
+
+  for (Date::serial_type i = Date(1, Month::January, 2016).serialNumber();
+       i <= Date(31, Month::December, 2017).serialNumber(); ++i) {
+    REQUIRE(Date(bitmap.following(i))
+            == calendar.adjust(Date(i), BusinessDayConvention::Following));
+    REQUIRE(Date(bitmap.preceding(i))
+            == calendar.adjust(Date(i), BusinessDayConvention::Preceding));
+  }
+
+  BusinessDayBitmap window(calendar, Date(24, Month::December, 2016),
+                           Date(26, Month::December, 2016));
+  REQUIRE_THROWS_AS(window.following(Date(24, Month::December, 2016)
+                                     .serialNumber()), Error);
+  REQUIRE_THROWS_AS(window.preceding(Date(26, Month::December, 2016)
+                                     .serialNumber()), Error);
+  REQUIRE_THROWS_AS(window.following(0), Error);
+}
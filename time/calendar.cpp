@@ -38,12 +38,18 @@
 */
 
 #include <base/error.hpp>
+#include <base/threadpool.hpp>
 #include <time/calendar.hpp>
 
 using boost::posix_time::ptime;
 
 namespace MathFin {
 
+  namespace {
+    // dates per parallel chunk
+    const Size batchGrain = 1024;
+  }
+
   Calendar Calendar::addHoliday(const Date& d) const {
     MF_REQUIRE(impl_, "no implementation provided");
     std::set<Date> addedHolidays(addedHolidays_);
@@ -60,6 +66,28 @@ namespace MathFin {
     return Calendar(impl_, addedHolidays, removedHolidays);
   }
 
+  Calendar Calendar::amend(const std::vector<Date>& added,
+                           const std::vector<Date>& removed) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    std::set<Date> addedHolidays(addedHolidays_);
+    std::set<Date> removedHolidays(removedHolidays_);
+
+    for (Size i = 0; i < added.size(); ++i) {
+      removedHolidays.erase(added[i]);
+      if (impl_->isBusinessDay(added[i])) {
+        addedHolidays.insert(added[i]);
+      }
+    }
+    for (Size i = 0; i < removed.size(); ++i) {
+      addedHolidays.erase(removed[i]);
+      if (!impl_->isBusinessDay(removed[i])) {
+        removedHolidays.insert(removed[i]);
+      }
+    }
+
+    return Calendar(impl_, addedHolidays, removedHolidays);
+  }
+
   Calendar Calendar::removeHoliday(const Date& d) const {
     MF_REQUIRE(impl_, "no implementation provided");
     std::set<Date> addedHolidays(addedHolidays_);
@@ -80,6 +108,9 @@ namespace MathFin {
     const Date& d,
     BusinessDayConvention c) const {
     MF_REQUIRE(d != Date(), "null date");
+    // empty calendars are only rejected further down
+    MF_COUNT_FOR(CalendarAdjustments, impl_ ? typeid(*impl_) : typeid(void));
+    MF_TIME_FOR(CalendarAdjust, impl_ ? typeid(*impl_) : typeid(void));
 
     if (c == BusinessDayConvention::Unadjusted) {
       return d;
@@ -154,6 +185,8 @@ namespace MathFin {
     bool endOfMonth
     ) const {
     MF_REQUIRE(d != Date(), "null date");
+    MF_COUNT_FOR(CalendarAdvances, impl_ ? typeid(*impl_) : typeid(void));
+    MF_TIME_FOR(CalendarAdvance, impl_ ? typeid(*impl_) : typeid(void));
 
     if (n == 0) {
       return adjust(d, c);
@@ -206,6 +239,8 @@ namespace MathFin {
     bool includeFirst,
     bool includeLast
     ) const {
+    MF_COUNT_FOR(CalendarBusinessDaysBetween, impl_ ? typeid(*impl_) : typeid(void));
+    MF_TIME_FOR(CalendarBusinessDaysBetween, impl_ ? typeid(*impl_) : typeid(void));
     Date::serial_type wd = 0;
     if (from != to) {
       if (from < to) {
@@ -253,6 +288,42 @@ namespace MathFin {
   }
 
 
+  void Calendar::adjust(
+    const Date::serial_type* dates,
+    Size n,
+    Date::serial_type* result,
+    BusinessDayConvention convention,
+    ThreadPool* pool
+    ) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    MF_TRACE_SPAN("Calendar::adjust[batch]", "calendar");
+    parallelFor(pool, 0, n, batchGrain, [&](Size lo, Size hi) {
+        for (Size i = lo; i < hi; ++i) {
+          result[i] = adjust(Date(dates[i]), convention).serialNumber();
+        }
+      });
+  }
+
+  void Calendar::businessDaysBetween(
+    const Date::serial_type* from,
+    const Date::serial_type* to,
+    Size n,
+    Date::serial_type* result,
+    bool includeFirst,
+    bool includeLast,
+    ThreadPool* pool
+    ) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    MF_TRACE_SPAN("Calendar::businessDaysBetween[batch]", "calendar");
+    parallelFor(pool, 0, n, batchGrain, [&](Size lo, Size hi) {
+        for (Size i = lo; i < hi; ++i) {
+          result[i] = businessDaysBetween(Date(from[i]), Date(to[i]),
+                                          includeFirst, includeLast);
+        }
+      });
+  }
+
+
   // Western calendars
 
   bool Calendar::WesternImpl::isWeekend(Weekday w) const {
@@ -343,21 +414,8 @@ namespace MathFin {
     const Date& to,
     bool includeWeekEnds
     ) {
-
-    MF_REQUIRE(to > from, "'from' date ("
-               << from << ") must be earlier than 'to' date ("
-               << to << ")");
     std::vector<Date> result;
-
-    for (ptime pt = from.dateTime(); pt <= to.dateTime();
-         pt += boost::gregorian::days(1)) {
-      Date d = Date(pt);
-      if (calendar.isHoliday(d) &&
-          (includeWeekEnds || !calendar.isWeekend(d.weekday()))) {
-        result.push_back(d);
-      }
-    }
-
+    holidayList(calendar, from, to, result, includeWeekEnds);
     return result;
   }
 
@@ -41,6 +41,8 @@
 #define MATHFIN_CALENDAR_HPP
 
 #include <base/error.hpp>
+#include <base/stats.hpp>
+#include <base/trace.hpp>
 #include <time/date.hpp>
 #include <time/businessdayconvention.hpp>
 
@@ -48,10 +50,12 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <typeinfo>
 
 namespace MathFin {
 
   class Period;
+  class ThreadPool;
 
   /**
    * calendar class
@@ -158,6 +162,7 @@ namespace MathFin {
      */
     inline bool isBusinessDay(const Date& d) const {
       MF_REQUIRE(impl_, "no implementation provided");
+      MF_COUNT_FOR(CalendarBusinessDayChecks, typeid(*impl_));
       if (addedHolidays_.find(d) != addedHolidays_.end()) {
         return false;
       }
@@ -167,6 +172,24 @@ namespace MathFin {
       return impl_->isBusinessDay(d);
     }
 
+    /**
+     * As isBusinessDay(), without checking for an implementation; meant for
+     * inner loops over pre-validated input.
+     * @warning the calendar must not be empty().
+     */
+    inline bool isBusinessDayUnchecked(const Date& d) const {
+      MF_COUNT_FOR(CalendarBusinessDayChecks, typeid(*impl_));
+      if (!addedHolidays_.empty()
+          && addedHolidays_.find(d) != addedHolidays_.end()) {
+        return false;
+      }
+      if (!removedHolidays_.empty()
+          && removedHolidays_.find(d) != removedHolidays_.end()) {
+        return true;
+      }
+      return impl_->isBusinessDay(d);
+    }
+
     /**
      * Returns <tt>true</tt> iff the date is a business day for the
      * given market.
@@ -229,6 +252,25 @@ namespace MathFin {
      */
     Calendar removeHoliday(const Date&) const;
 
+    /**
+     * Returns a new calendar with the given dates added to the holidays
+     * and then the given dates removed from them, as repeated calls to
+     * addHoliday() and removeHoliday() would but copying the holiday sets
+     * only once.
+     */
+    Calendar amend(const std::vector<Date>& added,
+                   const std::vector<Date>& removed) const;
+
+    /**
+     * Dates added to the holidays of the underlying market.
+     */
+    const std::set<Date>& addedHolidays() const { return addedHolidays_; }
+
+    /**
+     * Dates removed from the holidays of the underlying market.
+     */
+    const std::set<Date>& removedHolidays() const { return removedHolidays_; }
+
     /**
      * Adjusts a non-business day to the appropriate near business day
      * with respect to the given convention.
@@ -279,9 +321,75 @@ namespace MathFin {
       const Date& to,
       bool includeWeekEnds = false);
 
+    /**
+     * Appends the holidays between two dates to <tt>result</tt>, which can
+     * be any container of dates with <tt>push_back</tt>; for instance a
+     * <tt>std::vector</tt> drawing from an Arena through an ArenaAllocator.
+     */
+    template <class Container>
+    static void holidayList(
+      const Calendar& calendar,
+      const Date& from,
+      const Date& to,
+      Container& result,
+      bool includeWeekEnds = false);
+
+    /** @} */
+
+    // -------------------------------------------------------------------------
+
+    /**
+     * @name batch operations
+     * The following methods work on arrays of serial numbers.  When a
+     * thread pool is given the arrays are processed in parallel, otherwise
+     * on the calling thread.
+     * @{
+     */
+
+    /**
+     * Adjusts <tt>n</tt> dates according to the given convention.
+     */
+    void adjust(
+      const Date::serial_type* dates,
+      Size n,
+      Date::serial_type* result,
+      BusinessDayConvention convention = BusinessDayConvention::Following,
+      ThreadPool* pool = 0) const;
+
+    /**
+     * Adjusts <tt>n</tt> dates into <tt>result</tt>, which is resized as
+     * needed; its allocator can be an ArenaAllocator.
+     */
+    template <class Allocator>
+    void adjust(
+      const Date::serial_type* dates,
+      Size n,
+      std::vector<Date::serial_type, Allocator>& result,
+      BusinessDayConvention convention = BusinessDayConvention::Following,
+      ThreadPool* pool = 0) const {
+      result.resize(n);
+      if (n > 0) {
+        adjust(dates, n, &result[0], convention, pool);
+      }
+    }
+
+    /**
+     * Business days between <tt>n</tt> pairs of dates.
+     */
+    void businessDaysBetween(
+      const Date::serial_type* from,
+      const Date::serial_type* to,
+      Size n,
+      Date::serial_type* result,
+      bool includeFirst = true,
+      bool includeLast = false,
+      ThreadPool* pool = 0) const;
+
     /** @} */
 
   private:
+    friend bool operator==(const Calendar&, const Calendar&);
+
     const std::set<Date> addedHolidays_;
     const std::set<Date> removedHolidays_;
 
@@ -295,14 +403,43 @@ namespace MathFin {
       {}
   };
 
+  // ---------------------------------------------------------------------------
+
+  template <class Container>
+  void Calendar::holidayList(
+    const Calendar& calendar,
+    const Date& from,
+    const Date& to,
+    Container& result,
+    bool includeWeekEnds
+    ) {
+    MF_REQUIRE(to > from, "'from' date ("
+               << from << ") must be earlier than 'to' date ("
+               << to << ")");
+    MF_TRACE_SPAN("Calendar::holidayList", "calendar");
+    const Date::serial_type last = to.serialNumber();
+    for (Date::serial_type i = from.serialNumber(); i <= last; ++i) {
+      const Date d = Date::unchecked(i);
+      if (calendar.isHoliday(d) &&
+          (includeWeekEnds || !calendar.isWeekend(d.weekday()))) {
+        result.push_back(d);
+      }
+    }
+  }
+
   /**
    * Returns <tt>true</tt> iff the two calendars belong to the same
    * derived class.
    * @relates Calendar
   */
   inline bool operator==(const Calendar& c1, const Calendar& c2) {
-    return (c1.empty() && c2.empty())
-      || (!c1.empty() && !c2.empty() && c1.name() == c2.name());
+    if (c1.impl_ == c2.impl_) {
+      return true;
+    }
+    // names are only built when the implementations are of the same class
+    return !c1.empty() && !c2.empty()
+      && typeid(*c1.impl_) == typeid(*c2.impl_)
+      && c1.name() == c2.name();
   }
 
   /**
@@ -18,8 +18,11 @@
 */
 
 #include <iostream>
+#include <vector>
 #include <test/catch.hpp>
 #include <base/error.hpp>
+#include <base/stats.hpp>
+#include <base/threadpool.hpp>
 #include <time/calendar.hpp>
 #include <time/calendars/unitedkingdom.hpp>
 #include <time/calendars/unitedstates.hpp>
@@ -71,3 +74,65 @@ TEST_CASE("Null Calendar" "[calendar]") {
   REQUIRE(cal.isHoliday(d) == false);
   REQUIRE(cal.isWeekend(Weekday::Sunday) == false);
 }
+
+TEST_CASE("Unchecked business day", "[calendar]") {
+  Calendar cal = UnitedStates::NYSE();
+  for (Date::serial_type i = Date(1, Month::January, 2017).serialNumber();
+       i <= Date(31, Month::December, 2018).serialNumber(); ++i) {
+    Date d(i);
+    REQUIRE(cal.isBusinessDayUnchecked(d) == cal.isBusinessDay(d));
+  }
+}
+
+TEST_CASE("Batch adjustment and business day counts", "[calendar]") {
+  Calendar cal = UnitedKingdom::Settlement();
+  std::vector<Date::serial_type> from, to;
+  for (Date::serial_type i = Date(1, Month::January, 2000).serialNumber();
+       i < Date(1, Month::January, 2010).serialNumber(); ++i) {
+    from.push_back(i);
+    to.push_back(i + (i % 97) - 40);
+  }
+  const Size n = from.size();
+
+  ThreadPool pool(3);
+  std::vector<Date::serial_type> adjusted(n), count(n);
+  cal.adjust(&from[0], n, &adjusted[0],
+             BusinessDayConvention::ModifiedFollowing, &pool);
+  cal.businessDaysBetween(&from[0], &to[0], n, &count[0], false, true, &pool);
+  for (Size i = 0; i < n; ++i) {
+    REQUIRE(adjusted[i] ==
+            cal.adjust(Date(from[i]),
+                       BusinessDayConvention::ModifiedFollowing).serialNumber());
+    REQUIRE(count[i] ==
+            cal.businessDaysBetween(Date(from[i]), Date(to[i]), false, true));
+  }
+
+  std::vector<Date::serial_type> sequential(n);
+  cal.adjust(&from[0], n, &sequential[0],
+             BusinessDayConvention::ModifiedFollowing);
+  REQUIRE(sequential == adjusted);
+}
+
+TEST_CASE("Calendar calls are counted per calendar", "[calendar][stats]") {
+  const StatsSnapshot before = Stats::snapshot();
+  const Calendar nyse = UnitedStates::NYSE();
+  const Calendar uk = UnitedKingdom();
+  const Date d(17, Month::June, 2017);
+  nyse.adjust(d);
+  nyse.advance(d, 2, TimeUnit::Days);
+  uk.isBusinessDay(d);
+
+  const StatsSnapshot delta = Stats::snapshot() - before;
+  if (!Stats::enabled()) {
+    REQUIRE(delta.implementations().empty());
+    return;
+  }
+  REQUIRE(delta.count(Counter::CalendarAdjustments, "UnitedStates::Nyse") == 1);
+  REQUIRE(delta.count(Counter::CalendarAdvances, "UnitedStates::Nyse") == 1);
+  REQUIRE(delta.histogram(Timer::CalendarAdvance, "UnitedStates::Nyse")
+          .count() == 1);
+  REQUIRE(delta.count(Counter::CalendarBusinessDayChecks,
+                      "UnitedKingdom::Settlement") == 1);
+  REQUIRE(delta.count(Counter::CalendarAdjustments,
+                      "UnitedKingdom::Settlement") == 0);
+}
@@ -0,0 +1,46 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <time/calendars/australia.hpp>
+#include <time/calendars/brazil.hpp>
+#include <time/calendars/nullcalendar.hpp>
+#include <time/calendars/registry.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/calendars/unitedstates.hpp>
+
+namespace MathFin {
+
+  Calendar calendarNamed(const std::string& name) {
+    const Calendar calendars[] = {
+      Australia(), Brazil::Settlement(), Brazil::Exchange(), NullCalendar(),
+      TARGET(), UnitedKingdom::Settlement(), UnitedKingdom::Exchange(),
+      UnitedKingdom::Metals(), UnitedStates::Settlement(),
+      UnitedStates::NYSE(), UnitedStates::GovernmentBond(),
+      UnitedStates::NERC()
+    };
+    for (Size i = 0; i < sizeof(calendars) / sizeof(calendars[0]); ++i) {
+      if (calendars[i].name() == name) {
+        return calendars[i];
+      }
+    }
+    return Calendar();
+  }
+
+}
@@ -0,0 +1,42 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file registry.hpp
+ * @brief lookup of the built-in calendars by name
+ */
+
+#ifndef MATHFIN_CALENDAR_REGISTRY_HPP
+#define MATHFIN_CALENDAR_REGISTRY_HPP
+
+#include <time/calendar.hpp>
+
+#include <string>
+
+namespace MathFin {
+
+  /**
+   * The built-in calendar whose name() is the given one, or an empty
+   * calendar if there is none.
+   */
+  Calendar calendarNamed(const std::string& name);
+
+}
+
+#endif /* MATHFIN_CALENDAR_REGISTRY_HPP */
@@ -0,0 +1,117 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file civil.hpp
+ * @brief integer conversions between day numbers and Gregorian dates
+ *
+ * These helpers perform no validation and construct no objects; they are
+ * the building blocks of the batch and unchecked date paths.  The
+ * algorithms are those of H. Hinnant, "chrono-Compatible Low-Level Date
+ * Algorithms", valid for the whole proleptic Gregorian calendar.
+ */
+
+#ifndef MATHFIN_CIVIL_HPP
+#define MATHFIN_CIVIL_HPP
+
+#include <base/types.hpp>
+
+namespace MathFin {
+
+  namespace detail {
+
+    /**
+     * Serial number (as given by Excel) of 1970-01-01.
+     */
+    const BigInteger epochSerialNumber = 25569;
+
+    /**
+     * Days since 1970-01-01 of the given year, month (1-12) and day.
+     */
+    inline BigInteger daysFromCivil(Integer y, Integer m, Integer d) {
+      y -= m <= 2;
+      const BigInteger era = (y >= 0 ? y : y - 399) / 400;
+      const BigInteger yoe = y - era * 400;
+      const BigInteger doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+      const BigInteger doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+      return era * 146097 + doe - 719468;
+    }
+
+    /**
+     * Year, month (1-12) and day of the given number of days since
+     * 1970-01-01.
+     */
+    inline void civilFromDays(BigInteger z, Integer& y, Integer& m, Integer& d) {
+      z += 719468;
+      const BigInteger era = (z >= 0 ? z : z - 146096) / 146097;
+      const BigInteger doe = z - era * 146097;
+      const BigInteger yoe =
+        (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+      const BigInteger doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+      const BigInteger mp = (5 * doy + 2) / 153;
+      d = Integer(doy - (153 * mp + 2) / 5 + 1);
+      m = Integer(mp < 10 ? mp + 3 : mp - 9);
+      y = Integer(yoe + era * 400 + (m <= 2 ? 1 : 0));
+    }
+
+    /**
+     * Serial number of the given year, month (1-12) and day.
+     */
+    inline BigInteger serialFromCivil(Integer y, Integer m, Integer d) {
+      return daysFromCivil(y, m, d) + epochSerialNumber;
+    }
+
+    /**
+     * Year, month (1-12) and day of the given serial number.
+     */
+    inline void civilFromSerial(BigInteger serial,
+                                Integer& y, Integer& m, Integer& d) {
+      civilFromDays(serial - epochSerialNumber, y, m, d);
+    }
+
+    /**
+     * Whether the given year is a leap one.
+     */
+    inline bool isLeap(Integer y) {
+      return (y % 4 == 0) && (y % 100 != 0 || y % 400 == 0);
+    }
+
+    /**
+     * Number of days in the given month (1-12) of the given year.
+     */
+    inline Integer daysInMonth(Integer y, Integer m) {
+      static const Integer days[] = {
+        31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+      return (m == 2 && isLeap(y)) ? 29 : days[m - 1];
+    }
+
+    /**
+     * Day of the week (1 = Sunday, ..., 7 = Saturday, as in Weekday) of the
+     * given serial number.
+     */
+    inline Integer weekdayFromSerial(BigInteger serial) {
+      // serial number 1 (1899-12-31) was a Sunday
+      return Integer(((serial - 1) % 7 + 7) % 7 + 1);
+    }
+
+  }
+
+}
+
+#endif /* MATHFIN_CIVIL_HPP */
@@ -40,6 +40,7 @@
 #include <time/date.hpp>
 #include <base/error.hpp>
 #include <base/conversion.hpp>
+#include <time/civil.hpp>
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 
@@ -196,6 +197,55 @@ namespace MathFin {
 
   // ---------------------------------------------------------------------------
 
+  Status Date::validate(Day d, Month m, Year y) {
+    if (y <= 1900 || y >= 2200) {
+      return Status(ErrorCode::YearOutOfRange, y);
+    }
+    if (as_integer(m) < 1 || as_integer(m) > 12) {
+      return Status(ErrorCode::MonthOutOfRange, as_integer(m));
+    }
+    if (d < 1 || d > detail::daysInMonth(y, as_integer(m))) {
+      return Status(ErrorCode::DayOutOfRange, d);
+    }
+    return Status();
+  }
+
+  Status Date::validate(Date::serial_type serialNumber) {
+    if (serialNumber < minimumSerialNumber()
+        || serialNumber > maximumSerialNumber()) {
+      return Status(ErrorCode::SerialOutOfRange, serialNumber);
+    }
+    return Status();
+  }
+
+  Expected<Date> Date::create(Day d, Month m, Year y) {
+    const Status status = validate(d, m, y);
+    if (!status.ok()) {
+      return status;
+    }
+    return unchecked(d, m, y);
+  }
+
+  Expected<Date> Date::create(Date::serial_type serialNumber) {
+    const Status status = validate(serialNumber);
+    if (!status.ok()) {
+      return status;
+    }
+    return unchecked(serialNumber);
+  }
+
+  Date Date::unchecked(Day d, Month m, Year y) {
+    return unchecked(
+      Date::serial_type(detail::serialFromCivil(y, as_integer(m), d)));
+  }
+
+  Date Date::unchecked(Date::serial_type serialNumber) {
+    return Date(ptime(serialNumberDateReference()
+                      + boost::gregorian::days(serialNumber)));
+  }
+
+  // ---------------------------------------------------------------------------
+
   Weekday Date::weekday() const {
     return mapBoostDateType2MF<compatibleEnums>(dateTime_.date().day_of_week());
   }
@@ -298,7 +348,8 @@ namespace MathFin {
 
   Date Date::todaysDate() {
     boost::gregorian::date current_date(boost::gregorian::day_clock::local_day());
-    return Date(
+    // the clock gives a valid date
+    return Date::unchecked(
       Day(current_date.day()),
       Month(current_date.month().as_number()),
       Year(current_date.year())
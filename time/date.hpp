@@ -39,6 +39,7 @@
 #ifndef MATHFIN_DATE_HPP
 #define MATHFIN_DATE_HPP
 
+#include <base/status.hpp>
 #include <time/period.hpp>
 #include <time/month.hpp>
 #include <time/weekday.hpp>
@@ -146,6 +147,55 @@ namespace MathFin {
 
     // -------------------------------------------------------------------------
 
+    /**
+     * @name non-throwing and unchecked construction
+     * The constructors above throw an Error on invalid input.  When bulk
+     * input is validated, the non-throwing forms report errors through a
+     * Status instead; when the input is known to be valid, the unchecked
+     * forms skip validation altogether.
+     * @{
+     */
+
+    /**
+     * Checks day, month and year without throwing.
+     */
+    static Status validate(Day d, Month m, Year y);
+
+    /**
+     * Checks a serial number without throwing.
+     */
+    static Status validate(Date::serial_type serialNumber);
+
+    /**
+     * Date from day, month and year, or the Status explaining why the
+     * input is invalid.
+     */
+    static Expected<Date> create(Day d, Month m, Year y);
+
+    /**
+     * Date from a serial number, or the Status explaining why the input is
+     * invalid.
+     */
+    static Expected<Date> create(Date::serial_type serialNumber);
+
+    /**
+     * Date from day, month and year, computed with integer arithmetic only.
+     * @warning the input is not validated; the result is undefined unless
+     * validate(d, m, y) succeeds.
+     */
+    static Date unchecked(Day d, Month m, Year y);
+
+    /**
+     * Date from a serial number.
+     * @warning the input is not validated; the result is undefined unless
+     * validate(serialNumber) succeeds.
+     */
+    static Date unchecked(Date::serial_type serialNumber);
+
+    /** @} */
+
+    // -------------------------------------------------------------------------
+
     /**
      * @name inspectors
      * @{
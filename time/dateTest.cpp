@@ -283,4 +283,39 @@ namespace MathFin {
     REQUIRE(v[1] == Date(28, Month::February, 2017));
   }
 
+  TEST_CASE("Non-throwing construction", "[date]") {
+    REQUIRE(Date::validate(29, Month::February, 2016).ok());
+    REQUIRE(Date::validate(29, Month::February, 2017).code()
+            == ErrorCode::DayOutOfRange);
+    REQUIRE(Date::validate(1, Month(13), 2017).code()
+            == ErrorCode::MonthOutOfRange);
+    REQUIRE(Date::validate(1, Month::January, 1900).code()
+            == ErrorCode::YearOutOfRange);
+    REQUIRE(Date::validate(Date::minDate().serialNumber()).ok());
+    REQUIRE(Date::validate(Date::maxDate().serialNumber() + 1).code()
+            == ErrorCode::SerialOutOfRange);
+
+    Expected<Date> d = Date::create(31, Month::December, 2016);
+    REQUIRE(d.ok());
+    REQUIRE(d.value() == Date(31, Month::December, 2016));
+
+    Expected<Date> bad = Date::create(31, Month::April, 2016);
+    REQUIRE(!bad.ok());
+    REQUIRE(bad.status().value() == 31);
+    REQUIRE_THROWS_AS(bad.value(), Error);
+    REQUIRE(Date::create(39448).value() == Date(1, Month::January, 2008));
+    REQUIRE(!Date::create(Date::serial_type(10)).ok());
+  }
+
+  TEST_CASE("Unchecked construction", "[date]") {
+    for (Date::serial_type i = Date::minDate().serialNumber();
+         i <= Date::maxDate().serialNumber(); ++i) {
+      Date d(i);
+      Date u = Date::unchecked(d.dayOfMonth(), d.month(), d.year());
+      if (u != d || Date::unchecked(i) != d) {
+        FAIL("unchecked date " << u << " differs from " << d);
+      }
+    }
+  }
+
 }
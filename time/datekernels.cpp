@@ -0,0 +1,540 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/cpu.hpp>
+#include <time/civil.hpp>
+#include <time/datekernels.hpp>
+#include <cstdint>
+
+// The vector kernels process serial numbers as 64-bit lanes; platforms
+// where Date::serial_type is narrower (int_fast32_t is 32-bit on macOS,
+// for instance) use the scalar kernels for every tier.
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(_WIN32) \
+    && INT_FAST32_MAX == INT64_MAX
+#define MATHFIN_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace MathFin {
+
+  namespace kernels {
+
+    namespace {
+
+      typedef boost::uint64_t word_type;
+
+      struct Table {
+        void (*dayCounts)(const Date::serial_type*, const Date::serial_type*,
+                          Size, Date::serial_type*);
+        void (*decompose)(const Date::serial_type*, Size,
+                          Year*, Integer*, Day*);
+        Size (*popcount)(const word_type*, Size);
+      };
+
+      inline Size popcount64(word_type w) {
+#ifdef __GNUC__
+        return Size(__builtin_popcountll(w));
+#else
+        w = w - ((w >> 1) & 0x5555555555555555ULL);
+        w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+        w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return Size((w * 0x0101010101010101ULL) >> 56);
+#endif
+      }
+
+      inline Size lowestBit(word_type w) {
+#ifdef __GNUC__
+        return Size(__builtin_ctzll(w));
+#else
+        Size n = 0;
+        while (!(w & 1)) { w >>= 1; ++n; }
+        return n;
+#endif
+      }
+
+      inline Size highestBit(word_type w) {
+#ifdef __GNUC__
+        return Size(63 - __builtin_clzll(w));
+#else
+        Size n = 63;
+        while (!(w >> 63)) { w <<= 1; --n; }
+        return n;
+#endif
+      }
+
+      // -----------------------------------------------------------------------
+      // portable kernels
+
+      void dayCountsScalar(const Date::serial_type* d1,
+                           const Date::serial_type* d2,
+                           Size n,
+                           Date::serial_type* result) {
+        for (Size i = 0; i < n; ++i) {
+          result[i] = d2[i] - d1[i];
+        }
+      }
+
+      void decomposeScalar(const Date::serial_type* serials,
+                           Size n,
+                           Year* years,
+                           Integer* months,
+                           Day* days) {
+        for (Size i = 0; i < n; ++i) {
+          detail::civilFromSerial(serials[i], years[i], months[i], days[i]);
+        }
+      }
+
+      Size popcountScalar(const word_type* words, Size n) {
+        Size count = 0;
+        for (Size i = 0; i < n; ++i) {
+          count += popcount64(words[i]);
+        }
+        return count;
+      }
+
+#ifdef MATHFIN_KERNELS_X86
+
+      static_assert(sizeof(Date::serial_type) == sizeof(boost::int64_t),
+                    "vector kernels assume 64-bit serial numbers");
+
+      // The vectorised decomposition evaluates civilFromDays() in double
+      // precision: every intermediate is an integer below 2^21, so the
+      // floored quotients are exact.  Serial numbers are converted by
+      // planting them in the mantissa of 2^52.
+      const boost::int64_t magicBits = 0x4330000000000000LL;
+      const double magic = 4503599627370496.0;
+      const double dayShift = 719468.0 - double(detail::epochSerialNumber);
+
+      // -----------------------------------------------------------------------
+      // SSE4.2 kernels
+
+#define MATHFIN_TARGET __attribute__((target("sse4.2,popcnt")))
+
+      MATHFIN_TARGET
+      inline __m128d floorDiv(__m128d a, double b) {
+        return _mm_floor_pd(_mm_div_pd(a, _mm_set1_pd(b)));
+      }
+
+      MATHFIN_TARGET
+      inline __m128d mulConst(__m128d a, double b) {
+        return _mm_mul_pd(a, _mm_set1_pd(b));
+      }
+
+      MATHFIN_TARGET
+      void dayCountsSSE42(const Date::serial_type* d1,
+                          const Date::serial_type* d2,
+                          Size n,
+                          Date::serial_type* result) {
+        Size i = 0;
+        for (; i + 2 <= n; i += 2) {
+          const __m128i a =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(d1 + i));
+          const __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(d2 + i));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i),
+                           _mm_sub_epi64(b, a));
+        }
+        dayCountsScalar(d1 + i, d2 + i, n - i, result + i);
+      }
+
+      MATHFIN_TARGET
+      void decomposeSSE42(const Date::serial_type* serials,
+                          Size n,
+                          Year* years,
+                          Integer* months,
+                          Day* days) {
+        const __m128i bits = _mm_set1_epi64x(magicBits);
+        const __m128d one = _mm_set1_pd(1.0);
+        Size i = 0;
+        for (; i + 2 <= n; i += 2) {
+          const __m128i raw =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(serials + i));
+          const __m128d z = _mm_add_pd(
+            _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(raw, bits)),
+                       _mm_set1_pd(magic)),
+            _mm_set1_pd(dayShift));
+          const __m128d era = floorDiv(z, 146097.0);
+          const __m128d doe = _mm_sub_pd(z, mulConst(era, 146097.0));
+          const __m128d yoe = floorDiv(
+            _mm_sub_pd(_mm_add_pd(_mm_sub_pd(doe, floorDiv(doe, 1460.0)),
+                                  floorDiv(doe, 36524.0)),
+                       floorDiv(doe, 146096.0)),
+            365.0);
+          const __m128d doy = _mm_sub_pd(
+            doe, _mm_sub_pd(_mm_add_pd(mulConst(yoe, 365.0),
+                                       floorDiv(yoe, 4.0)),
+                            floorDiv(yoe, 100.0)));
+          const __m128d mp = floorDiv(
+            _mm_add_pd(mulConst(doy, 5.0), _mm_set1_pd(2.0)), 153.0);
+          const __m128d d = _mm_add_pd(
+            _mm_sub_pd(doy, floorDiv(_mm_add_pd(mulConst(mp, 153.0),
+                                                _mm_set1_pd(2.0)), 5.0)),
+            one);
+          const __m128d late =
+            _mm_and_pd(_mm_cmpge_pd(mp, _mm_set1_pd(10.0)), one);
+          const __m128d m = _mm_sub_pd(_mm_add_pd(mp, _mm_set1_pd(3.0)),
+                                       mulConst(late, 12.0));
+          const __m128d y = _mm_add_pd(_mm_add_pd(yoe, mulConst(era, 400.0)),
+                                       late);
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(years + i),
+                           _mm_cvttpd_epi32(y));
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(months + i),
+                           _mm_cvttpd_epi32(m));
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(days + i),
+                           _mm_cvttpd_epi32(d));
+        }
+        decomposeScalar(serials + i, n - i, years + i, months + i, days + i);
+      }
+
+      MATHFIN_TARGET
+      Size popcountSSE42(const word_type* words, Size n) {
+        Size c0 = 0, c1 = 0;
+        Size i = 0;
+        for (; i + 2 <= n; i += 2) {
+          c0 += Size(_mm_popcnt_u64(words[i]));
+          c1 += Size(_mm_popcnt_u64(words[i + 1]));
+        }
+        if (i < n) {
+          c0 += Size(_mm_popcnt_u64(words[i]));
+        }
+        return c0 + c1;
+      }
+
+#undef MATHFIN_TARGET
+
+      // -----------------------------------------------------------------------
+      // AVX2 kernels
+
+#define MATHFIN_TARGET __attribute__((target("avx2,popcnt")))
+
+      MATHFIN_TARGET
+      inline __m256d floorDiv(__m256d a, double b) {
+        return _mm256_floor_pd(_mm256_div_pd(a, _mm256_set1_pd(b)));
+      }
+
+      MATHFIN_TARGET
+      inline __m256d mulConst(__m256d a, double b) {
+        return _mm256_mul_pd(a, _mm256_set1_pd(b));
+      }
+
+      MATHFIN_TARGET
+      void dayCountsAVX2(const Date::serial_type* d1,
+                         const Date::serial_type* d2,
+                         Size n,
+                         Date::serial_type* result) {
+        Size i = 0;
+        for (; i + 4 <= n; i += 4) {
+          const __m256i a =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d1 + i));
+          const __m256i b =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d2 + i));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i),
+                              _mm256_sub_epi64(b, a));
+        }
+        dayCountsScalar(d1 + i, d2 + i, n - i, result + i);
+      }
+
+      MATHFIN_TARGET
+      void decomposeAVX2(const Date::serial_type* serials,
+                         Size n,
+                         Year* years,
+                         Integer* months,
+                         Day* days) {
+        const __m256i bits = _mm256_set1_epi64x(magicBits);
+        const __m256d one = _mm256_set1_pd(1.0);
+        Size i = 0;
+        for (; i + 4 <= n; i += 4) {
+          const __m256i raw =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(serials + i));
+          const __m256d z = _mm256_add_pd(
+            _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(raw, bits)),
+                          _mm256_set1_pd(magic)),
+            _mm256_set1_pd(dayShift));
+          const __m256d era = floorDiv(z, 146097.0);
+          const __m256d doe = _mm256_sub_pd(z, mulConst(era, 146097.0));
+          const __m256d yoe = floorDiv(
+            _mm256_sub_pd(
+              _mm256_add_pd(_mm256_sub_pd(doe, floorDiv(doe, 1460.0)),
+                            floorDiv(doe, 36524.0)),
+              floorDiv(doe, 146096.0)),
+            365.0);
+          const __m256d doy = _mm256_sub_pd(
+            doe, _mm256_sub_pd(_mm256_add_pd(mulConst(yoe, 365.0),
+                                             floorDiv(yoe, 4.0)),
+                               floorDiv(yoe, 100.0)));
+          const __m256d mp = floorDiv(
+            _mm256_add_pd(mulConst(doy, 5.0), _mm256_set1_pd(2.0)), 153.0);
+          const __m256d d = _mm256_add_pd(
+            _mm256_sub_pd(doy, floorDiv(_mm256_add_pd(mulConst(mp, 153.0),
+                                                      _mm256_set1_pd(2.0)),
+                                        5.0)),
+            one);
+          const __m256d late = _mm256_and_pd(
+            _mm256_cmp_pd(mp, _mm256_set1_pd(10.0), _CMP_GE_OQ), one);
+          const __m256d m = _mm256_sub_pd(
+            _mm256_add_pd(mp, _mm256_set1_pd(3.0)), mulConst(late, 12.0));
+          const __m256d y = _mm256_add_pd(
+            _mm256_add_pd(yoe, mulConst(era, 400.0)), late);
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(years + i),
+                           _mm256_cvttpd_epi32(y));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(months + i),
+                           _mm256_cvttpd_epi32(m));
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(days + i),
+                           _mm256_cvttpd_epi32(d));
+        }
+        decomposeScalar(serials + i, n - i, years + i, months + i, days + i);
+      }
+
+      MATHFIN_TARGET
+      Size popcountAVX2(const word_type* words, Size n) {
+        // nibble lookup (W. Mula, N. Kurz, D. Lemire, "Faster Population
+        // Counts Using AVX2 Instructions")
+        const __m256i lookup = _mm256_setr_epi8(
+          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i lowMask = _mm256_set1_epi8(0x0f);
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i total = zero;
+        Size i = 0;
+        for (; i + 4 <= n; i += 4) {
+          const __m256i v =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+          const __m256i lo = _mm256_and_si256(v, lowMask);
+          const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+          const __m256i counts = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+          total = _mm256_add_epi64(total, _mm256_sad_epu8(counts, zero));
+        }
+        Size count = Size(_mm256_extract_epi64(total, 0))
+          + Size(_mm256_extract_epi64(total, 1))
+          + Size(_mm256_extract_epi64(total, 2))
+          + Size(_mm256_extract_epi64(total, 3));
+        for (; i < n; ++i) {
+          count += Size(_mm_popcnt_u64(words[i]));
+        }
+        return count;
+      }
+
+#undef MATHFIN_TARGET
+
+      // -----------------------------------------------------------------------
+      // AVX-512 kernels
+
+#define MATHFIN_TARGET __attribute__((target("avx512f,avx512bw,popcnt")))
+
+      MATHFIN_TARGET
+      inline __m512d floorDiv(__m512d a, double b) {
+        // The unmasked intrinsics merge into an undefined register, which
+        // GCC reports as an uninitialised read; the zero-masked forms with
+        // every lane selected compile to the same instructions.
+        return _mm512_maskz_roundscale_pd(
+          __mmask8(0xff), _mm512_div_pd(a, _mm512_set1_pd(b)),
+          _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+      }
+
+      MATHFIN_TARGET
+      inline __m256i truncate(__m512d a) {
+        return _mm512_maskz_cvttpd_epi32(__mmask8(0xff), a);
+      }
+
+      MATHFIN_TARGET
+      inline __m512d mulConst(__m512d a, double b) {
+        return _mm512_mul_pd(a, _mm512_set1_pd(b));
+      }
+
+      MATHFIN_TARGET
+      void dayCountsAVX512(const Date::serial_type* d1,
+                           const Date::serial_type* d2,
+                           Size n,
+                           Date::serial_type* result) {
+        Size i = 0;
+        for (; i + 8 <= n; i += 8) {
+          const __m512i a = _mm512_loadu_si512(d1 + i);
+          const __m512i b = _mm512_loadu_si512(d2 + i);
+          _mm512_storeu_si512(result + i, _mm512_sub_epi64(b, a));
+        }
+        dayCountsScalar(d1 + i, d2 + i, n - i, result + i);
+      }
+
+      MATHFIN_TARGET
+      void decomposeAVX512(const Date::serial_type* serials,
+                           Size n,
+                           Year* years,
+                           Integer* months,
+                           Day* days) {
+        const __m512i bits = _mm512_set1_epi64(magicBits);
+        const __m512d one = _mm512_set1_pd(1.0);
+        Size i = 0;
+        for (; i + 8 <= n; i += 8) {
+          const __m512i raw = _mm512_loadu_si512(serials + i);
+          const __m512d z = _mm512_add_pd(
+            _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(raw, bits)),
+                          _mm512_set1_pd(magic)),
+            _mm512_set1_pd(dayShift));
+          const __m512d era = floorDiv(z, 146097.0);
+          const __m512d doe = _mm512_sub_pd(z, mulConst(era, 146097.0));
+          const __m512d yoe = floorDiv(
+            _mm512_sub_pd(
+              _mm512_add_pd(_mm512_sub_pd(doe, floorDiv(doe, 1460.0)),
+                            floorDiv(doe, 36524.0)),
+              floorDiv(doe, 146096.0)),
+            365.0);
+          const __m512d doy = _mm512_sub_pd(
+            doe, _mm512_sub_pd(_mm512_add_pd(mulConst(yoe, 365.0),
+                                             floorDiv(yoe, 4.0)),
+                               floorDiv(yoe, 100.0)));
+          const __m512d mp = floorDiv(
+            _mm512_add_pd(mulConst(doy, 5.0), _mm512_set1_pd(2.0)), 153.0);
+          const __m512d d = _mm512_add_pd(
+            _mm512_sub_pd(doy, floorDiv(_mm512_add_pd(mulConst(mp, 153.0),
+                                                      _mm512_set1_pd(2.0)),
+                                        5.0)),
+            one);
+          const __m512d late = _mm512_maskz_mov_pd(
+            _mm512_cmp_pd_mask(mp, _mm512_set1_pd(10.0), _CMP_GE_OQ), one);
+          const __m512d m = _mm512_sub_pd(
+            _mm512_add_pd(mp, _mm512_set1_pd(3.0)), mulConst(late, 12.0));
+          const __m512d y = _mm512_add_pd(
+            _mm512_add_pd(yoe, mulConst(era, 400.0)), late);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(years + i),
+                              truncate(y));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(months + i),
+                              truncate(m));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(days + i),
+                              truncate(d));
+        }
+        decomposeScalar(serials + i, n - i, years + i, months + i, days + i);
+      }
+
+      MATHFIN_TARGET
+      Size popcountAVX512(const word_type* words, Size n) {
+        const __m512i lookup = _mm512_maskz_broadcast_i32x4(
+          __mmask16(0xffff),
+          _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4));
+        const __m512i lowMask = _mm512_set1_epi8(0x0f);
+        const __m512i zero = _mm512_setzero_si512();
+        __m512i total = zero;
+        Size i = 0;
+        for (; i + 8 <= n; i += 8) {
+          const __m512i v = _mm512_loadu_si512(words + i);
+          const __m512i lo = _mm512_and_si512(v, lowMask);
+          const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), lowMask);
+          const __m512i counts = _mm512_add_epi8(
+            _mm512_shuffle_epi8(lookup, lo), _mm512_shuffle_epi8(lookup, hi));
+          total = _mm512_add_epi64(total, _mm512_sad_epu8(counts, zero));
+        }
+        alignas(64) boost::uint64_t lanes[8];
+        _mm512_store_si512(lanes, total);
+        Size count = 0;
+        for (Size j = 0; j < 8; ++j) {
+          count += Size(lanes[j]);
+        }
+        for (; i < n; ++i) {
+          count += Size(_mm_popcnt_u64(words[i]));
+        }
+        return count;
+      }
+
+#undef MATHFIN_TARGET
+
+      const Table tables[cpuTierCount] = {
+        { dayCountsScalar, decomposeScalar, popcountScalar },
+        { dayCountsSSE42, decomposeSSE42, popcountSSE42 },
+        { dayCountsAVX2, decomposeAVX2, popcountAVX2 },
+        { dayCountsAVX512, decomposeAVX512, popcountAVX512 }
+      };
+
+#else
+
+      const Table tables[cpuTierCount] = {
+        { dayCountsScalar, decomposeScalar, popcountScalar },
+        { dayCountsScalar, decomposeScalar, popcountScalar },
+        { dayCountsScalar, decomposeScalar, popcountScalar },
+        { dayCountsScalar, decomposeScalar, popcountScalar }
+      };
+
+#endif
+
+      const word_type allBits = ~word_type(0);
+
+    }
+
+    void dayCounts(const Date::serial_type* d1,
+                   const Date::serial_type* d2,
+                   Size n,
+                   Date::serial_type* result) {
+      selectForCpu(tables).dayCounts(d1, d2, n, result);
+    }
+
+    void decompose(const Date::serial_type* serials,
+                   Size n,
+                   Year* years,
+                   Integer* months,
+                   Day* days) {
+      selectForCpu(tables).decompose(serials, n, years, months, days);
+    }
+
+    Size countBits(const word_type* words, Size firstBit, Size lastBit) {
+      if (firstBit >= lastBit) {
+        return 0;
+      }
+      const Size first = firstBit / 64;
+      const Size last = (lastBit - 1) / 64;
+      const word_type head = allBits << (firstBit % 64);
+      const word_type tail = allBits >> (63 - (lastBit - 1) % 64);
+      if (first == last) {
+        return popcount64(words[first] & head & tail);
+      }
+      return popcount64(words[first] & head)
+        + selectForCpu(tables).popcount(words + first + 1, last - first - 1)
+        + popcount64(words[last] & tail);
+    }
+
+    Size nextSetBit(const word_type* words, Size bit, Size size) {
+      if (bit >= size) {
+        return size;
+      }
+      const Size last = (size - 1) / 64;
+      Size i = bit / 64;
+      word_type w = words[i] & (allBits << (bit % 64));
+      while (w == 0) {
+        if (++i > last) {
+          return size;
+        }
+        w = words[i];
+      }
+      const Size result = i * 64 + lowestBit(w);
+      return result < size ? result : size;
+    }
+
+    Size previousSetBit(const word_type* words, Size bit) {
+      Size i = bit / 64;
+      word_type w = words[i] & (allBits >> (63 - bit % 64));
+      while (w == 0) {
+        if (i == 0) {
+          return Size(-1);
+        }
+        w = words[--i];
+      }
+      return i * 64 + highestBit(w);
+    }
+
+  }
+
+}
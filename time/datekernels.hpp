@@ -0,0 +1,81 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file datekernels.hpp
+ * @brief batch kernels over serial numbers and business-day bitmaps
+ *
+ * Each kernel has a portable implementation and, on x86 processors,
+ * SSE4.2, AVX2 and AVX-512 ones; the variant matching activeCpuTier() is
+ * used.  The kernels perform no validation: serial numbers must be valid
+ * (see Date::validate()).
+ */
+
+#ifndef MATHFIN_DATEKERNELS_HPP
+#define MATHFIN_DATEKERNELS_HPP
+
+#include <base/types.hpp>
+#include <time/date.hpp>
+
+#include <boost/cstdint.hpp>
+
+namespace MathFin {
+
+  namespace kernels {
+
+    /**
+     * Actual day counts: <tt>result[i] = d2[i] - d1[i]</tt>.
+     */
+    void dayCounts(const Date::serial_type* d1,
+                   const Date::serial_type* d2,
+                   Size n,
+                   Date::serial_type* result);
+
+    /**
+     * Decomposes serial numbers into year, month (1-12) and day of month.
+     */
+    void decompose(const Date::serial_type* serials,
+                   Size n,
+                   Year* years,
+                   Integer* months,
+                   Day* days);
+
+    /**
+     * Number of bits set in <tt>[firstBit, lastBit)</tt> of a bitmap stored
+     * least-significant bit first.
+     */
+    Size countBits(const boost::uint64_t* words, Size firstBit, Size lastBit);
+
+    /**
+     * Position of the first bit set at or after <tt>bit</tt>, or
+     * <tt>size</tt> if there is none in <tt>[bit, size)</tt>.
+     */
+    Size nextSetBit(const boost::uint64_t* words, Size bit, Size size);
+
+    /**
+     * Position of the last bit set at or before <tt>bit</tt>, or
+     * <tt>Size(-1)</tt> if there is none.
+     */
+    Size previousSetBit(const boost::uint64_t* words, Size bit);
+
+  }
+
+}
+
+#endif /* MATHFIN_DATEKERNELS_HPP */
@@ -0,0 +1,119 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/cpu.hpp>
+#include <base/conversion.hpp>
+#include <time/datekernels.hpp>
+
+using namespace MathFin;
+
+namespace {
+  // runs the check with the kernels of every tier the processor supports
+  template <class Check>
+  void forEachTier(Check check) {
+    for (int i = 0; i <= as_integer(detectedCpuTier()); ++i) {
+      ScopedCpuTier forced((CpuTier(i)));
+      check();
+    }
+  }
+}
+
+TEST_CASE("Day count kernels", "[datekernels]") {
+  std::vector<Date::serial_type> d1, d2;
+  for (Date::serial_type i = 0; i < 1001; ++i) {
+    d1.push_back(Date::minDate().serialNumber() + i * 97);
+    d2.push_back(Date::maxDate().serialNumber() - i * 89);
+  }
+  forEachTier([&]() {
+      std::vector<Date::serial_type> result(d1.size());
+      kernels::dayCounts(&d1[0], &d2[0], d1.size(), &result[0]);
+      for (Size i = 0; i < d1.size(); ++i) {
+        REQUIRE(result[i] == d2[i] - d1[i]);
+      }
+    });
+}
+
+TEST_CASE("Date decomposition kernels", "[datekernels]") {
+  std::vector<Date::serial_type> serials;
+  for (Date::serial_type i = Date::minDate().serialNumber();
+       i <= Date::maxDate().serialNumber(); ++i) {
+    serials.push_back(i);
+  }
+  const Size n = serials.size();
+  forEachTier([&]() {
+      std::vector<Year> years(n);
+      std::vector<Integer> months(n);
+      std::vector<Day> days(n);
+      kernels::decompose(&serials[0], n, &years[0], &months[0], &days[0]);
+      for (Size i = 0; i < n; ++i) {
+        Date d(serials[i]);
+        if (years[i] != d.year() || months[i] != as_integer(d.month())
+            || days[i] != d.dayOfMonth()) {
+          FAIL("tier " << activeCpuTier() << ": serial " << serials[i]
+               << " decomposed as " << years[i] << "-" << months[i]
+               << "-" << days[i] << " instead of " << d);
+        }
+      }
+    });
+}
+
+TEST_CASE("Bitmap scan kernels", "[datekernels]") {
+  // a pseudo-random bitmap with long runs of zeros
+  std::vector<boost::uint64_t> words(100);
+  boost::uint64_t state = 12345;
+  for (Size i = 0; i < words.size(); ++i) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    words[i] = (i % 7 == 3) ? 0 : state;
+  }
+  const Size size = words.size() * 64;
+  std::vector<bool> bits(size);
+  for (Size i = 0; i < size; ++i) {
+    bits[i] = (words[i / 64] >> (i % 64)) & 1;
+  }
+
+  forEachTier([&]() {
+      for (Size first = 0; first < size; first += 37) {
+        Size expected = 0;
+        for (Size last = first; last <= size; ++last) {
+          if (last > first) {
+            expected += bits[last - 1];
+          }
+          if ((last - first) % 13 == 0 || last == size) {
+            REQUIRE(kernels::countBits(&words[0], first, last) == expected);
+          }
+        }
+      }
+    });
+
+  for (Size bit = 0; bit < size; ++bit) {
+    Size next = bit;
+    while (next < size && !bits[next]) {
+      ++next;
+    }
+    REQUIRE(kernels::nextSetBit(&words[0], bit, size) == next);
+    Size previous = bit;
+    while (previous != Size(-1) && !bits[previous]) {
+      --previous;
+    }
+    REQUIRE(kernels::previousSetBit(&words[0], bit) == previous);
+  }
+}
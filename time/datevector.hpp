@@ -0,0 +1,55 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file datevector.hpp
+ * @brief inline-capacity sequences of dates and periods
+ */
+
+#ifndef MATHFIN_DATEVECTOR_HPP
+#define MATHFIN_DATEVECTOR_HPP
+
+#include <base/smallvector.hpp>
+#include <time/date.hpp>
+#include <time/period.hpp>
+
+namespace MathFin {
+
+  /**
+   * Dates, stored inline up to the length of a typical schedule.
+   * @ingroup datetime
+   */
+  typedef SmallVector<Date, 128> DateVector;
+
+  /**
+   * Serial numbers, stored inline up to the length of a typical schedule;
+   * suitable for Schedule::generate().
+   * @ingroup datetime
+   */
+  typedef SmallVector<Date::serial_type, 128> SerialNumberVector;
+
+  /**
+   * Periods, stored inline up to the length of a typical tenor grid.
+   * @ingroup datetime
+   */
+  typedef SmallVector<Period, 40> PeriodVector;
+
+}
+
+#endif /* MATHFIN_DATEVECTOR_HPP */
@@ -0,0 +1,97 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Copyright (C) 2000, 2001, 2002, 2003 RiskMap srl
+  Copyright (C) 2003, 2004, 2005, 2006, 2007 StatPro Italia srl
+
+  This file is part of QuantLib, a free-software/open-source library
+  for financial quantitative analysts and developers - http://quantlib.org/
+
+  QuantLib is free software: you can redistribute it and/or modify it
+  under the terms of the QuantLib license.  You should have received a
+  copy of the license along with this program; if not, please email
+  <quantlib-dev@lists.sf.net>. The license is also available online at
+  <http://quantlib.org/license.shtml>.
+
+  This program is distributed in the hope that it will be useful, but WITHOUT
+  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+  FOR A PARTICULAR PURPOSE.  See the license for more details.
+*/
+
+
+#include <base/threadpool.hpp>
+#include <base/trace.hpp>
+#include <time/daycounter.hpp>
+
+namespace MathFin {
+
+  namespace {
+    // date pairs per parallel chunk
+    const Size batchGrain = 1024;
+  }
+
+  void DayCounter::dayCounts(const Date::serial_type* d1,
+                             const Date::serial_type* d2,
+                             Size n,
+                             Date::serial_type* result,
+                             ThreadPool* pool) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    MF_TRACE_SPAN("DayCounter::dayCounts", "daycounter");
+    parallelFor(pool, 0, n, batchGrain, [&](Size lo, Size hi) {
+        for (Size i = lo; i < hi; ++i) {
+          result[i] = impl_->dayCount(Date(d1[i]), Date(d2[i]));
+        }
+      });
+  }
+
+  void DayCounter::yearFractions(const Date::serial_type* d1,
+                                 const Date::serial_type* d2,
+                                 Size n,
+                                 Time* result,
+                                 ThreadPool* pool) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    MF_TRACE_SPAN("DayCounter::yearFractions", "daycounter");
+    parallelFor(pool, 0, n, batchGrain, [&](Size lo, Size hi) {
+        for (Size i = lo; i < hi; ++i) {
+          result[i] = impl_->yearFraction(Date(d1[i]), Date(d2[i]),
+                                          Date(), Date());
+        }
+      });
+  }
+
+  void DayCounter::yearFractions(const Date::serial_type* d1,
+                                 const Date::serial_type* d2,
+                                 const Date::serial_type* refPeriodStart,
+                                 const Date::serial_type* refPeriodEnd,
+                                 Size n,
+                                 Time* result,
+                                 ThreadPool* pool) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    MF_TRACE_SPAN("DayCounter::yearFractions", "daycounter");
+    parallelFor(pool, 0, n, batchGrain, [&](Size lo, Size hi) {
+        for (Size i = lo; i < hi; ++i) {
+          result[i] = impl_->yearFraction(Date(d1[i]), Date(d2[i]),
+                                          Date(refPeriodStart[i]),
+                                          Date(refPeriodEnd[i]));
+        }
+      });
+  }
+
+}
@@ -40,10 +40,15 @@
 
 #include <memory>
 #include <string>
+#include <typeinfo>
 #include <time/date.hpp>
 #include <base/error.hpp>
+#include <base/stats.hpp>
 
 namespace MathFin {
+
+  class ThreadPool;
+
   /** Day counter class.
    *
    * This class provides methods for determining the length of a time
@@ -76,6 +81,8 @@ namespace MathFin {
 
     std::shared_ptr<Impl> impl_;
 
+    friend bool operator==(const DayCounter&, const DayCounter&);
+
     /**
      * This constructor can be invoked by derived classes which
      * define a given implementation.
@@ -128,9 +135,77 @@ namespace MathFin {
                       const Date& refPeriodStart = Date(),
                       const Date& refPeriodEnd = Date()) const {
       MF_REQUIRE(impl_, "no implementation provided");
+      MF_COUNT_FOR(DayCounterYearFractions, typeid(*impl_));
+      MF_TIME_FOR(DayCounterYearFraction, typeid(*impl_));
       return impl_->yearFraction(d1, d2, refPeriodStart, refPeriodEnd);
     }
 
+    /**
+     * As dayCount(), without checking for an implementation; meant for
+     * inner loops over pre-validated input.
+     * @warning the day counter must not be empty().
+     */
+    inline Date::serial_type dayCountUnchecked(const Date& d1,
+                                               const Date& d2) const {
+      return impl_->dayCount(d1,d2);
+    }
+
+    /**
+     * As yearFraction(), without checking for an implementation; meant for
+     * inner loops over pre-validated input.
+     * @warning the day counter must not be empty().
+     */
+    inline Time yearFractionUnchecked(const Date& d1, const Date& d2,
+                                      const Date& refPeriodStart = Date(),
+                                      const Date& refPeriodEnd = Date()) const {
+      MF_COUNT_FOR(DayCounterYearFractions, typeid(*impl_));
+      MF_TIME_FOR(DayCounterYearFraction, typeid(*impl_));
+      return impl_->yearFraction(d1, d2, refPeriodStart, refPeriodEnd);
+    }
+
+    /** @} */
+
+    // -------------------------------------------------------------------------
+
+    /**
+     * @name batch operations
+     * The following methods work on arrays of serial numbers.  When a
+     * thread pool is given the arrays are processed in parallel, otherwise
+     * on the calling thread.
+     * @{
+     */
+
+    /**
+     * Day counts between <tt>n</tt> pairs of dates.
+     */
+    void dayCounts(const Date::serial_type* d1,
+                   const Date::serial_type* d2,
+                   Size n,
+                   Date::serial_type* result,
+                   ThreadPool* pool = 0) const;
+
+    /**
+     * Year fractions between <tt>n</tt> pairs of dates, without reference
+     * periods.
+     */
+    void yearFractions(const Date::serial_type* d1,
+                       const Date::serial_type* d2,
+                       Size n,
+                       Time* result,
+                       ThreadPool* pool = 0) const;
+
+    /**
+     * Year fractions between <tt>n</tt> pairs of dates, each with its
+     * reference period.
+     */
+    void yearFractions(const Date::serial_type* d1,
+                       const Date::serial_type* d2,
+                       const Date::serial_type* refPeriodStart,
+                       const Date::serial_type* refPeriodEnd,
+                       Size n,
+                       Time* result,
+                       ThreadPool* pool = 0) const;
+
     /** @} */
   };
 
@@ -141,8 +216,13 @@ namespace MathFin {
    * @relates DayCounter
    */
   inline bool operator==(const DayCounter& d1, const DayCounter& d2) {
-    return (d1.empty() && d2.empty())
-      || (!d1.empty() && !d2.empty() && d1.name() == d2.name());
+    if (d1.impl_ == d2.impl_) {
+      return true;
+    }
+    // names are only built when the implementations are of the same class
+    return !d1.empty() && !d2.empty()
+      && typeid(*d1.impl_) == typeid(*d2.impl_)
+      && d1.name() == d2.name();
   }
 
   /**
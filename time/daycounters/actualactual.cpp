@@ -154,6 +154,8 @@ namespace MathFin {
         // d1 < refPeriodStart < refPeriodEnd
         // AND d2 <= refPeriodEnd
         // this case is long first coupon
+        MF_COUNT_FOR(ActualActualRecursions, typeid(*this));
+        MF_TIME_FOR(ActualActualRecursion, typeid(*this));
 
         // the last notional payment date
         Date previousRef = refPeriodStart - months * TimeUnit::Months;
@@ -168,6 +170,8 @@ namespace MathFin {
     } else {
       // here refPeriodEnd is the last (notional?) payment date
       // d1 < refPeriodEnd < d2 AND refPeriodStart < refPeriodEnd
+      MF_COUNT_FOR(ActualActualRecursions, typeid(*this));
+      MF_TIME_FOR(ActualActualRecursion, typeid(*this));
       MF_REQUIRE(refPeriodStart <= d1,
                  "Invalid dates: "
                  "d1 < refPeriodStart < refPeriodEnd < d2");
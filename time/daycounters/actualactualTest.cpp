@@ -20,8 +20,11 @@
 #define CATCH_CONFIG_MAIN
 
 #include <iostream>
+#include <vector>
 #include <test/catch.hpp>
 #include <base/error.hpp>
+#include <base/stats.hpp>
+#include <base/threadpool.hpp>
 #include <time/daycounters/actualactual.hpp>
 
 using namespace MathFin;
@@ -194,3 +197,71 @@ TEST_CASE("Actual/Actual (ISMA)", "[daycounters]") {
   yf = dc.yearFraction(d18, d28, d38, d48);
   REQUIRE(yf - (91/(91.0 * 4) + 61/(92.0 * 4)) <= EPS);
 }
+
+TEST_CASE("Actual/Actual (ISMA) recursion is timed", "[daycounters][stats]") {
+  const DayCounter dc = ActualActual(ActualActual::Convention::ISMA);
+  const StatsSnapshot before = Stats::snapshot();
+  // long first period, split in two
+  dc.yearFraction(Date(15, Month::August, 2002), Date(15, Month::July, 2003),
+                  Date(15, Month::January, 2003), Date(15, Month::July, 2003));
+  // regular period
+  dc.yearFraction(Date(15, Month::July, 2003), Date(15, Month::January, 2004),
+                  Date(15, Month::July, 2003), Date(15, Month::January, 2004));
+
+  const StatsSnapshot delta = Stats::snapshot() - before;
+  if (!Stats::enabled()) {
+    REQUIRE(delta[Counter::ActualActualRecursions] == 0);
+    return;
+  }
+  REQUIRE(delta.count(Counter::DayCounterYearFractions,
+                      "ActualActual::ISMA") == 2);
+  REQUIRE(delta.count(Counter::ActualActualRecursions,
+                      "ActualActual::ISMA") == 1);
+  REQUIRE(delta.histogram(Timer::ActualActualRecursion, "ActualActual::ISMA")
+          .count() == 1);
+  REQUIRE(delta.histogram(Timer::DayCounterYearFraction, "ActualActual::ISMA")
+          .count() == 2);
+}
+
+TEST_CASE("Actual/Actual (ISDA) batch", "[daycounters]") {
+  ActualActual dc(ActualActual::Convention::ISDA);
+  std::vector<Date::serial_type> d1, d2;
+  for (Date::serial_type i = Date(1, Month::January, 1990).serialNumber();
+       i < Date(1, Month::January, 2020).serialNumber(); i += 3) {
+    d1.push_back(i);
+    d2.push_back(i + (i % 1500));
+  }
+  const Size n = d1.size();
+
+  ThreadPool pool(2);
+  std::vector<Time> yf(n);
+  std::vector<Date::serial_type> days(n);
+  dc.yearFractions(&d1[0], &d2[0], n, &yf[0], &pool);
+  dc.dayCounts(&d1[0], &d2[0], n, &days[0], &pool);
+  for (Size i = 0; i < n; ++i) {
+    REQUIRE(yf[i] == dc.yearFraction(Date(d1[i]), Date(d2[i])));
+    REQUIRE(days[i] == dc.dayCount(Date(d1[i]), Date(d2[i])));
+  }
+}
+
+TEST_CASE("Actual/Actual (ISMA) batch with reference periods",
+          "[daycounters]") {
+  ActualActual dc(ActualActual::Convention::ISMA);
+  std::vector<Date::serial_type> d1, d2, ref1, ref2;
+  for (Date::serial_type i = Date(1, Month::January, 1990).serialNumber();
+       i < Date(1, Month::January, 2020).serialNumber(); i += 7) {
+    d1.push_back(i + (i % 20));
+    d2.push_back(i + 91 + (i % 10));
+    ref1.push_back(i);
+    ref2.push_back(i + 91 + 92 * (i % 2));
+  }
+  const Size n = d1.size();
+
+  ThreadPool pool(2);
+  std::vector<Time> yf(n);
+  dc.yearFractions(&d1[0], &d2[0], &ref1[0], &ref2[0], n, &yf[0], &pool);
+  for (Size i = 0; i < n; ++i) {
+    REQUIRE(yf[i] == dc.yearFraction(Date(d1[i]), Date(d2[i]),
+                                     Date(ref1[i]), Date(ref2[i])));
+  }
+}
@@ -0,0 +1,538 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file equivalenceCheck.cpp
+ * @brief exhaustive comparison of the fast paths with the rule-based code
+ *
+ * Every cached or vectorised path must give the same results as the code
+ * it replaces.  This program compares, over every date from 1901 to 2199
+ * and for every calendar:
+ * - BusinessDayBitmap with the calendar rules, for isBusinessDay(),
+ *   following, preceding and businessDaysBetween() with every combination
+ *   of end points, using the kernels of every CPU tier;
+ * - the batch and unchecked calendar methods with the checked scalar
+ *   ones, for every business-day convention;
+ * then the date kernels of every CPU tier with Date, and the batch and
+ * unchecked methods of every day counter with the scalar ones over a dense
+ * sample of date pairs.  The work is spread over all cores; mismatches
+ * are listed and make the program fail.
+ */
+
+#include <base/cpu.hpp>
+#include <base/threadpool.hpp>
+#include <time/businessdaybitmap.hpp>
+#include <time/civil.hpp>
+#include <time/calendars/australia.hpp>
+#include <time/calendars/brazil.hpp>
+#include <time/calendars/nullcalendar.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/datekernels.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actual365fixed.hpp>
+#include <time/daycounters/actualactual.hpp>
+#include <time/daycounters/business252.hpp>
+#include <time/daycounters/one.hpp>
+#include <time/daycounters/simpledaycounter.hpp>
+#include <time/daycounters/thirty360.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace MathFin;
+
+namespace {
+
+  typedef Date::serial_type serial;
+
+  const serial firstSerial = Date::minDate().serialNumber();
+  const serial lastSerial = Date::maxDate().serialNumber();
+  const Size dayCount = Size(lastSerial - firstSerial + 1);
+
+  // adjustments must not step out of the date range
+  const serial margin = 16;
+
+  const Size grain = 2048;
+
+  const BusinessDayConvention conventions[] = {
+    BusinessDayConvention::Following,
+    BusinessDayConvention::ModifiedFollowing,
+    BusinessDayConvention::Preceding,
+    BusinessDayConvention::ModifiedPreceding,
+    BusinessDayConvention::Unadjusted,
+    BusinessDayConvention::HalfMonthModifiedFollowing,
+    BusinessDayConvention::Nearest
+  };
+
+  // year-month-day, without the time of day printed for dates
+  std::string show(serial s) {
+    Integer y, m, d;
+    detail::civilFromSerial(s, y, m, d);
+    std::ostringstream out;
+    out << y << '-' << std::setfill('0') << std::setw(2) << m << '-'
+        << std::setw(2) << d;
+    return out.str();
+  }
+
+  /**
+   * Value of an evaluation, or whether it threw.
+   */
+  template <class T>
+  struct Outcome {
+    bool threw;
+    T value;
+
+    bool operator==(const Outcome& other) const {
+      return threw == other.threw && (threw || value == other.value);
+    }
+  };
+
+  template <class T>
+  std::ostream& operator<<(std::ostream& out, const Outcome<T>& o) {
+    return o.threw ? out << "an exception" : out << o.value;
+  }
+
+  template <class F>
+  Outcome<typename std::result_of<F()>::type> attempt(const F& f) {
+    Outcome<typename std::result_of<F()>::type> result;
+    try {
+      result.value = f();
+      result.threw = false;
+    } catch (Error&) {
+      result.value = 0;
+      result.threw = true;
+    }
+    return result;
+  }
+
+  /**
+   * Cases compared over a chunk, and the first mismatch found.
+   */
+  struct Tally {
+    Tally() : cases(0), mismatches(0) {}
+
+    template <class T>
+    void compare(const T& fast, const T& reference, serial s1,
+                 serial s2 = 0) {
+      ++cases;
+      if (fast == reference) {
+        return;
+      }
+      if (mismatches++ == 0) {
+        std::ostringstream out;
+        out << show(s1);
+        if (s2 != 0) {
+          out << ", " << show(s2);
+        }
+        out << ": " << std::setprecision(17) << fast
+            << " instead of " << reference;
+        first = out.str();
+      }
+    }
+
+    Size cases, mismatches;
+    std::string first;
+  };
+
+  Tally operator+(const Tally& a, const Tally& b) {
+    Tally result;
+    result.cases = a.cases + b.cases;
+    result.mismatches = a.mismatches + b.mismatches;
+    result.first = a.first.empty() ? b.first : a.first;
+    return result;
+  }
+
+  class Checker {
+  public:
+    Checker() : failures_(0) {}
+
+    Size workers() const { return pool_.workers(); }
+    Size failures() const { return failures_; }
+
+    /**
+     * Runs <tt>f(lo, hi, tally)</tt> over the chunks of <tt>[0, n)</tt>
+     * and reports the mismatches.
+     */
+    template <class F>
+    void run(const std::string& check, const std::string& subject,
+             Size n, const F& f) {
+      typedef std::chrono::steady_clock clock;
+      const clock::time_point start = clock::now();
+      const Tally tally = pool_.parallelReduce(
+        Size(0), n, grain, Tally(),
+        [&](Size lo, Size hi) {
+          Tally t;
+          f(lo, hi, t);
+          return t;
+        },
+        [](const Tally& a, const Tally& b) { return a + b; });
+      const double seconds =
+        std::chrono::duration<double>(clock::now() - start).count();
+
+      std::cout << (tally.mismatches == 0 ? "  ok    " : "  FAIL  ")
+                << std::left << std::setw(38) << check
+                << std::setw(52) << subject << std::right
+                << std::setw(10) << tally.cases
+                << std::fixed << std::setprecision(2) << std::setw(7)
+                << seconds << "s" << std::endl;
+      if (tally.mismatches != 0) {
+        std::cout << "        " << tally.mismatches
+                  << " mismatches, the first at " << tally.first << std::endl;
+        ++failures_;
+      }
+    }
+
+  private:
+    ThreadPool pool_;
+    Size failures_;
+  };
+
+  std::string describe(const std::string& name, CpuTier tier) {
+    std::ostringstream out;
+    out << name << " [" << tier << "]";
+    return out.str();
+  }
+
+  // deterministic pseudo-random mixing of a serial number
+  Size mix(serial s, Size k) {
+    boost::uint64_t x = boost::uint64_t(s) * 0x9e3779b97f4a7c15ULL + k;
+    x ^= x >> 29;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    return Size(x ^ (x >> 32));
+  }
+
+  // the k-th range starting at s: mostly short, some over years, some
+  // backwards
+  serial rangeEnd(serial s, Size k) {
+    const Size h = mix(s, k);
+    const serial span = serial(h % 8 == 0 ? (h >> 3) % 3700 : (h >> 3) % 24);
+    return (h >> 20) % 4 == 0
+      ? std::max(s - span, firstSerial)
+      : std::min(s + span, lastSerial);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  /**
+   * Business days of a calendar as given by its rules, with their running
+   * count, from which the expected results of businessDaysBetween() follow.
+   */
+  struct Rules {
+    std::vector<char> business;
+    std::vector<serial> count;   // business days before each date
+
+    bool isBusinessDay(serial s) const {
+      return business[Size(s - firstSerial)] != 0;
+    }
+
+    serial businessDaysBetween(serial from, serial to, bool includeFirst,
+                               bool includeLast) const {
+      if (from == to) {
+        return 0;
+      }
+      const Size lo = Size(std::min(from, to) - firstSerial);
+      const Size hi = Size(std::max(from, to) - firstSerial);
+      serial wd = count[hi + 1] - count[lo];
+      wd -= !includeFirst && isBusinessDay(from);
+      wd -= !includeLast && isBusinessDay(to);
+      return from > to ? -wd : wd;
+    }
+  };
+
+  void checkCalendar(Checker& checker, const Calendar& calendar) {
+    const std::string name = calendar.name();
+
+    Rules rules;
+    rules.business.resize(dayCount);
+    checker.run("isBusinessDay", name, dayCount,
+                [&](Size lo, Size hi, Tally& t) {
+        for (Size i = lo; i < hi; ++i) {
+          const serial s = firstSerial + serial(i);
+          const bool reference = calendar.isBusinessDay(Date(s));
+          rules.business[i] = reference;
+          t.compare(calendar.isBusinessDayUnchecked(Date::unchecked(s)),
+                    reference, s);
+        }
+      });
+    rules.count.resize(dayCount + 1, 0);
+    for (Size i = 0; i < dayCount; ++i) {
+      rules.count[i + 1] = rules.count[i] + rules.business[i];
+    }
+
+    const Size inner = dayCount - 2 * margin;
+    for (Size c = 0; c < sizeof(conventions) / sizeof(conventions[0]); ++c) {
+      const BusinessDayConvention convention = conventions[c];
+      std::ostringstream check;
+      check << "adjust " << convention;
+      checker.run(check.str(), name, inner,
+                  [&](Size lo, Size hi, Tally& t) {
+          std::vector<serial> serials(hi - lo), adjusted(hi - lo);
+          for (Size i = lo; i < hi; ++i) {
+            serials[i - lo] = firstSerial + margin + serial(i);
+          }
+          calendar.adjust(&serials[0], serials.size(), &adjusted[0],
+                          convention);
+          for (Size i = 0; i < serials.size(); ++i) {
+            t.compare(adjusted[i],
+                      calendar.adjust(Date(serials[i]),
+                                      convention).serialNumber(),
+                      serials[i]);
+          }
+        });
+    }
+
+    // the day-by-day loop of the rules is slow: a sample of start dates
+    // checks that it agrees with the running count
+    const Size stride = 61;
+    checker.run("businessDaysBetween (rules)", name, dayCount / stride,
+                [&](Size lo, Size hi, Tally& t) {
+        for (Size i = lo; i < hi; ++i) {
+          const serial s = firstSerial + serial(i * stride);
+          for (int flags = 0; flags < 4; ++flags) {
+            const bool includeFirst = (flags & 1) != 0;
+            const bool includeLast = (flags & 2) != 0;
+            const serial e = rangeEnd(s, Size(flags));
+            t.compare(calendar.businessDaysBetween(Date(s), Date(e),
+                                                   includeFirst,
+                                                   includeLast),
+                      rules.businessDaysBetween(s, e, includeFirst,
+                                                includeLast),
+                      s, e);
+          }
+        }
+      });
+
+    // the bitmap searches and counts with the kernels of the CPU tier
+    const BusinessDayBitmap bitmap(calendar);
+    for (int tier = 0; tier <= as_integer(detectedCpuTier()); ++tier) {
+      const ScopedCpuTier scope((CpuTier(tier)));
+      const std::string subject = describe(name, CpuTier(tier));
+
+      checker.run("bitmap", subject, dayCount,
+                  [&](Size lo, Size hi, Tally& t) {
+          for (Size i = lo; i < hi; ++i) {
+            const serial s = firstSerial + serial(i);
+            t.compare(bitmap.isBusinessDay(s), rules.isBusinessDay(s), s);
+            if (s < firstSerial + margin || s > lastSerial - margin) {
+              continue;
+            }
+            serial next = s, previous = s;
+            while (!rules.isBusinessDay(next)) {
+              ++next;
+            }
+            while (!rules.isBusinessDay(previous)) {
+              --previous;
+            }
+            t.compare(bitmap.following(s), next, s);
+            t.compare(bitmap.preceding(s), previous, s);
+          }
+        });
+
+      checker.run("bitmap businessDaysBetween", subject, dayCount,
+                  [&](Size lo, Size hi, Tally& t) {
+          const Size n = hi - lo;
+          std::vector<serial> from(n), to(n), counts(n);
+          for (int flags = 0; flags < 4; ++flags) {
+            const bool includeFirst = (flags & 1) != 0;
+            const bool includeLast = (flags & 2) != 0;
+            for (Size i = 0; i < n; ++i) {
+              from[i] = firstSerial + serial(lo + i);
+              to[i] = rangeEnd(from[i], Size(flags));
+            }
+            bitmap.businessDaysBetween(&from[0], &to[0], n, &counts[0],
+                                       includeFirst, includeLast);
+            for (Size i = 0; i < n; ++i) {
+              const serial reference = rules.businessDaysBetween(
+                from[i], to[i], includeFirst, includeLast);
+              t.compare(counts[i], reference, from[i], to[i]);
+              t.compare(bitmap.businessDaysBetween(from[i], to[i],
+                                                   includeFirst, includeLast),
+                        reference, from[i], to[i]);
+            }
+          }
+        });
+    }
+  }
+
+  void checkDateKernels(Checker& checker) {
+    for (int tier = 0; tier <= as_integer(detectedCpuTier()); ++tier) {
+      const ScopedCpuTier scope((CpuTier(tier)));
+      const std::string subject = describe("all dates", CpuTier(tier));
+      checker.run("decompose", subject, dayCount,
+                  [&](Size lo, Size hi, Tally& t) {
+          const Size n = hi - lo;
+          std::vector<serial> serials(n);
+          std::vector<Year> years(n);
+          std::vector<Integer> months(n);
+          std::vector<Day> days(n);
+          for (Size i = 0; i < n; ++i) {
+            serials[i] = firstSerial + serial(lo + i);
+          }
+          kernels::decompose(&serials[0], n, &years[0], &months[0], &days[0]);
+          for (Size i = 0; i < n; ++i) {
+            const Date d(serials[i]);
+            t.compare(years[i], d.year(), serials[i]);
+            t.compare(months[i], Integer(d.month()), serials[i]);
+            t.compare(days[i], d.dayOfMonth(), serials[i]);
+          }
+        });
+      checker.run("dayCounts", subject, dayCount,
+                  [&](Size lo, Size hi, Tally& t) {
+          const Size n = hi - lo;
+          std::vector<serial> d1(n), d2(n), counts(n);
+          for (Size i = 0; i < n; ++i) {
+            d1[i] = firstSerial + serial(lo + i);
+            d2[i] = firstSerial + serial(mix(d1[i], 0) % dayCount);
+          }
+          kernels::dayCounts(&d1[0], &d2[0], n, &counts[0]);
+          for (Size i = 0; i < n; ++i) {
+            t.compare(counts[i], Date(d2[i]) - Date(d1[i]), d1[i], d2[i]);
+          }
+        });
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  // pairs starting on every stride-th date, ending at usual coupon
+  // distances or at random within ten years
+  void checkDayCounter(Checker& checker, const DayCounter& dayCounter,
+                       Size stride) {
+    const serial offsets[] = { 0, 1, 30, 31, 59, 90, 181, 182, 365, 366 };
+    const Size fixed = sizeof(offsets) / sizeof(offsets[0]);
+    const Size perDate = fixed + 2;
+
+    checker.run("yearFraction/dayCount", dayCounter.name(), dayCount / stride,
+                [&](Size lo, Size hi, Tally& t) {
+        std::vector<serial> d1, d2;
+        for (Size i = lo; i < hi; ++i) {
+          const serial s = firstSerial + serial(i * stride);
+          for (Size k = 0; k < perDate; ++k) {
+            const serial e = k < fixed
+              ? s + offsets[k]
+              : s + serial(mix(s, k) % 3653);
+            if (e <= lastSerial) {
+              d1.push_back(std::min(s, e));
+              d2.push_back(std::max(s, e));
+            }
+          }
+        }
+        // the batch methods throw as a whole; the pairs are then
+        // compared one by one
+        const Size n = d1.size();
+        std::vector<Time> fractions(n);
+        std::vector<serial> counts(n);
+        const bool batch = !attempt([&]() {
+            dayCounter.yearFractions(&d1[0], &d2[0], n, &fractions[0]);
+            dayCounter.dayCounts(&d1[0], &d2[0], n, &counts[0]);
+            return 0;
+          }).threw;
+
+        for (Size i = 0; i < n; ++i) {
+          const Date start(d1[i]), end(d2[i]);
+          const Date uncheckedStart = Date::unchecked(d1[i]);
+          const Date uncheckedEnd = Date::unchecked(d2[i]);
+          const Outcome<Time> fraction = attempt([&]() {
+              return dayCounter.yearFraction(start, end);
+            });
+          const Outcome<serial> days = attempt([&]() {
+              return dayCounter.dayCount(start, end);
+            });
+          t.compare(attempt([&]() {
+                return dayCounter.yearFractionUnchecked(uncheckedStart,
+                                                        uncheckedEnd);
+              }), fraction, d1[i], d2[i]);
+          t.compare(attempt([&]() {
+                return dayCounter.dayCountUnchecked(uncheckedStart,
+                                                    uncheckedEnd);
+              }), days, d1[i], d2[i]);
+          if (batch) {
+            t.compare(fractions[i], fraction.value, d1[i], d2[i]);
+            t.compare(counts[i], days.value, d1[i], d2[i]);
+          }
+        }
+      });
+  }
+
+}
+
+int main() {
+  typedef std::chrono::steady_clock clock;
+  const clock::time_point start = clock::now();
+
+  try {
+    Checker checker;
+    std::cout << "comparing fast paths over " << show(firstSerial) << " - "
+              << show(lastSerial) << " with " << checker.workers() + 1
+              << " threads" << std::endl;
+
+    std::vector<Calendar> calendars;
+    calendars.push_back(Australia());
+    calendars.push_back(Brazil::Settlement());
+    calendars.push_back(Brazil::Exchange());
+    calendars.push_back(NullCalendar());
+    calendars.push_back(TARGET());
+    calendars.push_back(UnitedKingdom::Settlement());
+    calendars.push_back(UnitedKingdom::Exchange());
+    calendars.push_back(UnitedKingdom::Metals());
+    calendars.push_back(UnitedStates::Settlement());
+    calendars.push_back(UnitedStates::NYSE());
+    calendars.push_back(UnitedStates::GovernmentBond());
+    calendars.push_back(UnitedStates::NERC());
+
+    std::cout << "\ncalendars" << std::endl;
+    for (Size i = 0; i < calendars.size(); ++i) {
+      checkCalendar(checker, calendars[i]);
+    }
+
+    std::cout << "\ndate kernels" << std::endl;
+    checkDateKernels(checker);
+
+    std::cout << "\nday counters" << std::endl;
+    checkDayCounter(checker, Actual360(), 1);
+    checkDayCounter(checker, Actual365Fixed(), 1);
+    checkDayCounter(checker, ActualActual(ActualActual::Convention::ISMA), 1);
+    checkDayCounter(checker, ActualActual(ActualActual::Convention::ISDA), 1);
+    checkDayCounter(checker, ActualActual(ActualActual::Convention::AFB), 1);
+    checkDayCounter(checker, OneDayCounter(), 1);
+    checkDayCounter(checker, SimpleDayCounter(), 1);
+    checkDayCounter(checker, Thirty360(Thirty360::Convention::USA), 1);
+    checkDayCounter(checker, Thirty360(Thirty360::Convention::European), 1);
+    checkDayCounter(checker, Thirty360(Thirty360::Convention::Italian), 1);
+    // business days are counted one by one
+    checkDayCounter(checker, Business252(TARGET()), 409);
+
+    std::cout << "\n" << checker.failures() << " failed checks in "
+              << std::fixed << std::setprecision(1)
+              << std::chrono::duration<double>(clock::now() - start).count()
+              << "s" << std::endl;
+    return checker.failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
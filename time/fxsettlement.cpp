@@ -0,0 +1,229 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/civil.hpp>
+#include <time/fxsettlement.hpp>
+
+#include <algorithm>
+
+namespace MathFin {
+
+  FxSettlement::FxSettlement(const std::vector<Calendar>& calendars,
+                             Integer spotLag,
+                             const Calendar& usd)
+    : spotLag_(spotLag),
+      first_(Date::minDate().serialNumber()),
+      last_(Date::maxDate().serialNumber()) {
+    MF_REQUIRE(!calendars.empty(), "no currency calendar provided");
+    for (Size j = 0; j < calendars.size(); ++j) {
+      MF_REQUIRE(!calendars[j].empty(), "no calendar provided");
+    }
+    MF_REQUIRE(!usd.empty(), "no USD calendar provided");
+    MF_REQUIRE(spotLag >= 0, "negative spot lag (" << spotLag << ")");
+
+    MF_TRACE_SPAN("FxSettlement::FxSettlement", "calendar");
+    const Size n = Size(last_ - first_ + 1);
+    ranks_.resize(n);
+    // days counting against the spot lag
+    std::vector<boost::int32_t> counted;
+    boost::int32_t rank = 0;
+    for (Size i = 0; i < n; ++i) {
+      const Date::serial_type s = first_ + Date::serial_type(i);
+      const Date d = Date::unchecked(s);
+      bool currencies = true;
+      for (Size j = 0; j < calendars.size() && currencies; ++j) {
+        currencies = calendars[j].isBusinessDayUnchecked(d);
+      }
+      const bool value = currencies && usd.isBusinessDayUnchecked(d);
+      if (value) {
+        valueDates_.push_back(s);
+        ++rank;
+      }
+      ranks_[i] = rank;
+      if (spotLag_ == 1 ? value : currencies) {
+        counted.push_back(s);
+      }
+    }
+
+    spotDates_.assign(n, 0);
+    Size k = 0;
+    for (Size i = 0; i < n; ++i) {
+      const Date::serial_type s = first_ + Date::serial_type(i);
+      // k becomes the number of counted days up to the trade date
+      while (k < counted.size() && counted[k] <= s) {
+        ++k;
+      }
+      Date::serial_type d = s;
+      if (spotLag_ > 0) {
+        if (k + spotLag_ > counted.size()) {
+          break;
+        }
+        d = counted[k + spotLag_ - 1];
+      }
+      const Size next = d == first_ ? 0 : Size(ranks_[d - first_ - 1]);
+      if (next == valueDates_.size()) {
+        break;
+      }
+      spotDates_[i] = valueDates_[next];
+    }
+  }
+
+  FxSettlement::FxSettlement(const Calendar& calendar1,
+                             const Calendar& calendar2,
+                             Integer spotLag,
+                             const Calendar& usd)
+    : FxSettlement(std::vector<Calendar>{ calendar1, calendar2 },
+                   spotLag, usd) {}
+
+  void FxSettlement::check(BigInteger serialNumber) const {
+    MF_REQUIRE(serialNumber >= first_ && serialNumber <= last_,
+               "serial number (" << serialNumber << ") outside allowed range ["
+               << first_ << ", " << last_ << "]");
+  }
+
+  Date::serial_type FxSettlement::following(
+    Date::serial_type serialNumber) const {
+    const Size next = serialNumber == first_
+      ? 0 : Size(ranks_[serialNumber - first_ - 1]);
+    MF_REQUIRE(next < valueDates_.size(), "no value date on or after "
+               << Date::unchecked(serialNumber));
+    return valueDates_[next];
+  }
+
+  Date::serial_type FxSettlement::preceding(
+    Date::serial_type serialNumber) const {
+    const Size count = Size(ranks_[serialNumber - first_]);
+    MF_REQUIRE(count > 0, "no value date on or before "
+               << Date::unchecked(serialNumber));
+    return valueDates_[count - 1];
+  }
+
+  Date::serial_type FxSettlement::spot(Date::serial_type tradeDate) const {
+    check(tradeDate);
+    const Date::serial_type result = spotDates_[tradeDate - first_];
+    MF_REQUIRE(result != 0, "spot date of " << Date::unchecked(tradeDate)
+               << " beyond the latest allowed date");
+    return result;
+  }
+
+  Date::serial_type FxSettlement::value(Date::serial_type spot,
+                                        const Period& tenor) const {
+    const Integer n = tenor.length();
+    MF_REQUIRE(n >= 0, "negative tenor (" << tenor << ")");
+    if (n == 0) {
+      return spot;
+    }
+
+    Integer y, m, d;
+    detail::civilFromSerial(spot, y, m, d);
+    BigInteger target;
+    switch (tenor.units()) {
+    case TimeUnit::Days: {
+      // the spot date is the last value date of its rank
+      const Size i = Size(ranks_[spot - first_]) + Size(n) - 1;
+      MF_REQUIRE(i < valueDates_.size(), "value date of " << tenor
+                 << " from " << Date::unchecked(spot)
+                 << " beyond the latest allowed date");
+      return valueDates_[i];
+    }
+    case TimeUnit::Weeks:
+      target = spot + 7 * BigInteger(n);
+      check(target);
+      detail::civilFromSerial(target, y, m, d);
+      break;
+    case TimeUnit::Months:
+    case TimeUnit::Years: {
+      const BigInteger spotMonthEnd =
+        detail::serialFromCivil(y, m, detail::daysInMonth(y, m));
+      const Integer k = (m - 1)
+        + (tenor.units() == TimeUnit::Years ? 12 * n : n);
+      y += k / 12;
+      m = k % 12 + 1;
+      const Integer last = detail::daysInMonth(y, m);
+      const BigInteger monthEnd = detail::serialFromCivil(y, m, last);
+      check(monthEnd);
+      if (spot == preceding(Date::serial_type(spotMonthEnd))) {
+        return preceding(Date::serial_type(monthEnd));
+      }
+      target = detail::serialFromCivil(y, m, std::min(d, last));
+      break;
+    }
+    default:
+      MF_FAIL("tenor in " << tenor.units() << " not supported");
+    }
+
+    // modified following
+    const BigInteger monthEnd =
+      detail::serialFromCivil(y, m, detail::daysInMonth(y, m));
+    const Date::serial_type result = following(Date::serial_type(target));
+    if (result > monthEnd) {
+      return preceding(Date::serial_type(target));
+    }
+    return result;
+  }
+
+  bool FxSettlement::isValueDate(const Date& d) const {
+    const Date::serial_type s = d.serialNumber();
+    check(s);
+    const Size i = Size(s - first_);
+    return ranks_[i] != (i == 0 ? 0 : ranks_[i - 1]);
+  }
+
+  Date FxSettlement::spotDate(const Date& tradeDate) const {
+    return Date::unchecked(spot(tradeDate.serialNumber()));
+  }
+
+  Date FxSettlement::valueDate(const Date& tradeDate,
+                               const Period& tenor) const {
+    return Date::unchecked(value(spot(tradeDate.serialNumber()), tenor));
+  }
+
+  void FxSettlement::spotDates(const Date::serial_type* tradeDates,
+                               Size n,
+                               Date::serial_type* result) const {
+    MF_TRACE_SPAN("FxSettlement::spotDates", "calendar");
+    for (Size i = 0; i < n; ++i) {
+      result[i] = spot(tradeDates[i]);
+    }
+  }
+
+  void FxSettlement::valueDates(const Date& tradeDate,
+                                const Period* tenors,
+                                Size n,
+                                Date::serial_type* result) const {
+    MF_TRACE_SPAN("FxSettlement::valueDates", "calendar");
+    const Date::serial_type s = spot(tradeDate.serialNumber());
+    for (Size i = 0; i < n; ++i) {
+      result[i] = value(s, tenors[i]);
+    }
+  }
+
+  void FxSettlement::valueDates(const Date::serial_type* tradeDates,
+                                const Period* tenors,
+                                Size n,
+                                Date::serial_type* result) const {
+    MF_TRACE_SPAN("FxSettlement::valueDates", "calendar");
+    for (Size i = 0; i < n; ++i) {
+      result[i] = value(spot(tradeDates[i]), tenors[i]);
+    }
+  }
+
+}
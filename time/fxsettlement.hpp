@@ -0,0 +1,147 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file fxsettlement.hpp
+ * @brief spot and forward value dates of currency pairs
+ */
+
+#ifndef MATHFIN_FXSETTLEMENT_HPP
+#define MATHFIN_FXSETTLEMENT_HPP
+
+#include <time/calendar.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/period.hpp>
+
+#include <boost/cstdint.hpp>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Spot and forward value dates of a currency pair.
+   *
+   * The spot date is found by counting the spot lag in days that are
+   * business days for every currency of the pair other than USD, then
+   * rolling forward to a value date, that is a business day for all those
+   * currencies and for USD.  A USD holiday therefore does not count
+   * against the lag of a T+2 pair but never is a value date.  For T+1
+   * pairs (such as USD/CAD) the days counted must be value dates too.
+   *
+   * Forward value dates are measured from spot: day tenors count value
+   * dates, other tenors add calendar time and roll by the modified
+   * following convention, and month tenors from a spot date that is the
+   * last value date of its month end on the last value date of the
+   * target month.
+   *
+   * The spot date of every trade date and the rank of every value date
+   * are tabulated over the whole range of valid dates on construction,
+   * so that each lookup takes constant time.  Like BusinessDayBitmap the
+   * tables are a snapshot of the calendars.
+   *
+   * @ingroup datetime
+   */
+  class FxSettlement {
+  public:
+    /**
+     * @param calendars calendars of the currencies of the pair other than
+     *                  USD; one for a USD pair, two for a cross
+     * @param spotLag   settlement lag in business days
+     * @param usd       calendar of USD settlement
+     */
+    explicit FxSettlement(
+      const std::vector<Calendar>& calendars,
+      Integer spotLag = 2,
+      const Calendar& usd = UnitedStates::Settlement());
+
+    /**
+     * Currency pair settling on the joint business days of the given
+     * calendars and USD.
+     */
+    FxSettlement(const Calendar& calendar1,
+                 const Calendar& calendar2,
+                 Integer spotLag = 2,
+                 const Calendar& usd = UnitedStates::Settlement());
+
+    Integer spotLag() const { return spotLag_; }
+
+    /**
+     * Whether the date is a business day for every currency and USD.
+     */
+    bool isValueDate(const Date& d) const;
+
+    Date spotDate(const Date& tradeDate) const;
+
+    /**
+     * Value date of the given tenor, counted from the spot date of the
+     * trade date; a zero tenor gives the spot date.
+     */
+    Date valueDate(const Date& tradeDate, const Period& tenor) const;
+
+    /**
+     * @name batch operations
+     * @{
+     */
+
+    /**
+     * Spot dates of <tt>n</tt> trade dates.
+     */
+    void spotDates(const Date::serial_type* tradeDates,
+                   Size n,
+                   Date::serial_type* result) const;
+
+    /**
+     * Value dates of a grid of <tt>n</tt> tenors for one trade date.
+     */
+    void valueDates(const Date& tradeDate,
+                    const Period* tenors,
+                    Size n,
+                    Date::serial_type* result) const;
+
+    /**
+     * Value dates of <tt>n</tt> trades, each with its own trade date and
+     * tenor.
+     */
+    void valueDates(const Date::serial_type* tradeDates,
+                    const Period* tenors,
+                    Size n,
+                    Date::serial_type* result) const;
+
+    /** @} */
+
+  private:
+    void check(BigInteger serialNumber) const;
+    Date::serial_type spot(Date::serial_type tradeDate) const;
+    Date::serial_type value(Date::serial_type spot, const Period& tenor) const;
+    Date::serial_type following(Date::serial_type serialNumber) const;
+    Date::serial_type preceding(Date::serial_type serialNumber) const;
+
+    Integer spotLag_;
+    Date::serial_type first_, last_;
+    // value dates up to and including each day
+    std::vector<boost::int32_t> ranks_;
+    // value dates in order
+    std::vector<boost::int32_t> valueDates_;
+    // spot date of each trade date; 0 where it lies beyond the range
+    std::vector<boost::int32_t> spotDates_;
+  };
+
+}
+
+#endif /* MATHFIN_FXSETTLEMENT_HPP */
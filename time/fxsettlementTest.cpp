@@ -0,0 +1,197 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/fxsettlement.hpp>
+
+using namespace MathFin;
+
+namespace {
+
+  // straightforward rules on the calendars themselves
+  struct Reference {
+    Reference(const std::vector<Calendar>& calendars, Integer lag)
+      : calendars(calendars), usd(UnitedStates::Settlement()), lag(lag) {}
+
+    std::vector<Calendar> calendars;
+    Calendar usd;
+    Integer lag;
+
+    bool currencies(Date::serial_type s) const {
+      for (Size j = 0; j < calendars.size(); ++j) {
+        if (!calendars[j].isBusinessDay(Date(s))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool value(Date::serial_type s) const {
+      return currencies(s) && usd.isBusinessDay(Date(s));
+    }
+
+    Date::serial_type spot(Date::serial_type s) const {
+      for (Integer k = 0; k < lag; ) {
+        ++s;
+        if (lag == 1 ? value(s) : currencies(s)) {
+          ++k;
+        }
+      }
+      while (!value(s)) {
+        ++s;
+      }
+      return s;
+    }
+
+    Date::serial_type valueDate(Date::serial_type spot, const Period& p) const {
+      if (p.units() == TimeUnit::Days) {
+        for (Integer k = 0; k < p.length(); ) {
+          if (value(++spot)) {
+            ++k;
+          }
+        }
+        return spot;
+      }
+      const Date s(spot);
+      Date::serial_type monthEnd = Date::endOfMonth(s).serialNumber();
+      while (!value(monthEnd)) {
+        --monthEnd;
+      }
+      const Date target = s + p;
+      if (p.units() != TimeUnit::Weeks && spot == monthEnd) {
+        Date::serial_type d = Date::endOfMonth(target).serialNumber();
+        while (!value(d)) {
+          --d;
+        }
+        return d;
+      }
+      Date::serial_type d = target.serialNumber();
+      while (!value(d)) {
+        ++d;
+      }
+      if (Date(d).month() != target.month()) {
+        d = target.serialNumber();
+        while (!value(d)) {
+          --d;
+        }
+      }
+      return d;
+    }
+  };
+
+}
+
+TEST_CASE("FX spot dates skip USD holidays only on spot", "[fx]") {
+  const FxSettlement gbpusd(std::vector<Calendar>(1, UnitedKingdom()));
+
+  // 3 July 2015 was a USD holiday and a GBP business day
+  REQUIRE(gbpusd.spotDate(Date(1, Month::July, 2015))
+          == Date(6, Month::July, 2015));
+  REQUIRE(gbpusd.spotDate(Date(2, Month::July, 2015))
+          == Date(6, Month::July, 2015));
+  REQUIRE(!gbpusd.isValueDate(Date(3, Month::July, 2015)));
+  REQUIRE(gbpusd.isValueDate(Date(6, Month::July, 2015)));
+
+  // a T+1 pair counts the USD holiday as a non-business day
+  const FxSettlement t1(std::vector<Calendar>(1, UnitedKingdom()), 1);
+  REQUIRE(t1.spotDate(Date(2, Month::July, 2015))
+          == Date(6, Month::July, 2015));
+  REQUIRE(t1.spotDate(Date(1, Month::July, 2015))
+          == Date(2, Month::July, 2015));
+
+  // the month-end rule and modified following
+  REQUIRE(gbpusd.valueDate(Date(25, Month::February, 2015),
+                           Period(1, TimeUnit::Months))
+          == Date(31, Month::March, 2015));
+  REQUIRE(gbpusd.valueDate(Date(27, Month::January, 2015),
+                           Period(1, TimeUnit::Months))
+          == Date(27, Month::February, 2015));
+  REQUIRE(gbpusd.valueDate(Date(1, Month::July, 2015),
+                           Period(0, TimeUnit::Days))
+          == Date(6, Month::July, 2015));
+
+  REQUIRE_THROWS_AS(gbpusd.valueDate(Date(1, Month::July, 2015),
+                                     Period(-1, TimeUnit::Months)), Error);
+  REQUIRE_THROWS_AS(gbpusd.spotDate(Date::maxDate()), Error);
+  REQUIRE_THROWS_AS(FxSettlement(std::vector<Calendar>()), Error);
+}
+
+TEST_CASE("FX value dates match the calendar rules", "[fx]") {
+  const Period tenors[] = {
+    Period(0, TimeUnit::Days), Period(1, TimeUnit::Days),
+    Period(3, TimeUnit::Days), Period(1, TimeUnit::Weeks),
+    Period(2, TimeUnit::Weeks), Period(1, TimeUnit::Months),
+    Period(2, TimeUnit::Months), Period(3, TimeUnit::Months),
+    Period(6, TimeUnit::Months), Period(9, TimeUnit::Months),
+    Period(1, TimeUnit::Years), Period(18, TimeUnit::Months),
+    Period(2, TimeUnit::Years), Period(5, TimeUnit::Years)
+  };
+  const Size tenorCount = sizeof(tenors) / sizeof(tenors[0]);
+
+  std::vector<Reference> references;
+  references.push_back(Reference(std::vector<Calendar>(1, TARGET()), 2));
+  references.push_back(
+    Reference(std::vector<Calendar>{ TARGET(), UnitedKingdom() }, 2));
+  references.push_back(
+    Reference(std::vector<Calendar>(1, UnitedKingdom()), 1));
+
+  const Date::serial_type from = Date(1, Month::December, 2014).serialNumber();
+  const Date::serial_type to = Date(31, Month::January, 2016).serialNumber();
+  std::vector<Date::serial_type> trades;
+  std::vector<Period> tradeTenors;
+  for (Date::serial_type s = from; s <= to; ++s) {
+    trades.push_back(s);
+    tradeTenors.push_back(tenors[s % tenorCount]);
+  }
+
+  for (Size r = 0; r < references.size(); ++r) {
+    const Reference& reference = references[r];
+    const FxSettlement engine(reference.calendars, reference.lag);
+
+    std::vector<Date::serial_type> spots(trades.size());
+    engine.spotDates(&trades[0], trades.size(), &spots[0]);
+    std::vector<Date::serial_type> values(trades.size());
+    engine.valueDates(&trades[0], &tradeTenors[0], trades.size(), &values[0]);
+    std::vector<Date::serial_type> grid(tenorCount);
+
+    for (Size i = 0; i < trades.size(); ++i) {
+      const Date::serial_type spot = reference.spot(trades[i]);
+      REQUIRE(spots[i] == spot);
+      REQUIRE(values[i] == reference.valueDate(spot, tradeTenors[i]));
+      engine.valueDates(Date(trades[i]), tenors, tenorCount, &grid[0]);
+      for (Size j = 0; j < tenorCount; ++j) {
+        if (grid[j] != reference.valueDate(spot, tenors[j])) {
+          FAIL("tenor " << tenors[j] << " traded " << Date(trades[i])
+               << ": " << Date(grid[j]) << " instead of "
+               << Date(reference.valueDate(spot, tenors[j])));
+        }
+      }
+    }
+
+    REQUIRE_HOT_PATH(engine.spotDates(&trades[0], trades.size(), &spots[0]));
+    REQUIRE_HOT_PATH(engine.valueDates(Date(trades[0]), tenors, tenorCount,
+                                       &grid[0]));
+  }
+}
@@ -0,0 +1,143 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define MATHFIN_HOTPATH_HOOKS
+
+#include <stdexcept>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/calendars/australia.hpp>
+#include <time/calendars/brazil.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actual365fixed.hpp>
+#include <time/daycounters/actualactual.hpp>
+#include <time/daycounters/business252.hpp>
+#include <time/daycounters/thirty360.hpp>
+
+using namespace MathFin;
+
+namespace {
+  const BusinessDayConvention conventions[] = {
+    BusinessDayConvention::Following,
+    BusinessDayConvention::ModifiedFollowing,
+    BusinessDayConvention::Preceding,
+    BusinessDayConvention::ModifiedPreceding,
+    BusinessDayConvention::Unadjusted,
+    BusinessDayConvention::HalfMonthModifiedFollowing,
+    BusinessDayConvention::Nearest
+  };
+
+  std::vector<Calendar> calendars() {
+    std::vector<Calendar> result;
+    result.push_back(Australia());
+    result.push_back(Brazil());
+    result.push_back(TARGET());
+    result.push_back(UnitedKingdom());
+    result.push_back(UnitedStates());
+    return result;
+  }
+
+  std::vector<DayCounter> dayCounters() {
+    std::vector<DayCounter> result;
+    result.push_back(Actual360());
+    result.push_back(Actual365Fixed());
+    result.push_back(ActualActual(ActualActual::Convention::ISDA));
+    result.push_back(ActualActual(ActualActual::Convention::ISMA));
+    result.push_back(ActualActual(ActualActual::Convention::AFB));
+    result.push_back(Business252(TARGET()));
+    result.push_back(Thirty360(Thirty360::Convention::BondBasis));
+    result.push_back(Thirty360(Thirty360::Convention::EurobondBasis));
+    result.push_back(Thirty360(Thirty360::Convention::Italian));
+    return result;
+  }
+}
+
+TEST_CASE("Hot-path harness detects allocations and exceptions",
+          "[hotpath]") {
+  // Catch assertions allocate, so counts are read before checking them
+  test::HotPathGuard guard;
+  const Size before = guard.allocations();
+  std::vector<int>* v = new std::vector<int>(10);
+  delete v;
+  const Size after = guard.allocations();
+  REQUIRE(before == 0);
+  REQUIRE(after == 2);
+
+  if (test::hotPathCountsExceptions()) {
+    test::HotPathGuard throwing;
+    try {
+      throw std::runtime_error("");
+    } catch (std::exception&) {}
+    const Size exceptions = throwing.exceptions();
+    REQUIRE(exceptions == 1);
+  }
+}
+
+TEST_CASE("Date arithmetic does not allocate", "[hotpath]") {
+  const Date d(31, Month::January, 2016);
+  const TimeUnit units[] = {
+    TimeUnit::Days, TimeUnit::Weeks, TimeUnit::Months, TimeUnit::Years
+  };
+  for (Size i = 0; i < sizeof(units) / sizeof(units[0]); ++i) {
+    const Period p(13, units[i]);
+    REQUIRE_HOT_PATH(d + p);
+    REQUIRE_HOT_PATH(d - p);
+  }
+  REQUIRE_HOT_PATH(d + 100);
+  REQUIRE_HOT_PATH(Date::endOfMonth(d));
+  REQUIRE_HOT_PATH(Date::create(29, Month::February, 2017));
+}
+
+TEST_CASE("Calendar queries do not allocate", "[hotpath]") {
+  const std::vector<Calendar> all = calendars();
+  const Date start(20, Month::December, 2016);
+  for (Size i = 0; i < all.size(); ++i) {
+    const Calendar& calendar = all[i];
+    for (Integer n = 0; n < 21; ++n) {
+      const Date d = start + n;
+      REQUIRE_HOT_PATH(calendar.isBusinessDay(d));
+      REQUIRE_HOT_PATH(calendar.isHoliday(d));
+      for (Size j = 0; j < sizeof(conventions) / sizeof(conventions[0]); ++j) {
+        REQUIRE_HOT_PATH(calendar.adjust(d, conventions[j]));
+      }
+      REQUIRE_HOT_PATH(calendar.advance(d, Period(2, TimeUnit::Days)));
+    }
+    REQUIRE_HOT_PATH(calendar == all[i]);
+    REQUIRE_HOT_PATH(calendar == all[(i + 1) % all.size()]);
+  }
+}
+
+TEST_CASE("Day counters do not allocate", "[hotpath]") {
+  const std::vector<DayCounter> all = dayCounters();
+  const Date d1(15, Month::February, 2016);
+  const Date d2(31, Month::August, 2017);
+  for (Size i = 0; i < all.size(); ++i) {
+    const DayCounter& dayCounter = all[i];
+    REQUIRE_HOT_PATH(dayCounter.dayCount(d1, d2));
+    REQUIRE_HOT_PATH(dayCounter.yearFraction(d1, d2));
+    REQUIRE_HOT_PATH(dayCounter.yearFraction(d1, d2, d1, d2));
+    REQUIRE_HOT_PATH(dayCounter == all[i]);
+    REQUIRE_HOT_PATH(dayCounter == all[(i + 1) % all.size()]);
+  }
+}
@@ -0,0 +1,197 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/indexconventions.hpp>
+
+namespace MathFin {
+
+  namespace {
+    // maturities computed per call to the day counter
+    const Size batchGrain = 1024;
+  }
+
+  IndexConventions::IndexConventions(const Period& tenor,
+                                     Natural fixingDays,
+                                     const Calendar& fixingCalendar,
+                                     BusinessDayConvention convention,
+                                     bool endOfMonth,
+                                     const DayCounter& dayCounter,
+                                     const Date& from,
+                                     const Date& to)
+    : tenor_(tenor), fixingDays_(fixingDays),
+      fixingCalendar_(fixingCalendar), convention_(convention),
+      endOfMonth_(endOfMonth), dayCounter_(dayCounter),
+      first_(from.serialNumber()), last_(to.serialNumber()) {
+    MF_REQUIRE(!fixingCalendar.empty(), "no calendar provided");
+    MF_REQUIRE(!dayCounter.empty(), "no day counter provided");
+    MF_REQUIRE(from <= to, "'from' date ("
+               << from << ") must not be later than 'to' date ("
+               << to << ")");
+    MF_REQUIRE(tenor.length() > 0, "positive tenor required, "
+               << tenor.length() << " given");
+
+    MF_TRACE_SPAN("IndexConventions::IndexConventions", "calendar");
+    const Size n = Size(last_ - first_ + 1);
+    const Date latest = Date::maxDate();
+
+    // business days of the range, and how many there are up to each day
+    std::vector<boost::int32_t> business;
+    std::vector<boost::int32_t> ranks(n);
+    for (Size i = 0; i < n; ++i) {
+      const Date::serial_type s = first_ + Date::serial_type(i);
+      if (fixingCalendar.isBusinessDayUnchecked(Date::unchecked(s))) {
+        business.push_back(s);
+      }
+      ranks[i] = boost::int32_t(business.size());
+    }
+
+    const Size lag = fixingDays_;
+    fixingDates_.assign(n, 0);
+    valueDates_.assign(n, 0);
+    maturityDates_.assign(n, 0);
+    for (Size i = 0; i < n; ++i) {
+      if (lag == 0) {
+        // advancing by no days adjusts to the following business day
+        const Size next = i == 0 ? 0 : Size(ranks[i - 1]);
+        if (next < business.size()) {
+          fixingDates_[i] = valueDates_[i] = business[next];
+        }
+      } else {
+        // lag-th business day before and after the date, both excluded
+        const Size before = i == 0 ? 0 : Size(ranks[i - 1]);
+        if (before >= lag) {
+          fixingDates_[i] = business[before - lag];
+        }
+        const Size after = Size(ranks[i]) + lag - 1;
+        if (after < business.size()) {
+          valueDates_[i] = business[after];
+        }
+      }
+    }
+
+    // maturities grow with the value date; the first one beyond the
+    // allowed range ends the table
+    for (Size i = 0; i < n; ++i) {
+      const Date::serial_type s = first_ + Date::serial_type(i);
+      try {
+        const Date maturity = fixingCalendar.advance(
+          Date::unchecked(s), tenor_, convention_, endOfMonth_);
+        if (maturity > latest) {
+          break;
+        }
+        maturityDates_[i] = maturity.serialNumber();
+      } catch (Error&) {
+        break;
+      }
+    }
+  }
+
+  Date::serial_type IndexConventions::fixing(
+    Date::serial_type valueDate) const {
+    if (valueDate >= first_ && valueDate <= last_) {
+      const boost::int32_t result = fixingDates_[valueDate - first_];
+      if (result != 0) {
+        return result;
+      }
+    }
+    return fixingCalendar_.advance(
+      Date(valueDate), -Integer(fixingDays_), TimeUnit::Days).serialNumber();
+  }
+
+  Date::serial_type IndexConventions::value(
+    Date::serial_type fixingDate) const {
+    if (fixingDate >= first_ && fixingDate <= last_) {
+      const boost::int32_t result = valueDates_[fixingDate - first_];
+      if (result != 0) {
+        return result;
+      }
+    }
+    return fixingCalendar_.advance(
+      Date(fixingDate), Integer(fixingDays_), TimeUnit::Days).serialNumber();
+  }
+
+  Date::serial_type IndexConventions::maturity(
+    Date::serial_type valueDate) const {
+    if (valueDate >= first_ && valueDate <= last_) {
+      const boost::int32_t result = maturityDates_[valueDate - first_];
+      if (result != 0) {
+        return result;
+      }
+    }
+    return fixingCalendar_.advance(
+      Date(valueDate), tenor_, convention_, endOfMonth_).serialNumber();
+  }
+
+  Date IndexConventions::fixingDate(const Date& valueDate) const {
+    return Date(fixing(valueDate.serialNumber()));
+  }
+
+  Date IndexConventions::valueDate(const Date& fixingDate) const {
+    return Date(value(fixingDate.serialNumber()));
+  }
+
+  Date IndexConventions::maturityDate(const Date& valueDate) const {
+    return Date(maturity(valueDate.serialNumber()));
+  }
+
+  void IndexConventions::fixingDates(const Date::serial_type* valueDates,
+                                     Size n,
+                                     Date::serial_type* result) const {
+    MF_TRACE_SPAN("IndexConventions::fixingDates", "calendar");
+    for (Size i = 0; i < n; ++i) {
+      result[i] = fixing(valueDates[i]);
+    }
+  }
+
+  void IndexConventions::valueDates(const Date::serial_type* fixingDates,
+                                    Size n,
+                                    Date::serial_type* result) const {
+    MF_TRACE_SPAN("IndexConventions::valueDates", "calendar");
+    for (Size i = 0; i < n; ++i) {
+      result[i] = value(fixingDates[i]);
+    }
+  }
+
+  void IndexConventions::maturityDates(const Date::serial_type* valueDates,
+                                       Size n,
+                                       Date::serial_type* result) const {
+    MF_TRACE_SPAN("IndexConventions::maturityDates", "calendar");
+    for (Size i = 0; i < n; ++i) {
+      result[i] = maturity(valueDates[i]);
+    }
+  }
+
+  void IndexConventions::accrualFractions(const Date::serial_type* valueDates,
+                                          Size n,
+                                          Time* result) const {
+    MF_TRACE_SPAN("IndexConventions::accrualFractions", "calendar");
+    Date::serial_type maturities[batchGrain];
+    for (Size lo = 0; lo < n; lo += batchGrain) {
+      const Size count = std::min(n - lo, batchGrain);
+      maturityDates(valueDates + lo, count, maturities);
+      dayCounter_.yearFractions(valueDates + lo, maturities, count,
+                                result + lo);
+    }
+  }
+
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file indexconventions.hpp
+ * @brief fixing, value and maturity dates of interest-rate indexes
+ */
+
+#ifndef MATHFIN_INDEXCONVENTIONS_HPP
+#define MATHFIN_INDEXCONVENTIONS_HPP
+
+#include <time/businessdayconvention.hpp>
+#include <time/calendar.hpp>
+#include <time/daycounter.hpp>
+#include <time/period.hpp>
+
+#include <boost/cstdint.hpp>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Date conventions of an interest-rate index.
+   *
+   * An index fixes <tt>fixingDays</tt> business days of the fixing
+   * calendar before its value date and matures one tenor after it,
+   * adjusted by the business-day convention; its fixings accrue by the
+   * day counter.  The dates are those of Calendar::advance().
+   *
+   * The fixing date, value date and maturity date of every day between
+   * <tt>from</tt> and <tt>to</tt> are tabulated on construction so that
+   * each lookup takes constant time instead of walking the calendar; the
+   * few dates whose results fall outside the tables, and dates outside
+   * the range, are computed on the calendar.  The tables are a snapshot
+   * of the calendar.
+   *
+   * @ingroup datetime
+   */
+  class IndexConventions {
+  public:
+    IndexConventions(const Period& tenor,
+                     Natural fixingDays,
+                     const Calendar& fixingCalendar,
+                     BusinessDayConvention convention,
+                     bool endOfMonth,
+                     const DayCounter& dayCounter,
+                     const Date& from = Date::minDate(),
+                     const Date& to = Date::maxDate());
+
+    const Period& tenor() const { return tenor_; }
+    Natural fixingDays() const { return fixingDays_; }
+    const Calendar& fixingCalendar() const { return fixingCalendar_; }
+    BusinessDayConvention convention() const { return convention_; }
+    bool endOfMonth() const { return endOfMonth_; }
+    const DayCounter& dayCounter() const { return dayCounter_; }
+
+    /**
+     * Fixing date of the given value (accrual start) date.
+     */
+    Date fixingDate(const Date& valueDate) const;
+
+    /**
+     * Value date of the given fixing date.
+     */
+    Date valueDate(const Date& fixingDate) const;
+
+    /**
+     * Maturity date of the given value date.
+     */
+    Date maturityDate(const Date& valueDate) const;
+
+    /**
+     * @name batch operations
+     * @{
+     */
+
+    void fixingDates(const Date::serial_type* valueDates,
+                     Size n,
+                     Date::serial_type* result) const;
+
+    void valueDates(const Date::serial_type* fixingDates,
+                    Size n,
+                    Date::serial_type* result) const;
+
+    void maturityDates(const Date::serial_type* valueDates,
+                       Size n,
+                       Date::serial_type* result) const;
+
+    /**
+     * Year fractions from the given value dates to their maturities.
+     */
+    void accrualFractions(const Date::serial_type* valueDates,
+                          Size n,
+                          Time* result) const;
+
+    /** @} */
+
+  private:
+    Date::serial_type fixing(Date::serial_type valueDate) const;
+    Date::serial_type value(Date::serial_type fixingDate) const;
+    Date::serial_type maturity(Date::serial_type valueDate) const;
+
+    const Period tenor_;
+    const Natural fixingDays_;
+    const Calendar fixingCalendar_;
+    const BusinessDayConvention convention_;
+    const bool endOfMonth_;
+    const DayCounter dayCounter_;
+
+    Date::serial_type first_, last_;
+    // by day from first_; 0 where not tabulated
+    std::vector<boost::int32_t> fixingDates_;
+    std::vector<boost::int32_t> valueDates_;
+    std::vector<boost::int32_t> maturityDates_;
+  };
+
+}
+
+#endif /* MATHFIN_INDEXCONVENTIONS_HPP */
@@ -0,0 +1,117 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actual365fixed.hpp>
+#include <time/indexconventions.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Index conventions give the dates of Calendar::advance",
+          "[indexconventions]") {
+  const Date from(1, Month::January, 2015);
+  const Date to(31, Month::December, 2016);
+  std::vector<IndexConventions> indexes;
+  // Euribor 3M, GBP Libor 6M, 1W and 2-day-lagged daily indexes
+  indexes.push_back(IndexConventions(Period(3, TimeUnit::Months), 2, TARGET(),
+                                     BusinessDayConvention::ModifiedFollowing,
+                                     true, Actual360(), from, to));
+  indexes.push_back(IndexConventions(Period(6, TimeUnit::Months), 0,
+                                     UnitedKingdom(),
+                                     BusinessDayConvention::ModifiedFollowing,
+                                     true, Actual365Fixed(), from, to));
+  indexes.push_back(IndexConventions(Period(1, TimeUnit::Weeks), 2, TARGET(),
+                                     BusinessDayConvention::Following,
+                                     false, Actual360(), from, to));
+  indexes.push_back(IndexConventions(Period(1, TimeUnit::Days), 1,
+                                     UnitedKingdom(),
+                                     BusinessDayConvention::Following,
+                                     false, Actual365Fixed(), from, to));
+
+  // a margin beyond the tables checks the fall-back to the calendar
+  std::vector<Date::serial_type> dates;
+  for (Date::serial_type s = from.serialNumber() - 40;
+       s <= to.serialNumber() + 40; ++s) {
+    dates.push_back(s);
+  }
+  const Size n = dates.size();
+
+  for (Size k = 0; k < indexes.size(); ++k) {
+    const IndexConventions& index = indexes[k];
+    const Calendar& calendar = index.fixingCalendar();
+    const Integer lag = Integer(index.fixingDays());
+
+    std::vector<Date::serial_type> fixings(n), values(n), maturities(n);
+    std::vector<Time> fractions(n);
+    index.fixingDates(&dates[0], n, &fixings[0]);
+    index.valueDates(&dates[0], n, &values[0]);
+    index.maturityDates(&dates[0], n, &maturities[0]);
+    index.accrualFractions(&dates[0], n, &fractions[0]);
+
+    for (Size i = 0; i < n; ++i) {
+      const Date d(dates[i]);
+      const Date fixing = calendar.advance(d, -lag, TimeUnit::Days);
+      const Date value = calendar.advance(d, lag, TimeUnit::Days);
+      const Date maturity = calendar.advance(d, index.tenor(),
+                                             index.convention(),
+                                             index.endOfMonth());
+      INFO("index " << k << ", date " << d);
+      REQUIRE(fixings[i] == fixing.serialNumber());
+      REQUIRE(values[i] == value.serialNumber());
+      REQUIRE(maturities[i] == maturity.serialNumber());
+      REQUIRE(fractions[i] == index.dayCounter().yearFraction(d, maturity));
+      REQUIRE(index.fixingDate(d) == fixing);
+      REQUIRE(index.valueDate(d) == value);
+      REQUIRE(index.maturityDate(d) == maturity);
+    }
+
+    // within the tables, lookups neither allocate nor throw
+    const Size inner = 40;
+    REQUIRE_HOT_PATH(index.fixingDates(&dates[inner], n - 2 * inner,
+                                       &fixings[0]));
+    REQUIRE_HOT_PATH(index.maturityDates(&dates[inner], n - 2 * inner,
+                                         &maturities[0]));
+    REQUIRE_HOT_PATH(index.accrualFractions(&dates[inner], n - 2 * inner,
+                                            &fractions[0]));
+  }
+}
+
+TEST_CASE("Index conventions cover the whole date range by default",
+          "[indexconventions]") {
+  const IndexConventions euribor(Period(1, TimeUnit::Years), 2, TARGET(),
+                                 BusinessDayConvention::ModifiedFollowing,
+                                 true, Actual360());
+  const Date first = Date::minDate();
+  REQUIRE(euribor.valueDate(first) == TARGET().advance(first, 2,
+                                                       TimeUnit::Days));
+  const Date late(1, Month::March, 2199);
+  REQUIRE(euribor.fixingDate(late) == TARGET().advance(late, -2,
+                                                       TimeUnit::Days));
+  REQUIRE_THROWS_AS(euribor.maturityDate(late), Error);
+
+  REQUIRE_THROWS_AS(IndexConventions(Period(0, TimeUnit::Months), 2, TARGET(),
+                                     BusinessDayConvention::Following, false,
+                                     Actual360()), Error);
+}
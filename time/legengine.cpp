@@ -0,0 +1,202 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/threadpool.hpp>
+#include <base/trace.hpp>
+#include <time/legengine.hpp>
+
+namespace MathFin {
+
+  Leg::Leg(const Schedule& schedule,
+           const std::vector<Real>& notionals,
+           Rate rate,
+           const DayCounter& dayCounter,
+           BusinessDayConvention paymentConvention,
+           Natural paymentLag)
+    : schedule_(&schedule), notionals_(notionals), rates_(1, rate),
+      spread_(0.0), dayCounter_(dayCounter),
+      paymentConvention_(paymentConvention), paymentLag_(paymentLag) {
+    validate();
+  }
+
+  Leg::Leg(const Schedule& schedule,
+           const std::vector<Real>& notionals,
+           const std::vector<Rate>& rates,
+           Spread spread,
+           const DayCounter& dayCounter,
+           BusinessDayConvention paymentConvention,
+           Natural paymentLag)
+    : schedule_(&schedule), notionals_(notionals), rates_(rates),
+      spread_(spread), dayCounter_(dayCounter),
+      paymentConvention_(paymentConvention), paymentLag_(paymentLag) {
+    validate();
+  }
+
+  void Leg::validate() const {
+    MF_REQUIRE(schedule_->size() >= 2,
+               "at least two schedule dates required, "
+               << schedule_->size() << " given");
+    MF_REQUIRE(!dayCounter_.empty(), "no day counter provided");
+    MF_REQUIRE(notionals_.size() == 1 || notionals_.size() == size(),
+               "one notional or one per coupon (" << size()
+               << ") required, " << notionals_.size() << " given");
+    MF_REQUIRE(rates_.size() == 1 || rates_.size() == size(),
+               "one rate or one per coupon (" << size()
+               << ") required, " << rates_.size() << " given");
+  }
+
+  void Leg::referencePeriod(Size i,
+                            Date::serial_type& start,
+                            Date::serial_type& end) const {
+    const Schedule& schedule = *schedule_;
+    const Date::serial_type accrualStart = schedule.serialNumbers()[i];
+    const Date::serial_type accrualEnd = schedule.serialNumbers()[i + 1];
+    start = accrualStart;
+    end = accrualEnd;
+    const Period& tenor = schedule.tenor();
+    if (schedule.rule() == DateGeneration::Zero || tenor.length() == 0) {
+      return;
+    }
+
+    const Calendar& calendar = schedule.calendar();
+    const bool endOfMonth = schedule.endOfMonth()
+      && (tenor.units() == TimeUnit::Months
+          || tenor.units() == TimeUnit::Years);
+    if (i == 0 && !schedule.isRegular(1)) {
+      const Date from = Date::unchecked(accrualEnd);
+      const bool monthEnd = endOfMonth && calendar.isEndOfMonth(from);
+      start = (monthEnd ? Date::endOfMonth(from - tenor)
+                        : from - tenor).serialNumber();
+    }
+    if (i + 1 == size() && !schedule.isRegular(i + 1)) {
+      const Date from = Date::unchecked(accrualStart);
+      const bool monthEnd = endOfMonth && calendar.isEndOfMonth(from);
+      end = (monthEnd ? Date::endOfMonth(from + tenor)
+                      : from + tenor).serialNumber();
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  void CashFlows::resize(Size n) {
+    accrualStartDates.resize(n);
+    accrualEndDates.resize(n);
+    paymentDates.resize(n);
+    accrualFractions.resize(n);
+    notionals.resize(n);
+    rates.resize(n);
+    amounts.resize(n);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  Size LegEngine::size(const std::vector<Leg>& legs) {
+    Size n = 0;
+    for (Size j = 0; j < legs.size(); ++j) {
+      n += legs[j].size();
+    }
+    return n;
+  }
+
+  void LegEngine::generate(const std::vector<Leg>& legs,
+                           CashFlows& result,
+                           ThreadPool* pool) {
+    MF_TRACE_SPAN("LegEngine::generate", "legs");
+    result.legOffsets.resize(legs.size() + 1);
+    result.legOffsets[0] = 0;
+    for (Size j = 0; j < legs.size(); ++j) {
+      result.legOffsets[j + 1] = result.legOffsets[j] + legs[j].size();
+    }
+    result.resize(result.legOffsets.back());
+
+    parallelFor(pool, 0, legs.size(), 1, [&](Size lo, Size hi) {
+        for (Size j = lo; j < hi; ++j) {
+          const Size k = result.legOffsets[j];
+          generate(legs[j],
+                   &result.accrualStartDates[k],
+                   &result.accrualEndDates[k],
+                   &result.paymentDates[k],
+                   &result.accrualFractions[k],
+                   &result.notionals[k],
+                   &result.rates[k],
+                   &result.amounts[k]);
+        }
+      });
+  }
+
+  void LegEngine::generate(const Leg& leg,
+                           Date::serial_type* accrualStartDates,
+                           Date::serial_type* accrualEndDates,
+                           Date::serial_type* paymentDates,
+                           Time* accrualFractions,
+                           Real* notionals,
+                           Rate* rates,
+                           Real* amounts) {
+    const Size n = leg.size();
+    const Date::serial_type* dates = &leg.schedule().serialNumbers()[0];
+    for (Size i = 0; i < n; ++i) {
+      accrualStartDates[i] = dates[i];
+      accrualEndDates[i] = dates[i + 1];
+    }
+
+    const Calendar& calendar = leg.schedule().calendar();
+    if (leg.paymentLag() == 0) {
+      calendar.adjust(accrualEndDates, n, paymentDates,
+                      leg.paymentConvention());
+    } else {
+      // as Calendar::advance() by business days: the lag counts business
+      // days strictly after the end of the accrual period
+      for (Size i = 0; i < n; ++i) {
+        Date::serial_type d = accrualEndDates[i];
+        for (Natural left = leg.paymentLag(); left > 0; ) {
+          ++d;
+          if (calendar.isBusinessDayUnchecked(Date::unchecked(d))) {
+            --left;
+          }
+        }
+        paymentDates[i] = d;
+      }
+    }
+
+    leg.dayCounter().yearFractions(accrualStartDates, accrualEndDates,
+                                   accrualStartDates, accrualEndDates,
+                                   n, accrualFractions);
+    // only the first and last coupons can be stubs
+    const Size stubs[] = { 0, n - 1 };
+    for (Size k = 0; k < (n > 1 ? 2 : 1); ++k) {
+      const Size i = stubs[k];
+      Date::serial_type refStart, refEnd;
+      leg.referencePeriod(i, refStart, refEnd);
+      if (refStart != accrualStartDates[i] || refEnd != accrualEndDates[i]) {
+        accrualFractions[i] = leg.dayCounter().yearFraction(
+          Date::unchecked(accrualStartDates[i]),
+          Date::unchecked(accrualEndDates[i]),
+          Date::unchecked(refStart), Date::unchecked(refEnd));
+      }
+    }
+
+    for (Size i = 0; i < n; ++i) {
+      notionals[i] = leg.notional(i);
+      rates[i] = leg.rate(i) + leg.spread();
+      amounts[i] = notionals[i] * rates[i] * accrualFractions[i];
+    }
+  }
+
+}
@@ -0,0 +1,200 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file legengine.hpp
+ * @brief accrual and payment cash flows of fixed and floating legs
+ */
+
+#ifndef MATHFIN_LEGENGINE_HPP
+#define MATHFIN_LEGENGINE_HPP
+
+#include <time/businessdayconvention.hpp>
+#include <time/daycounter.hpp>
+#include <time/schedule.hpp>
+
+#include <vector>
+
+namespace MathFin {
+
+  class ThreadPool;
+
+  /**
+   * Description of a leg of coupons.
+   *
+   * Coupon <tt>i</tt> accrues from date <tt>i</tt> to date <tt>i + 1</tt>
+   * of the schedule at <tt>rate(i) + spread()</tt> on <tt>notional(i)</tt>,
+   * and is paid <tt>paymentLag</tt> business days after the end of its
+   * accrual period, adjusted on the schedule calendar.  Stub coupons
+   * accrue against a notional regular period (see referencePeriod()).
+   * Notionals and rates are given either once for the whole leg or once
+   * per coupon; the rates of a floating leg are its fixings or forecasts.
+   *
+   * The leg refers to the schedule, which must outlive it.
+   *
+   * @ingroup datetime
+   */
+  class Leg {
+  public:
+    /**
+     * Fixed-rate leg.
+     */
+    Leg(const Schedule& schedule,
+        const std::vector<Real>& notionals,
+        Rate rate,
+        const DayCounter& dayCounter,
+        BusinessDayConvention paymentConvention =
+          BusinessDayConvention::Following,
+        Natural paymentLag = 0);
+
+    /**
+     * Floating leg paying the given rates plus a spread.
+     */
+    Leg(const Schedule& schedule,
+        const std::vector<Real>& notionals,
+        const std::vector<Rate>& rates,
+        Spread spread,
+        const DayCounter& dayCounter,
+        BusinessDayConvention paymentConvention =
+          BusinessDayConvention::Following,
+        Natural paymentLag = 0);
+
+    /**
+     * Number of coupons.
+     */
+    Size size() const { return schedule_->size() - 1; }
+
+    const Schedule& schedule() const { return *schedule_; }
+    Real notional(Size i) const {
+      return notionals_.size() == 1 ? notionals_[0] : notionals_[i];
+    }
+    Rate rate(Size i) const {
+      return rates_.size() == 1 ? rates_[0] : rates_[i];
+    }
+    Spread spread() const { return spread_; }
+    const DayCounter& dayCounter() const { return dayCounter_; }
+    BusinessDayConvention paymentConvention() const {
+      return paymentConvention_;
+    }
+    Natural paymentLag() const { return paymentLag_; }
+
+    /**
+     * Reference period of coupon <tt>i</tt> for the day counter: its
+     * accrual period, or for a short or long first (last) coupon, as told
+     * by Schedule::isRegular(), the notional regular period ending
+     * (starting) at its end (start) date, one schedule tenor away.
+     */
+    void referencePeriod(Size i,
+                         Date::serial_type& start,
+                         Date::serial_type& end) const;
+
+  private:
+    void validate() const;
+
+    const Schedule* schedule_;
+    std::vector<Real> notionals_;
+    std::vector<Rate> rates_;
+    Spread spread_;
+    DayCounter dayCounter_;
+    BusinessDayConvention paymentConvention_;
+    Natural paymentLag_;
+  };
+
+  /**
+   * Coupons of a set of legs, stored as one array per field.
+   *
+   * The coupons of leg <tt>j</tt> occupy the positions from
+   * <tt>legOffsets[j]</tt> to <tt>legOffsets[j + 1]</tt>, in schedule
+   * order.  Keeping each field contiguous lets pricing and aggregation
+   * loops stream through millions of coupons touching only the fields
+   * they need.
+   */
+  struct CashFlows {
+    std::vector<Size> legOffsets;
+    std::vector<Date::serial_type> accrualStartDates;
+    std::vector<Date::serial_type> accrualEndDates;
+    std::vector<Date::serial_type> paymentDates;
+    std::vector<Time> accrualFractions;
+    std::vector<Real> notionals;
+    std::vector<Rate> rates;
+    std::vector<Real> amounts;
+
+    /**
+     * Total number of coupons.
+     */
+    Size size() const { return amounts.size(); }
+
+    /**
+     * Number of legs.
+     */
+    Size legs() const {
+      return legOffsets.empty() ? 0 : legOffsets.size() - 1;
+    }
+
+    /**
+     * Resizes every field for the given number of coupons.
+     */
+    void resize(Size n);
+  };
+
+  /**
+   * Generation of the coupons of legs into CashFlows.
+   *
+   * Each leg is filled with the batch paths of its calendar and day
+   * counter: accrual dates are copied from the schedule, payment dates
+   * adjusted in one Calendar::adjust() call and accrual fractions taken
+   * in one DayCounter::yearFractions() call, with the accrual period as
+   * reference period; the fractions of stub coupons are then taken
+   * against their notional regular period.  The buffers are sized once
+   * for all legs; when a thread pool is given, the legs are filled in
+   * parallel, each by a single thread.
+   *
+   * Reusing a CashFlows of the right size allocates no memory.
+   */
+  class LegEngine {
+  public:
+    /**
+     * Number of coupons of the given legs.
+     */
+    static Size size(const std::vector<Leg>& legs);
+
+    /**
+     * Fills <tt>result</tt> with the coupons of the given legs.
+     */
+    static void generate(const std::vector<Leg>& legs,
+                         CashFlows& result,
+                         ThreadPool* pool = 0);
+
+    /**
+     * Fills the coupons of a single leg into the given buffers, which
+     * must hold <tt>leg.size()</tt> elements each.
+     */
+    static void generate(const Leg& leg,
+                         Date::serial_type* accrualStartDates,
+                         Date::serial_type* accrualEndDates,
+                         Date::serial_type* paymentDates,
+                         Time* accrualFractions,
+                         Real* notionals,
+                         Rate* rates,
+                         Real* amounts);
+  };
+
+}
+
+#endif /* MATHFIN_LEGENGINE_HPP */
@@ -0,0 +1,209 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <vector>
+
+#include <base/threadpool.hpp>
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actualactual.hpp>
+#include <time/daycounters/thirty360.hpp>
+#include <time/legengine.hpp>
+
+using namespace MathFin;
+
+namespace {
+
+  Schedule makeSchedule(const Date& start, const Date& end,
+                        const Period& tenor, const Calendar& calendar) {
+    return Schedule(start, end, tenor, calendar,
+                    BusinessDayConvention::ModifiedFollowing,
+                    BusinessDayConvention::ModifiedFollowing,
+                    DateGeneration::Backward, false);
+  }
+
+  // coupons of the leg computed one by one on dates
+  void checkLeg(const Leg& leg, const CashFlows& flows, Size offset) {
+    const Schedule& schedule = leg.schedule();
+    const Calendar& calendar = schedule.calendar();
+    for (Size i = 0; i < leg.size(); ++i) {
+      const Size k = offset + i;
+      const Date start = schedule[i];
+      const Date end = schedule[i + 1];
+      const Date payment = leg.paymentLag() == 0
+        ? calendar.adjust(end, leg.paymentConvention())
+        : calendar.advance(end, Integer(leg.paymentLag()), TimeUnit::Days);
+      Date::serial_type refStart, refEnd;
+      leg.referencePeriod(i, refStart, refEnd);
+      const Time fraction = leg.dayCounter().yearFraction(
+        start, end, Date(refStart), Date(refEnd));
+      const Rate rate = leg.rate(i) + leg.spread();
+      REQUIRE(flows.accrualStartDates[k] == start.serialNumber());
+      REQUIRE(flows.accrualEndDates[k] == end.serialNumber());
+      REQUIRE(flows.paymentDates[k] == payment.serialNumber());
+      REQUIRE(flows.accrualFractions[k] == fraction);
+      REQUIRE(flows.notionals[k] == leg.notional(i));
+      REQUIRE(flows.rates[k] == rate);
+      REQUIRE(flows.amounts[k] == leg.notional(i) * rate * fraction);
+    }
+  }
+
+}
+
+TEST_CASE("Leg engine matches coupon-by-coupon computation", "[legengine]") {
+  const Schedule fixedSchedule =
+    makeSchedule(Date(15, Month::March, 2016), Date(15, Month::March, 2026),
+                 Period(6, TimeUnit::Months), UnitedStates::GovernmentBond());
+  const Schedule floatingSchedule =
+    makeSchedule(Date(17, Month::May, 2016), Date(17, Month::May, 2021),
+                 Period(3, TimeUnit::Months), TARGET());
+
+  // amortizing notionals and forecast rates on the floating leg
+  std::vector<Real> amortizing;
+  std::vector<Rate> forecasts;
+  for (Size i = 0; i + 1 < floatingSchedule.size(); ++i) {
+    amortizing.push_back(1.0e6 - 40000.0 * i);
+    forecasts.push_back(0.001 * i - 0.003);
+  }
+
+  std::vector<Leg> legs;
+  legs.push_back(Leg(fixedSchedule, std::vector<Real>(1, 1.0e6), 0.0125,
+                     ActualActual(ActualActual::Convention::ISMA)));
+  legs.push_back(Leg(floatingSchedule, amortizing, forecasts, 0.0035,
+                     Actual360(), BusinessDayConvention::ModifiedFollowing,
+                     2));
+  legs.push_back(Leg(fixedSchedule, std::vector<Real>(1, 5.0e5), 0.02,
+                     Thirty360(), BusinessDayConvention::Preceding));
+
+  CashFlows flows;
+  LegEngine::generate(legs, flows);
+  REQUIRE(flows.legs() == 3);
+  REQUIRE(flows.size() == LegEngine::size(legs));
+  for (Size j = 0; j < legs.size(); ++j) {
+    REQUIRE(flows.legOffsets[j + 1] - flows.legOffsets[j] == legs[j].size());
+    checkLeg(legs[j], flows, flows.legOffsets[j]);
+  }
+
+  SECTION("legs filled in parallel give the same coupons") {
+    std::vector<Leg> many;
+    for (Size j = 0; j < 50; ++j) {
+      many.push_back(legs[j % legs.size()]);
+    }
+    CashFlows sequential, parallel;
+    LegEngine::generate(many, sequential);
+    ThreadPool pool(3);
+    LegEngine::generate(many, parallel, &pool);
+    REQUIRE(parallel.legOffsets == sequential.legOffsets);
+    REQUIRE(parallel.paymentDates == sequential.paymentDates);
+    REQUIRE(parallel.accrualFractions == sequential.accrualFractions);
+    REQUIRE(parallel.amounts == sequential.amounts);
+  }
+
+  SECTION("regenerating into buffers of the right size does not allocate") {
+    REQUIRE_HOT_PATH(LegEngine::generate(legs, flows));
+  }
+}
+
+TEST_CASE("Stub coupons accrue against their notional period",
+          "[legengine]") {
+  const ActualActual isma(ActualActual::Convention::ISMA);
+  const Schedule shortFirst(Date(15, Month::February, 2017),
+                            Date(31, Month::December, 2017),
+                            Period(3, TimeUnit::Months), TARGET(),
+                            BusinessDayConvention::ModifiedFollowing,
+                            BusinessDayConvention::ModifiedFollowing,
+                            DateGeneration::Backward, false);
+  const Schedule shortLast(Date(15, Month::February, 2017),
+                           Date(31, Month::December, 2017),
+                           Period(3, TimeUnit::Months), TARGET(),
+                           BusinessDayConvention::ModifiedFollowing,
+                           BusinessDayConvention::ModifiedFollowing,
+                           DateGeneration::Forward, false);
+  std::vector<Leg> legs;
+  legs.push_back(Leg(shortFirst, std::vector<Real>(1, 100.0), 0.04, isma));
+  legs.push_back(Leg(shortLast, std::vector<Real>(1, 100.0), 0.04, isma));
+
+  CashFlows flows;
+  LegEngine::generate(legs, flows);
+  for (Size j = 0; j < legs.size(); ++j) {
+    checkLeg(legs[j], flows, flows.legOffsets[j]);
+  }
+
+  // 44 days of the 90 from 31-Dec-2016 to 31-Mar-2017
+  Date::serial_type refStart, refEnd;
+  legs[0].referencePeriod(0, refStart, refEnd);
+  REQUIRE(Date(refStart) == Date(31, Month::December, 2016));
+  REQUIRE(std::fabs(flows.accrualFractions[0] - 0.25 * 44 / 90) < 1.0e-15);
+  // the regular coupons accrue a quarter
+  for (Size i = 1; i < legs[0].size(); ++i) {
+    legs[0].referencePeriod(i, refStart, refEnd);
+    REQUIRE(refStart == legs[0].schedule()[i].serialNumber());
+    REQUIRE(refEnd == legs[0].schedule()[i + 1].serialNumber());
+    REQUIRE(flows.accrualFractions[i] == 0.25);
+  }
+
+  // 44 days, to 29-Dec-2017, of the 92 from 15-Nov-2017 to 15-Feb-2018
+  const Size last = flows.legOffsets[2] - 1;
+  legs[1].referencePeriod(legs[1].size() - 1, refStart, refEnd);
+  REQUIRE(Date(refEnd) == Date(15, Month::February, 2018));
+  REQUIRE(std::fabs(flows.accrualFractions[last] - 0.25 * 44 / 92)
+          < 1.0e-15);
+}
+
+TEST_CASE("Stubs close to a regular period are not taken for regular",
+          "[legengine]") {
+  // the schedule rolls back to 15-Dec-2016, four days before its start
+  const Schedule schedule(Date(19, Month::December, 2016),
+                          Date(15, Month::December, 2017),
+                          Period(3, TimeUnit::Months), TARGET(),
+                          BusinessDayConvention::ModifiedFollowing,
+                          BusinessDayConvention::ModifiedFollowing,
+                          DateGeneration::Backward, false);
+  std::vector<Leg> legs(1, Leg(schedule, std::vector<Real>(1, 100.0), 0.04,
+                               ActualActual(ActualActual::Convention::ISMA)));
+  CashFlows flows;
+  LegEngine::generate(legs, flows);
+  checkLeg(legs[0], flows, 0);
+
+  // 86 days of the 90 from 15-Dec-2016 to 15-Mar-2017
+  Date::serial_type refStart, refEnd;
+  legs[0].referencePeriod(0, refStart, refEnd);
+  REQUIRE(Date(refStart) == Date(15, Month::December, 2016));
+  REQUIRE(Date(refEnd) == Date(15, Month::March, 2017));
+  REQUIRE(std::fabs(flows.accrualFractions[0] - 0.25 * 86 / 90) < 1.0e-15);
+  REQUIRE(flows.accrualFractions[legs[0].size() - 1] == 0.25);
+}
+
+TEST_CASE("Leg descriptions are validated", "[legengine]") {
+  const Schedule schedule =
+    makeSchedule(Date(15, Month::March, 2016), Date(15, Month::March, 2018),
+                 Period(6, TimeUnit::Months), TARGET());
+  REQUIRE(Leg(schedule, std::vector<Real>(1, 100.0), 0.01,
+              Actual360()).size() == 4);
+  REQUIRE_THROWS_AS(Leg(schedule, std::vector<Real>(3, 100.0), 0.01,
+                        Actual360()), Error);
+  REQUIRE_THROWS_AS(Leg(schedule, std::vector<Real>(1, 100.0),
+                        std::vector<Rate>(5, 0.01), 0.0, Actual360()), Error);
+  REQUIRE_THROWS_AS(Leg(schedule, std::vector<Real>(1, 100.0), 0.01,
+                        DayCounter()), Error);
+}
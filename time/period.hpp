@@ -98,9 +98,8 @@ namespace MathFin {
     const Period normalize() const;
 
   private:
-    Period& operator=(const Period&);
-    const Integer  length_;
-    const TimeUnit units_;
+    Integer  length_;
+    TimeUnit units_;
   };
 
   /**
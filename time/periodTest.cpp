@@ -53,6 +53,13 @@ namespace MathFin {
     REQUIRE(oneYear == tmp);
   }
 
+  TEST_CASE("Assignment", "[period]") {
+    Period p(3, TimeUnit::Months);
+    p = Period(2, TimeUnit::Years);
+    REQUIRE(p.length() == 2);
+    REQUIRE(p.units() == TimeUnit::Years);
+  }
+
   TEST_CASE("Divide a period by n", "[period]") {
     Period sixMonths(6, TimeUnit::Months);
     Period threeMonths = sixMonths / 2;
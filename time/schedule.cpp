@@ -0,0 +1,114 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <time/schedule.hpp>
+
+namespace MathFin {
+
+  Schedule::Schedule(const Date& effectiveDate,
+                     const Date& terminationDate,
+                     const Period& tenor,
+                     const Calendar& calendar,
+                     BusinessDayConvention convention,
+                     BusinessDayConvention terminationDateConvention,
+                     DateGeneration rule,
+                     bool endOfMonth)
+    : calendar_(calendar), tenor_(tenor), convention_(convention),
+      terminationDateConvention_(terminationDateConvention), rule_(rule),
+      endOfMonth_(endOfMonth), firstPeriodRegular_(true),
+      lastPeriodRegular_(true) {
+    generate(effectiveDate, terminationDate, tenor, calendar, convention,
+             terminationDateConvention, rule, endOfMonth, dates_,
+             firstPeriodRegular_, lastPeriodRegular_);
+  }
+
+  Schedule::Schedule(const std::vector<Date::serial_type>& dates,
+                     const Period& tenor,
+                     const Calendar& calendar,
+                     BusinessDayConvention convention,
+                     BusinessDayConvention terminationDateConvention,
+                     DateGeneration rule,
+                     bool endOfMonth,
+                     bool firstPeriodRegular,
+                     bool lastPeriodRegular)
+    : calendar_(calendar), tenor_(tenor), convention_(convention),
+      terminationDateConvention_(terminationDateConvention), rule_(rule),
+      endOfMonth_(endOfMonth), firstPeriodRegular_(firstPeriodRegular),
+      lastPeriodRegular_(lastPeriodRegular), dates_(dates) {
+    MF_REQUIRE(!calendar.empty(), "no calendar provided");
+    MF_REQUIRE(dates.size() >= 2, "at least two dates required, "
+               << dates.size() << " given");
+    for (Size i = 1; i < dates.size(); ++i) {
+      MF_REQUIRE(dates[i - 1] < dates[i], "dates must be increasing: date "
+                 << i << " (" << Date::unchecked(dates[i])
+                 << ") does not follow " << Date::unchecked(dates[i - 1]));
+    }
+  }
+
+  DateVector Schedule::dates() const {
+    DateVector result;
+    result.reserve(dates_.size());
+    for (Size i = 0; i < dates_.size(); ++i) {
+      result.push_back(Date::unchecked(dates_[i]));
+    }
+    return result;
+  }
+
+  void Schedule::check(const Date& effectiveDate,
+                       const Date& terminationDate,
+                       const Period& tenor,
+                       const Calendar& calendar,
+                       DateGeneration rule) {
+    MF_REQUIRE(!calendar.empty(), "no calendar provided");
+    MF_REQUIRE(effectiveDate < terminationDate, "effective date ("
+               << effectiveDate << ") must be earlier than termination date ("
+               << terminationDate << ")");
+    MF_REQUIRE(rule == DateGeneration::Forward
+               || rule == DateGeneration::Backward
+               || rule == DateGeneration::Zero,
+               "date generation rule " << rule << " not supported");
+    MF_REQUIRE(rule == DateGeneration::Zero || tenor.length() > 0,
+               "positive tenor required, " << tenor.length() << " given");
+    MF_REQUIRE(tenor.units() == TimeUnit::Days
+               || tenor.units() == TimeUnit::Weeks
+               || tenor.units() == TimeUnit::Months
+               || tenor.units() == TimeUnit::Years,
+               "tenor in " << tenor.units() << " not supported");
+  }
+
+  Date::serial_type Schedule::rollDate(const Date& seed,
+                                       const Period& tenor,
+                                       Integer i,
+                                       const Calendar& calendar,
+                                       BusinessDayConvention convention,
+                                       bool endOfMonth) {
+    const Date d = seed + i * tenor;
+    if (endOfMonth
+        && (tenor.units() == TimeUnit::Months
+            || tenor.units() == TimeUnit::Years)
+        && calendar.isEndOfMonth(seed)) {
+      return convention == BusinessDayConvention::Unadjusted
+        ? Date::endOfMonth(d).serialNumber()
+        : calendar.endOfMonth(d).serialNumber();
+    }
+    return d.serialNumber();
+  }
+
+}
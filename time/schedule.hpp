@@ -0,0 +1,272 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file schedule.hpp
+ * @brief payment schedules
+ */
+
+#ifndef MATHFIN_SCHEDULE_HPP
+#define MATHFIN_SCHEDULE_HPP
+
+#include <base/trace.hpp>
+#include <time/calendar.hpp>
+#include <time/dategeneration.hpp>
+#include <time/datevector.hpp>
+#include <time/period.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Sequence of dates generated from an effective date, a termination
+   * date and a tenor, adjusted on a calendar.
+   *
+   * The Forward, Backward and Zero generation rules are supported.  With
+   * <tt>endOfMonth</tt> set and a month-based tenor, a seed date falling on
+   * the last business day of its month rolls to month ends.
+   *
+   * Dates are stored as serial numbers.  generate() writes them into a
+   * caller-provided container instead, so that batch jobs can draw the
+   * memory from an Arena or use inline storage (SerialNumberVector).
+   *
+   * @ingroup datetime
+   */
+  class Schedule {
+  public:
+    Schedule(const Date& effectiveDate,
+             const Date& terminationDate,
+             const Period& tenor,
+             const Calendar& calendar,
+             BusinessDayConvention convention,
+             BusinessDayConvention terminationDateConvention,
+             DateGeneration rule,
+             bool endOfMonth);
+
+    /**
+     * Schedule made of the given, already adjusted, dates and the
+     * parameters they were generated with, including the regularity of
+     * its first and last periods; used to restore stored schedules without
+     * generating them again.
+     */
+    Schedule(const std::vector<Date::serial_type>& dates,
+             const Period& tenor,
+             const Calendar& calendar,
+             BusinessDayConvention convention,
+             BusinessDayConvention terminationDateConvention,
+             DateGeneration rule,
+             bool endOfMonth,
+             bool firstPeriodRegular,
+             bool lastPeriodRegular);
+
+    Size size() const { return dates_.size(); }
+    Date operator[](Size i) const { return Date::unchecked(dates_[i]); }
+    Date startDate() const { return Date::unchecked(dates_.front()); }
+    Date endDate() const { return Date::unchecked(dates_.back()); }
+    const std::vector<Date::serial_type>& serialNumbers() const {
+      return dates_;
+    }
+
+    /**
+     * A copy of the schedule dates.  The copy itself does not allocate for
+     * schedules of up to 128 dates, but the schedule keeps its own serial
+     * numbers on the heap; see serialNumbers() to read them without a
+     * copy.
+     */
+    DateVector dates() const;
+
+    const Calendar& calendar() const { return calendar_; }
+    const Period& tenor() const { return tenor_; }
+    BusinessDayConvention convention() const { return convention_; }
+    BusinessDayConvention terminationDateConvention() const {
+      return terminationDateConvention_;
+    }
+    DateGeneration rule() const { return rule_; }
+    bool endOfMonth() const { return endOfMonth_; }
+
+    /**
+     * Whether the i-th period, from date i-1 to date i, spans a whole
+     * tenor, i.e. whether generation reached its unadjusted start from its
+     * unadjusted end or vice versa.  Only the first period of a Backward
+     * schedule and the last one of a Forward schedule can be stubs.
+     * @pre 1 <= i < size()
+     */
+    bool isRegular(Size i) const {
+      return (i != 1 || firstPeriodRegular_)
+        && (i + 1 != dates_.size() || lastPeriodRegular_);
+    }
+
+    /**
+     * Appends the serial numbers of the schedule dates to
+     * <tt>result</tt>, which needs <tt>push_back</tt>, <tt>size</tt>,
+     * <tt>resize</tt> and indexed access.
+     */
+    template <class Container>
+    static void generate(const Date& effectiveDate,
+                         const Date& terminationDate,
+                         const Period& tenor,
+                         const Calendar& calendar,
+                         BusinessDayConvention convention,
+                         BusinessDayConvention terminationDateConvention,
+                         DateGeneration rule,
+                         bool endOfMonth,
+                         Container& result);
+
+  private:
+    // as the public overload, also telling whether the first and last
+    // periods are regular
+    template <class Container>
+    static void generate(const Date& effectiveDate,
+                         const Date& terminationDate,
+                         const Period& tenor,
+                         const Calendar& calendar,
+                         BusinessDayConvention convention,
+                         BusinessDayConvention terminationDateConvention,
+                         DateGeneration rule,
+                         bool endOfMonth,
+                         Container& result,
+                         bool& firstPeriodRegular,
+                         bool& lastPeriodRegular);
+
+    static void check(const Date& effectiveDate,
+                      const Date& terminationDate,
+                      const Period& tenor,
+                      const Calendar& calendar,
+                      DateGeneration rule);
+
+    // unadjusted i-th date from the seed, with end-of-month rolling
+    static Date::serial_type rollDate(const Date& seed,
+                                      const Period& tenor,
+                                      Integer i,
+                                      const Calendar& calendar,
+                                      BusinessDayConvention convention,
+                                      bool endOfMonth);
+
+    const Calendar calendar_;
+    const Period tenor_;
+    const BusinessDayConvention convention_;
+    const BusinessDayConvention terminationDateConvention_;
+    const DateGeneration rule_;
+    const bool endOfMonth_;
+    bool firstPeriodRegular_;
+    bool lastPeriodRegular_;
+    std::vector<Date::serial_type> dates_;
+  };
+
+  // ---------------------------------------------------------------------------
+
+  template <class Container>
+  void Schedule::generate(const Date& effectiveDate,
+                          const Date& terminationDate,
+                          const Period& tenor,
+                          const Calendar& calendar,
+                          BusinessDayConvention convention,
+                          BusinessDayConvention terminationDateConvention,
+                          DateGeneration rule,
+                          bool endOfMonth,
+                          Container& result) {
+    bool firstPeriodRegular, lastPeriodRegular;
+    generate(effectiveDate, terminationDate, tenor, calendar, convention,
+             terminationDateConvention, rule, endOfMonth, result,
+             firstPeriodRegular, lastPeriodRegular);
+  }
+
+  template <class Container>
+  void Schedule::generate(const Date& effectiveDate,
+                          const Date& terminationDate,
+                          const Period& tenor,
+                          const Calendar& calendar,
+                          BusinessDayConvention convention,
+                          BusinessDayConvention terminationDateConvention,
+                          DateGeneration rule,
+                          bool endOfMonth,
+                          Container& result,
+                          bool& firstPeriodRegular,
+                          bool& lastPeriodRegular) {
+    check(effectiveDate, terminationDate, tenor, calendar, rule);
+    MF_COUNT(ScheduleGenerations);
+    MF_TRACE_SPAN("Schedule::generate", "schedule");
+
+    const Date::serial_type start = effectiveDate.serialNumber();
+    const Date::serial_type end = terminationDate.serialNumber();
+    const Size first = result.size();
+
+    firstPeriodRegular = lastPeriodRegular = true;
+    result.push_back(start);
+    if (rule == DateGeneration::Forward) {
+      for (Integer i = 1; ; ++i) {
+        const Date::serial_type d = rollDate(effectiveDate, tenor, i,
+                                             calendar, convention, endOfMonth);
+        if (d >= end) {
+          lastPeriodRegular = d == end;
+          break;
+        }
+        result.push_back(d);
+      }
+    } else if (rule == DateGeneration::Backward) {
+      const Size mark = result.size();
+      for (Integer i = 1; ; ++i) {
+        const Date::serial_type d = rollDate(terminationDate, tenor, -i,
+                                             calendar, convention, endOfMonth);
+        if (d <= start) {
+          firstPeriodRegular = d == start;
+          break;
+        }
+        result.push_back(d);
+      }
+      for (Size i = mark, j = result.size(); i + 1 < j; ++i, --j) {
+        std::swap(result[i], result[j - 1]);
+      }
+    }
+    result.push_back(end);
+
+    const Size last = result.size() - 1;
+    for (Size i = first; i < last; ++i) {
+      result[i] =
+        calendar.adjust(Date::unchecked(result[i]), convention).serialNumber();
+    }
+    result[last] = calendar.adjust(Date::unchecked(result[last]),
+                                   terminationDateConvention).serialNumber();
+
+    // a generated date that adjusts onto the seed at the other end (as
+    // month ends do) is that seed, so the period reaching it is regular
+    if (last > first + 1) {
+      if (result[first + 1] == result[first]) {
+        firstPeriodRegular = true;
+      }
+      if (result[last - 1] == result[last]) {
+        lastPeriodRegular = true;
+      }
+    }
+
+    // adjustment may make neighbouring dates coincide
+    Size kept = first + 1;
+    for (Size i = first + 1; i <= last; ++i) {
+      if (result[i] != result[kept - 1]) {
+        result[kept++] = result[i];
+      }
+    }
+    result.resize(kept);
+  }
+
+}
+
+#endif /* MATHFIN_SCHEDULE_HPP */
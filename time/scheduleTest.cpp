@@ -0,0 +1,166 @@
+/*
+  Copyright (C) 2016 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/arena.hpp>
+#include <base/error.hpp>
+#include <time/schedule.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedstates.hpp>
+
+using namespace MathFin;
+
+namespace {
+  void checkDates(const Schedule& s, const std::vector<Date::serial_type>& expected) {
+    REQUIRE(s.size() == expected.size());
+    for (Size i = 0; i < expected.size(); ++i) {
+      REQUIRE(s[i] == Date(expected[i]));
+    }
+  }
+}
+
+TEST_CASE("Forward and backward schedules", "[schedule]") {
+  Calendar calendar = TARGET();
+  Schedule forward(Date(15, Month::January, 2016), Date(10, Month::January, 2017),
+                   Period(3, TimeUnit::Months), calendar,
+                   BusinessDayConvention::ModifiedFollowing,
+                   BusinessDayConvention::ModifiedFollowing,
+                   DateGeneration::Forward, false);
+  checkDates(forward, {
+      Date(15, Month::January, 2016).serialNumber(),
+      Date(15, Month::April, 2016).serialNumber(),
+      Date(15, Month::July, 2016).serialNumber(),
+      Date(17, Month::October, 2016).serialNumber(),   // 15th is a Saturday
+      Date(10, Month::January, 2017).serialNumber()});
+  REQUIRE(forward.isRegular(1));
+  REQUIRE(forward.isRegular(3));    // adjusted, but generated from the seed
+  REQUIRE(!forward.isRegular(4));
+
+  Schedule backward(Date(15, Month::January, 2016), Date(10, Month::January, 2017),
+                    Period(3, TimeUnit::Months), calendar,
+                    BusinessDayConvention::Following,
+                    BusinessDayConvention::Unadjusted,
+                    DateGeneration::Backward, false);
+  checkDates(backward, {
+      Date(15, Month::January, 2016).serialNumber(),
+      Date(11, Month::April, 2016).serialNumber(),
+      Date(11, Month::July, 2016).serialNumber(),
+      Date(10, Month::October, 2016).serialNumber(),
+      Date(10, Month::January, 2017).serialNumber()});
+  REQUIRE(backward.startDate() == Date(15, Month::January, 2016));
+  REQUIRE(backward.endDate() == Date(10, Month::January, 2017));
+  REQUIRE(!backward.isRegular(1));
+  REQUIRE(backward.isRegular(2));
+  REQUIRE(backward.isRegular(4));
+
+  Schedule zero(Date(15, Month::January, 2016), Date(10, Month::January, 2017),
+                Period(3, TimeUnit::Months), calendar,
+                BusinessDayConvention::Following,
+                BusinessDayConvention::Following,
+                DateGeneration::Zero, false);
+  REQUIRE(zero.size() == 2);
+  REQUIRE(zero.isRegular(1));
+}
+
+TEST_CASE("End-of-month schedules", "[schedule]") {
+  Schedule s(Date(30, Month::September, 2016), Date(30, Month::September, 2017),
+             Period(6, TimeUnit::Months), UnitedStates::Settlement(),
+             BusinessDayConvention::ModifiedFollowing,
+             BusinessDayConvention::ModifiedFollowing,
+             DateGeneration::Forward, true);
+  checkDates(s, {
+      Date(30, Month::September, 2016).serialNumber(),
+      Date(31, Month::March, 2017).serialNumber(),
+      Date(29, Month::September, 2017).serialNumber()});
+  REQUIRE(s.isRegular(1));
+  REQUIRE(s.isRegular(2));
+}
+
+TEST_CASE("Schedule generation into an arena", "[schedule]") {
+  Calendar calendar = TARGET();
+  Schedule reference(Date(3, Month::March, 2016), Date(3, Month::March, 2026),
+                     Period(1, TimeUnit::Months), calendar,
+                     BusinessDayConvention::Following,
+                     BusinessDayConvention::Following,
+                     DateGeneration::Backward, false);
+
+  Arena arena;
+  for (int item = 0; item < 3; ++item) {
+    Arena::Scope scope(arena);
+    std::vector<Date::serial_type, ArenaAllocator<Date::serial_type> >
+      dates{ArenaAllocator<Date::serial_type>(arena)};
+    Schedule::generate(Date(3, Month::March, 2016), Date(3, Month::March, 2026),
+                       Period(1, TimeUnit::Months), calendar,
+                       BusinessDayConvention::Following,
+                       BusinessDayConvention::Following,
+                       DateGeneration::Backward, false, dates);
+    REQUIRE(std::vector<Date::serial_type>(dates.begin(), dates.end())
+            == reference.serialNumbers());
+
+    std::vector<Date, ArenaAllocator<Date> > holidays{ArenaAllocator<Date>(arena)};
+    Calendar::holidayList(calendar, Date(1, Month::January, 2016),
+                          Date(31, Month::December, 2016), holidays);
+    REQUIRE(holidays.size()
+            == Calendar::holidayList(calendar, Date(1, Month::January, 2016),
+                                     Date(31, Month::December, 2016)).size());
+
+    std::vector<Date::serial_type, ArenaAllocator<Date::serial_type> >
+      adjusted{ArenaAllocator<Date::serial_type>(arena)};
+    calendar.adjust(&reference.serialNumbers()[0], reference.size(), adjusted);
+    REQUIRE(adjusted.size() == reference.size());
+  }
+
+  REQUIRE_THROWS_AS(Schedule(Date(3, Month::March, 2016), Date(3, Month::March, 2015),
+                             Period(1, TimeUnit::Months), calendar,
+                             BusinessDayConvention::Following,
+                             BusinessDayConvention::Following,
+                             DateGeneration::Forward, false), Error);
+}
+
+TEST_CASE("Schedule dates without heap storage", "[schedule]") {
+  Calendar calendar = TARGET();
+  Schedule s(Date(20, Month::June, 2016), Date(20, Month::June, 2046),
+             Period(3, TimeUnit::Months), calendar,
+             BusinessDayConvention::ModifiedFollowing,
+             BusinessDayConvention::ModifiedFollowing,
+             DateGeneration::Backward, false);
+
+  DateVector dates = s.dates();
+  REQUIRE(dates.isInline());
+  REQUIRE(dates.size() == 121);
+  REQUIRE(dates.front() == s.startDate());
+  REQUIRE(dates.back() == s.endDate());
+
+  SerialNumberVector serials;
+  Schedule::generate(Date(20, Month::June, 2016), Date(20, Month::June, 2046),
+                     Period(3, TimeUnit::Months), calendar,
+                     BusinessDayConvention::ModifiedFollowing,
+                     BusinessDayConvention::ModifiedFollowing,
+                     DateGeneration::Backward, false, serials);
+  REQUIRE(serials.isInline());
+  for (Size i = 0; i < serials.size(); ++i) {
+    REQUIRE(serials[i] == s.serialNumbers()[i]);
+  }
+
+  PeriodVector tenors{Period(1, TimeUnit::Months), Period(3, TimeUnit::Months)};
+  tenors[0] = Period(6, TimeUnit::Months);
+  REQUIRE(tenors[0] == Period(6, TimeUnit::Months));
+}
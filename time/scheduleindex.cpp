@@ -0,0 +1,259 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/scheduleindex.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace MathFin {
+
+  namespace {
+
+    typedef std::pair<Date::serial_type, Date::serial_type> Run;
+
+    // the day together with the holidays adjacent to it
+    Run holidayRun(const Calendar& calendar, Date::serial_type s) {
+      const Date::serial_type first = Date::minDate().serialNumber();
+      const Date::serial_type last = Date::maxDate().serialNumber();
+      Date::serial_type lo = s, hi = s;
+      while (lo > first && !calendar.isBusinessDay(Date::unchecked(lo - 1))) {
+        --lo;
+      }
+      while (hi < last && !calendar.isBusinessDay(Date::unchecked(hi + 1))) {
+        ++hi;
+      }
+      return Run(lo, hi);
+    }
+
+    void addRange(const std::set<Date>& s1,
+                  const std::set<Date>& s2,
+                  Date::serial_type& first,
+                  Date::serial_type& last) {
+      std::vector<Date> changed;
+      std::set_symmetric_difference(s1.begin(), s1.end(),
+                                    s2.begin(), s2.end(),
+                                    std::back_inserter(changed));
+      if (!changed.empty()) {
+        first = std::min(first, changed.front().serialNumber());
+        last = std::max(last, changed.back().serialNumber());
+      }
+    }
+
+  }
+
+  CalendarChange::CalendarChange(const Calendar& calendar,
+                                 const Date& first,
+                                 const Date& last)
+    : calendar_(calendar), first_(first.serialNumber()),
+      last_(last.serialNumber()) {
+    MF_REQUIRE(!calendar.empty(), "no calendar provided");
+    MF_REQUIRE(first <= last, "'first' date ("
+               << first << ") must not be later than 'last' date ("
+               << last << ")");
+  }
+
+  CalendarChange CalendarChange::between(const Calendar& before,
+                                         const Calendar& after) {
+    MF_REQUIRE(!before.empty() && !after.empty(), "no calendar provided");
+    MF_REQUIRE(before == after, "different calendars: " << before.name()
+               << " and " << after.name());
+    Date::serial_type first = Date::maxDate().serialNumber() + 1;
+    Date::serial_type last = Date::minDate().serialNumber() - 1;
+    addRange(before.addedHolidays(), after.addedHolidays(), first, last);
+    addRange(before.removedHolidays(), after.removedHolidays(), first, last);
+    return CalendarChange(after, first, last);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  struct ScheduleIndex::Entry {
+    Entry(const Date& effectiveDate,
+          const Date& terminationDate,
+          const Period& tenor,
+          BusinessDayConvention convention,
+          BusinessDayConvention terminationDateConvention,
+          DateGeneration rule,
+          bool endOfMonth,
+          const Listener& listener)
+      : effectiveDate(effectiveDate.serialNumber()),
+        terminationDate(terminationDate.serialNumber()),
+        tenor(tenor), convention(convention),
+        terminationDateConvention(terminationDateConvention),
+        rule(rule), endOfMonth(endOfMonth), listener(listener) {}
+
+    const Date::serial_type effectiveDate, terminationDate;
+    const Period tenor;
+    const BusinessDayConvention convention, terminationDateConvention;
+    const DateGeneration rule;
+    const bool endOfMonth;
+    const Listener listener;
+
+    std::unique_ptr<Schedule> schedule;
+    std::vector<Windows::iterator> windows;
+  };
+
+  ScheduleIndex::ScheduleIndex() : size_(0) {}
+
+  ScheduleIndex::~ScheduleIndex() {}
+
+  Size ScheduleIndex::add(const Date& effectiveDate,
+                          const Date& terminationDate,
+                          const Period& tenor,
+                          const Calendar& calendar,
+                          BusinessDayConvention convention,
+                          BusinessDayConvention terminationDateConvention,
+                          DateGeneration rule,
+                          bool endOfMonth,
+                          const Listener& listener) {
+    const Size handle = entries_.size();
+    entries_.push_back(std::unique_ptr<Entry>(
+                         new Entry(effectiveDate, terminationDate, tenor,
+                                   convention, terminationDateConvention,
+                                   rule, endOfMonth, listener)));
+    try {
+      generate(handle, calendar);
+    } catch (...) {
+      entries_.pop_back();
+      throw;
+    }
+    ++size_;
+    return handle;
+  }
+
+  void ScheduleIndex::remove(Size handle) {
+    MF_REQUIRE(handle < entries_.size() && entries_[handle],
+               "unknown schedule handle (" << handle << ")");
+    unindex(*entries_[handle]);
+    entries_[handle].reset();
+    --size_;
+  }
+
+  const Schedule& ScheduleIndex::schedule(Size handle) const {
+    MF_REQUIRE(handle < entries_.size() && entries_[handle],
+               "unknown schedule handle (" << handle << ")");
+    return *entries_[handle]->schedule;
+  }
+
+  void ScheduleIndex::unindex(Entry& entry) {
+    if (entry.windows.empty()) {
+      return;
+    }
+    Windows& windows =
+      dependencies_[entry.schedule->calendar().name()].windows;
+    for (Size i = 0; i < entry.windows.size(); ++i) {
+      windows.erase(entry.windows[i]);
+    }
+    entry.windows.clear();
+  }
+
+  void ScheduleIndex::generate(Size handle, const Calendar& calendar) {
+    Entry& entry = *entries_[handle];
+    std::unique_ptr<Schedule> schedule(
+      new Schedule(Date(entry.effectiveDate), Date(entry.terminationDate),
+                   entry.tenor, calendar, entry.convention,
+                   entry.terminationDateConvention, entry.rule,
+                   entry.endOfMonth));
+
+    // days the dates depend on
+    std::vector<Run> runs;
+    const std::vector<Date::serial_type>& dates = schedule->serialNumbers();
+    for (Size i = 0; i < dates.size(); ++i) {
+      const BusinessDayConvention c = i + 1 == dates.size()
+        ? entry.terminationDateConvention : entry.convention;
+      if (c != BusinessDayConvention::Unadjusted) {
+        runs.push_back(holidayRun(calendar, dates[i]));
+      }
+    }
+    if (entry.endOfMonth) {
+      // whether the seeds are month ends, and the rolled dates beyond the
+      // ends of the schedule
+      const Date::serial_type seeds[] = {
+        entry.effectiveDate, entry.effectiveDate + 1,
+        entry.terminationDate, entry.terminationDate + 1,
+        Date::endOfMonth(Date(entry.effectiveDate)).serialNumber(),
+        Date::endOfMonth(Date(entry.terminationDate)).serialNumber()
+      };
+      for (Size i = 0; i < sizeof(seeds) / sizeof(seeds[0]); ++i) {
+        if (seeds[i] <= Date::maxDate().serialNumber()) {
+          runs.push_back(holidayRun(calendar, seeds[i]));
+        }
+      }
+    }
+    std::sort(runs.begin(), runs.end());
+
+    unindex(entry);
+    entry.schedule = std::move(schedule);
+    Dependencies& dependencies = dependencies_[calendar.name()];
+    for (Size i = 0; i < runs.size(); ) {
+      Run run = runs[i];
+      for (++i; i < runs.size() && runs[i].first <= run.second + 1; ++i) {
+        run.second = std::max(run.second, runs[i].second);
+      }
+      entry.windows.push_back(
+        dependencies.windows.insert(
+          std::make_pair(run.first, std::make_pair(run.second, handle))));
+      dependencies.longest =
+        std::max(dependencies.longest, run.second - run.first);
+    }
+  }
+
+  std::vector<Size> ScheduleIndex::affected(const std::string& calendar,
+                                            Date::serial_type first,
+                                            Date::serial_type last) const {
+    std::vector<Size> result;
+    const std::map<std::string, Dependencies>::const_iterator found =
+      dependencies_.find(calendar);
+    if (found == dependencies_.end() || first > last) {
+      return result;
+    }
+    const Dependencies& dependencies = found->second;
+    const Windows::const_iterator end =
+      dependencies.windows.upper_bound(last);
+    for (Windows::const_iterator i =
+           dependencies.windows.lower_bound(first - dependencies.longest);
+         i != end; ++i) {
+      if (i->second.first >= first) {
+        result.push_back(i->second.second);
+      }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+  }
+
+  std::vector<Size> ScheduleIndex::update(const CalendarChange& change) {
+    MF_TRACE_SPAN("ScheduleIndex::update", "schedule");
+    const std::vector<Size> handles =
+      affected(change.calendar().name(), change.first(), change.last());
+    for (Size i = 0; i < handles.size(); ++i) {
+      generate(handles[i], change.calendar());
+    }
+    for (Size i = 0; i < handles.size(); ++i) {
+      const Entry& entry = *entries_[handles[i]];
+      if (entry.listener) {
+        entry.listener(handles[i], *entry.schedule);
+      }
+    }
+    return handles;
+  }
+
+}
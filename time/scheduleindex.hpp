@@ -0,0 +1,166 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file scheduleindex.hpp
+ * @brief regeneration of the schedules affected by calendar changes
+ */
+
+#ifndef MATHFIN_SCHEDULEINDEX_HPP
+#define MATHFIN_SCHEDULEINDEX_HPP
+
+#include <time/calendar.hpp>
+#include <time/schedule.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Amended calendar together with the days whose holiday status may
+   * have changed.
+   */
+  class CalendarChange {
+  public:
+    /**
+     * Change of the days between <tt>first</tt> and <tt>last</tt>, both
+     * included, resulting in the given calendar.
+     */
+    CalendarChange(const Calendar& calendar,
+                   const Date& first,
+                   const Date& last);
+
+    /**
+     * Change from one calendar to another sharing its implementation,
+     * such as one returned by addHoliday() or removeHoliday(); the range
+     * spans the days added or removed by one calendar but not the other.
+     */
+    static CalendarChange between(const Calendar& before,
+                                  const Calendar& after);
+
+    const Calendar& calendar() const { return calendar_; }
+    Date::serial_type first() const { return first_; }
+    Date::serial_type last() const { return last_; }
+    bool empty() const { return first_ > last_; }
+
+  private:
+    CalendarChange(const Calendar& calendar,
+                   Date::serial_type first,
+                   Date::serial_type last)
+      : calendar_(calendar), first_(first), last_(last) {}
+
+    Calendar calendar_;
+    Date::serial_type first_, last_;
+  };
+
+  // ---------------------------------------------------------------------------
+
+  /**
+   * Registry of schedules indexed by the days their dates depend on.
+   *
+   * An adjusted date depends on the run of holidays around it: adding or
+   * removing a holiday elsewhere cannot move it, whatever the
+   * convention.  Each schedule is indexed under its calendar by these
+   * runs (and those around its seed dates, which decide end-of-month
+   * rolling), so that update() regenerates only the schedules a
+   * CalendarChange can affect, each in time proportional to its size.
+   *
+   * A listener given on registration is called with every regenerated
+   * schedule so that date sets derived from it (fixing dates, cash
+   * flows) can be rebuilt as well.
+   */
+  class ScheduleIndex {
+  public:
+    typedef std::function<void(Size, const Schedule&)> Listener;
+
+    ScheduleIndex();
+    ~ScheduleIndex();
+
+    /**
+     * Generates and registers a schedule; returns its handle.
+     */
+    Size add(const Date& effectiveDate,
+             const Date& terminationDate,
+             const Period& tenor,
+             const Calendar& calendar,
+             BusinessDayConvention convention,
+             BusinessDayConvention terminationDateConvention,
+             DateGeneration rule,
+             bool endOfMonth,
+             const Listener& listener = Listener());
+
+    /**
+     * Unregisters a schedule; its handle is not reused.
+     */
+    void remove(Size handle);
+
+    const Schedule& schedule(Size handle) const;
+
+    /**
+     * Number of schedules registered.
+     */
+    Size size() const { return size_; }
+
+    /**
+     * Handles of the schedules on the named calendar that depend on a
+     * day between <tt>first</tt> and <tt>last</tt>, in increasing order.
+     */
+    std::vector<Size> affected(const std::string& calendar,
+                               Date::serial_type first,
+                               Date::serial_type last) const;
+
+    /**
+     * Regenerates the affected schedules on the amended calendar, calls
+     * their listeners and returns their handles.
+     */
+    std::vector<Size> update(const CalendarChange& change);
+
+  private:
+    ScheduleIndex(const ScheduleIndex&);
+    ScheduleIndex& operator=(const ScheduleIndex&);
+
+    // days [first, second] that a schedule depends on, keyed by first
+    typedef std::multimap<Date::serial_type,
+                          std::pair<Date::serial_type, Size> > Windows;
+
+    struct Dependencies {
+      Dependencies() : longest(0) {}
+      Windows windows;
+      // longest window, bounding the search for overlaps
+      Date::serial_type longest;
+    };
+
+    struct Entry;
+
+    void generate(Size handle, const Calendar& calendar);
+    void unindex(Entry& entry);
+
+    std::vector<std::unique_ptr<Entry> > entries_;
+    std::map<std::string, Dependencies> dependencies_;
+    Size size_;
+  };
+
+}
+
+#endif /* MATHFIN_SCHEDULEINDEX_HPP */
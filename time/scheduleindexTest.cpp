@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/scheduleindex.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Calendar changes span the amended days", "[scheduleindex]") {
+  const Calendar target = TARGET();
+  const Calendar amended = target.addHoliday(Date(15, Month::June, 2017))
+    .removeHoliday(Date(25, Month::December, 2017));
+
+  const CalendarChange change = CalendarChange::between(target, amended);
+  REQUIRE(change.first() == Date(15, Month::June, 2017).serialNumber());
+  REQUIRE(change.last() == Date(25, Month::December, 2017).serialNumber());
+  REQUIRE(change.calendar().addedHolidays() == amended.addedHolidays());
+
+  REQUIRE(CalendarChange::between(amended, amended).empty());
+  // adding an existing holiday changes nothing
+  REQUIRE(CalendarChange::between(
+            target, target.addHoliday(Date(25, Month::December, 2017)))
+          .empty());
+  REQUIRE_THROWS_AS(CalendarChange::between(target, UnitedKingdom()), Error);
+}
+
+TEST_CASE("Only the schedules depending on a changed day are regenerated",
+          "[scheduleindex]") {
+  const Calendar target = TARGET();
+  const BusinessDayConvention conventions[] = {
+    BusinessDayConvention::Following,
+    BusinessDayConvention::ModifiedFollowing,
+    BusinessDayConvention::Preceding,
+    BusinessDayConvention::Unadjusted
+  };
+  const Period tenors[] = {
+    Period(1, TimeUnit::Months), Period(3, TimeUnit::Months),
+    Period(1, TimeUnit::Years), Period(2, TimeUnit::Weeks)
+  };
+
+  struct Spec {
+    Date::serial_type effective, termination;
+    Period tenor;
+    BusinessDayConvention convention;
+    DateGeneration rule;
+    bool endOfMonth;
+  };
+  std::vector<Spec> specs;
+  const Date::serial_type start = Date(2, Month::January, 2017).serialNumber();
+  for (Size i = 0; i < 400; ++i) {
+    const Spec spec = {
+      start + Date::serial_type(i * 3),
+      start + Date::serial_type(i * 3 + 400 + 30 * (i % 7)),
+      tenors[i % 4], conventions[(i / 4) % 4],
+      i % 2 == 0 ? DateGeneration::Forward : DateGeneration::Backward,
+      i % 3 == 0
+    };
+    specs.push_back(spec);
+  }
+
+  ScheduleIndex index;
+  std::vector<Size> notified;
+  const ScheduleIndex::Listener listener =
+    [&notified](Size handle, const Schedule&) { notified.push_back(handle); };
+  for (Size i = 0; i < specs.size(); ++i) {
+    REQUIRE(index.add(Date(specs[i].effective), Date(specs[i].termination),
+                      specs[i].tenor, target, specs[i].convention,
+                      BusinessDayConvention::ModifiedFollowing,
+                      specs[i].rule, specs[i].endOfMonth, listener) == i);
+  }
+  const Size uk = index.add(Date(2, Month::January, 2017),
+                            Date(2, Month::January, 2018),
+                            Period(3, TimeUnit::Months), UnitedKingdom(),
+                            BusinessDayConvention::Following,
+                            BusinessDayConvention::Following,
+                            DateGeneration::Forward, false, listener);
+  REQUIRE(index.size() == 401);
+
+  const Date holidays[] = {
+    Date(15, Month::June, 2017), Date(31, Month::October, 2017),
+    Date(2, Month::January, 2018), Date(29, Month::June, 2018)
+  };
+  std::vector<Calendar> calendars(1, target);
+  for (Size h = 0; h < sizeof(holidays) / sizeof(holidays[0]); ++h) {
+    calendars.push_back(calendars.back().addHoliday(holidays[h]));
+    const Calendar& amended = calendars.back();
+
+    notified.clear();
+    const std::vector<Size> updated = index.update(
+      CalendarChange::between(calendars[calendars.size() - 2], amended));
+    REQUIRE(notified == updated);
+    REQUIRE(!updated.empty());
+    REQUIRE(updated.size() < specs.size() / 2);
+    REQUIRE(std::find(updated.begin(), updated.end(), uk) == updated.end());
+
+    // every schedule, regenerated or not, is the one of the new calendar
+    for (Size i = 0; i < specs.size(); ++i) {
+      const Schedule fresh(Date(specs[i].effective),
+                           Date(specs[i].termination), specs[i].tenor,
+                           amended, specs[i].convention,
+                           BusinessDayConvention::ModifiedFollowing,
+                           specs[i].rule, specs[i].endOfMonth);
+      INFO("schedule " << i << " after adding " << holidays[h]);
+      REQUIRE(index.schedule(i).serialNumbers() == fresh.serialNumbers());
+    }
+  }
+
+  index.remove(0);
+  REQUIRE(index.size() == 400);
+  REQUIRE_THROWS_AS(index.schedule(0), Error);
+  const std::vector<Size> remaining =
+    index.affected("TARGET", specs[0].effective, specs[1].effective);
+  REQUIRE(remaining == std::vector<Size>(1, 1));
+}
@@ -0,0 +1,305 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/calendars/registry.hpp>
+#include <time/serialization.hpp>
+#include <time/varint.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace MathFin {
+
+  using detail::getVarint;
+  using detail::putVarint;
+  using detail::unzigzag;
+  using detail::varintSize;
+  using detail::zigzag;
+
+  namespace {
+
+    const unsigned char magic[] = { 'M', 'F', 'B' };
+
+    // encoded gap between consecutive dates
+    inline BigNatural gap(Date::serial_type previous,
+                          Date::serial_type current,
+                          bool increasing) {
+      return increasing
+        ? BigNatural(current - previous)
+        : zigzag(BigInteger(current) - previous);
+    }
+
+    inline Date::serial_type serialNumber(BigNatural n) {
+      const BigNatural first = Date::minDate().serialNumber();
+      const BigNatural last = Date::maxDate().serialNumber();
+      MF_REQUIRE(n >= first && n <= last, "serial number " << n
+                 << " out of range in binary input");
+      return Date::serial_type(n);
+    }
+
+    std::vector<Date> dates(const EncodedDates& encoded) {
+      const std::vector<Date::serial_type> serials = encoded.decode();
+      std::vector<Date> result;
+      result.reserve(serials.size());
+      for (Size i = 0; i < serials.size(); ++i) {
+        result.push_back(Date::unchecked(serials[i]));
+      }
+      return result;
+    }
+
+  }
+
+  // ---------------------------------------------------------------------------
+
+  void EncodedDates::decode(Date::serial_type* result) const {
+    const BigInteger first = Date::minDate().serialNumber();
+    const BigInteger last = Date::maxDate().serialNumber();
+    const unsigned char* p = begin_;
+    BigInteger serial = 0;
+    for (Size i = 0; i < size_; ++i) {
+      const BigNatural n = getVarint(p, end_);
+      // no valid gap exceeds twice the range of serial numbers
+      MF_REQUIRE(n <= BigNatural(2 * last), "malformed date sequence");
+      if (i == 0) {
+        serial = BigInteger(n);
+      } else if (increasing_) {
+        MF_REQUIRE(n > 0, "malformed date sequence");
+        serial += BigInteger(n);
+      } else {
+        serial += unzigzag(n);
+      }
+      MF_REQUIRE(serial >= first && serial <= last, "serial number "
+                 << serial << " out of range in binary input");
+      result[i] = Date::serial_type(serial);
+    }
+    MF_REQUIRE(p == end_, "malformed date sequence");
+  }
+
+  std::vector<Date::serial_type> EncodedDates::decode() const {
+    std::vector<Date::serial_type> result(size_);
+    if (size_ > 0) {
+      decode(&result[0]);
+    }
+    return result;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  BinaryWriter::BinaryWriter()
+    : buffer_(magic, magic + sizeof(magic)) {
+    buffer_.push_back(version);
+  }
+
+  void BinaryWriter::writeUnsigned(BigNatural n) {
+    putVarint(buffer_, n);
+  }
+
+  void BinaryWriter::writeSigned(BigInteger n) {
+    putVarint(buffer_, zigzag(n));
+  }
+
+  void BinaryWriter::write(const std::string& s) {
+    putVarint(buffer_, s.size());
+    buffer_.insert(buffer_.end(), s.begin(), s.end());
+  }
+
+  void BinaryWriter::write(const Date& d) {
+    putVarint(buffer_, BigNatural(d.serialNumber()));
+  }
+
+  void BinaryWriter::write(const Period& p) {
+    putVarint(buffer_, 16 * zigzag(p.length()) + BigNatural(p.units()));
+  }
+
+  void BinaryWriter::write(const Date::serial_type* dates, Size n) {
+    MF_TRACE_SPAN("BinaryWriter::write", "serialization");
+    const Date::serial_type first = Date::minDate().serialNumber();
+    const Date::serial_type last = Date::maxDate().serialNumber();
+    bool increasing = true;
+    for (Size i = 0; i < n; ++i) {
+      MF_REQUIRE(dates[i] >= first && dates[i] <= last, "serial number "
+                 << dates[i] << " out of range [" << first << ", "
+                 << last << "]");
+      if (i > 0 && dates[i] <= dates[i - 1]) {
+        increasing = false;
+      }
+    }
+
+    Size bytes = 0;
+    for (Size i = 0; i < n; ++i) {
+      bytes += varintSize(i == 0
+                          ? BigNatural(dates[0])
+                          : gap(dates[i - 1], dates[i], increasing));
+    }
+    putVarint(buffer_, (BigNatural(n) << 1) | (increasing ? 1 : 0));
+    putVarint(buffer_, bytes);
+    buffer_.reserve(buffer_.size() + bytes);
+    for (Size i = 0; i < n; ++i) {
+      putVarint(buffer_, i == 0
+                ? BigNatural(dates[0])
+                : gap(dates[i - 1], dates[i], increasing));
+    }
+  }
+
+  void BinaryWriter::write(const std::vector<Date::serial_type>& dates) {
+    write(dates.empty() ? 0 : &dates[0], dates.size());
+  }
+
+  void BinaryWriter::write(const std::set<Date>& dates) {
+    std::vector<Date::serial_type> serials;
+    serials.reserve(dates.size());
+    for (std::set<Date>::const_iterator i = dates.begin();
+         i != dates.end(); ++i) {
+      serials.push_back(i->serialNumber());
+    }
+    write(serials);
+  }
+
+  void BinaryWriter::write(const Calendar& calendar) {
+    if (calendar.empty()) {
+      putVarint(buffer_, 0);
+      return;
+    }
+    const std::string name = calendar.name();
+    // only the registry can rebuild a calendar from its name
+    MF_REQUIRE(calendarNamed(name) == calendar, "calendar '" << name
+               << "' is not a built-in calendar and cannot be serialized");
+    write(name);
+    write(calendar.addedHolidays());
+    write(calendar.removedHolidays());
+  }
+
+  void BinaryWriter::write(const Schedule& schedule) {
+    write(schedule.calendar());
+    write(schedule.tenor());
+    putVarint(buffer_, BigNatural(schedule.convention()));
+    putVarint(buffer_, BigNatural(schedule.terminationDateConvention()));
+    putVarint(buffer_, BigNatural(schedule.rule()));
+    putVarint(buffer_, schedule.endOfMonth() ? 1 : 0);
+    putVarint(buffer_, schedule.isRegular(1) ? 1 : 0);
+    putVarint(buffer_, schedule.isRegular(schedule.size() - 1) ? 1 : 0);
+    write(schedule.serialNumbers());
+  }
+
+  // ---------------------------------------------------------------------------
+
+  BinaryReader::BinaryReader(const void* data, Size size)
+    : begin_(static_cast<const unsigned char*>(data)),
+      position_(begin_), end_(begin_ + size) {
+    MF_REQUIRE(data != 0 || size == 0, "null buffer");
+    MF_REQUIRE(size >= sizeof(magic) + 1
+               && std::equal(magic, magic + sizeof(magic), begin_),
+               "not a MathFin binary stream");
+    MF_REQUIRE(begin_[sizeof(magic)] == BinaryWriter::version,
+               "unsupported binary format version "
+               << Integer(begin_[sizeof(magic)]) << ", "
+               << Integer(BinaryWriter::version) << " expected");
+    position_ += sizeof(magic) + 1;
+  }
+
+  BigNatural BinaryReader::readUnsigned() {
+    return getVarint(position_, end_);
+  }
+
+  BigInteger BinaryReader::readSigned() {
+    return unzigzag(getVarint(position_, end_));
+  }
+
+  std::string BinaryReader::readString() {
+    const BigNatural length = readUnsigned();
+    MF_REQUIRE(length <= BigNatural(end_ - position_),
+               "truncated binary input");
+    const std::string s(position_, position_ + length);
+    position_ += length;
+    return s;
+  }
+
+  Date BinaryReader::readDate() {
+    return Date::unchecked(serialNumber(readUnsigned()));
+  }
+
+  Period BinaryReader::readPeriod() {
+    const BigNatural n = readUnsigned();
+    const BigNatural units = n & 15;
+    const BigInteger length = unzigzag(n >> 4);
+    MF_REQUIRE(units <= BigNatural(TimeUnit::Microseconds),
+               "unknown time unit " << units << " in binary input");
+    MF_REQUIRE(length == BigInteger(Integer(length)),
+               "period length " << length << " out of range in binary input");
+    return Period(Integer(length), TimeUnit(units));
+  }
+
+  EncodedDates BinaryReader::readDates() {
+    const BigNatural header = readUnsigned();
+    const BigNatural bytes = readUnsigned();
+    const BigNatural size = header >> 1;
+    MF_REQUIRE(bytes <= BigNatural(end_ - position_),
+               "truncated binary input");
+    MF_REQUIRE(size <= bytes, "malformed date sequence");
+    const EncodedDates result(position_, position_ + bytes, Size(size),
+                              (header & 1) != 0);
+    position_ += bytes;
+    return result;
+  }
+
+  Calendar BinaryReader::readCalendar() {
+    const std::string name = readString();
+    if (name.empty()) {
+      return Calendar();
+    }
+
+    const Calendar calendar = calendarNamed(name);
+    MF_REQUIRE(!calendar.empty(), "unknown calendar '" << name
+               << "' in binary input");
+    const EncodedDates added = readDates();
+    const EncodedDates removed = readDates();
+    if (added.empty() && removed.empty()) {
+      return calendar;
+    }
+    return calendar.amend(dates(added), dates(removed));
+  }
+
+  Schedule BinaryReader::readSchedule() {
+    const Calendar calendar = readCalendar();
+    const Period tenor = readPeriod();
+    const BigNatural convention = readUnsigned();
+    const BigNatural terminationDateConvention = readUnsigned();
+    const BigNatural rule = readUnsigned();
+    const BigNatural endOfMonth = readUnsigned();
+    const BigNatural firstPeriodRegular = readUnsigned();
+    const BigNatural lastPeriodRegular = readUnsigned();
+    MF_REQUIRE(convention <= BigNatural(BusinessDayConvention::Unknown)
+               && terminationDateConvention
+               <= BigNatural(BusinessDayConvention::Unknown),
+               "unknown business-day convention in binary input");
+    MF_REQUIRE(rule <= BigNatural(DateGeneration::CDS),
+               "unknown date-generation rule in binary input");
+    MF_REQUIRE(endOfMonth <= 1 && firstPeriodRegular <= 1
+               && lastPeriodRegular <= 1,
+               "malformed schedule in binary input");
+    return Schedule(readDates().decode(), tenor, calendar,
+                    BusinessDayConvention(convention),
+                    BusinessDayConvention(terminationDateConvention),
+                    DateGeneration(rule), endOfMonth == 1,
+                    firstPeriodRegular == 1, lastPeriodRegular == 1);
+  }
+
+}
@@ -0,0 +1,174 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file serialization.hpp
+ * @brief compact binary encoding of dates, periods, calendars and schedules
+ */
+
+#ifndef MATHFIN_SERIALIZATION_HPP
+#define MATHFIN_SERIALIZATION_HPP
+
+#include <base/types.hpp>
+#include <time/calendar.hpp>
+#include <time/date.hpp>
+#include <time/period.hpp>
+#include <time/schedule.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Encoded sequence of dates, read in place from the buffer holding it.
+   *
+   * Obtaining the view does not decode or copy anything; decode() expands
+   * the dates into serial numbers in a single pass.
+   */
+  class EncodedDates {
+  public:
+    EncodedDates() : begin_(0), end_(0), size_(0), increasing_(true) {}
+
+    Size size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * Whether the dates are strictly increasing, in which case they were
+     * stored as unsigned gaps.
+     */
+    bool increasing() const { return increasing_; }
+
+    /**
+     * Number of bytes taken by the encoded dates.
+     */
+    Size bytes() const { return Size(end_ - begin_); }
+
+    /**
+     * Writes the size() serial numbers into result; throws an Error if
+     * the encoding is corrupt.
+     */
+    void decode(Date::serial_type* result) const;
+
+    std::vector<Date::serial_type> decode() const;
+
+  private:
+    friend class BinaryReader;
+
+    EncodedDates(const unsigned char* begin,
+                 const unsigned char* end,
+                 Size size,
+                 bool increasing)
+      : begin_(begin), end_(end), size_(size), increasing_(increasing) {}
+
+    const unsigned char* begin_;
+    const unsigned char* end_;
+    Size size_;
+    bool increasing_;
+  };
+
+  // ---------------------------------------------------------------------------
+
+  /**
+   * Writer of the compact binary encoding.
+   *
+   * A stream starts with the bytes 'M', 'F', 'B' and the format version,
+   * followed by the values in the order they were written; a reader
+   * must read them back in the same order.  Integers are LEB128 varints,
+   * zig-zag encoded when signed.  Within the encoding:
+   *
+   * - a string is its length in bytes followed by its bytes;
+   * - a Date is its serial number; the time of day is not kept;
+   * - a Period is the single varint 16 * zigzag(length) + unit;
+   * - a sequence of dates is its size and increasing flag, its length
+   *   in bytes, the first serial number and the gaps between
+   *   consecutive dates, so that a quarterly schedule takes one byte per
+   *   date;
+   * - a Calendar is its name and the sequences of added and removed
+   *   holidays; only built-in calendars, as returned by calendarNamed(),
+   *   possibly amended, can be written, and writing a joint or bespoke
+   *   calendar raises an Error;
+   * - a Schedule is its calendar, tenor, conventions, rule, end-of-month
+   *   flag, whether its first and last periods are regular, and dates.
+   */
+  class BinaryWriter {
+  public:
+    static const unsigned char version = 2;
+
+    BinaryWriter();
+
+    void writeUnsigned(BigNatural n);
+    void writeSigned(BigInteger n);
+
+    void write(const std::string& s);
+    void write(const Date& d);
+    void write(const Period& p);
+    void write(const Date::serial_type* dates, Size n);
+    void write(const std::vector<Date::serial_type>& dates);
+    void write(const Calendar& calendar);
+    void write(const Schedule& schedule);
+
+    const std::vector<unsigned char>& buffer() const { return buffer_; }
+    const unsigned char* data() const { return &buffer_[0]; }
+    Size size() const { return buffer_.size(); }
+
+  private:
+    void write(const std::set<Date>& dates);
+
+    std::vector<unsigned char> buffer_;
+  };
+
+  /**
+   * Reader of the encoding produced by BinaryWriter, working directly on
+   * a memory buffer (for instance a mapped file) which must outlive it
+   * and the EncodedDates it returns.
+   *
+   * Malformed or truncated input raises an Error.
+   */
+  class BinaryReader {
+  public:
+    BinaryReader(const void* data, Size size);
+
+    bool atEnd() const { return position_ == end_; }
+
+    /**
+     * Bytes read so far, header included.
+     */
+    Size position() const { return Size(position_ - begin_); }
+
+    BigNatural readUnsigned();
+    BigInteger readSigned();
+
+    std::string readString();
+    Date readDate();
+    Period readPeriod();
+    EncodedDates readDates();
+    Calendar readCalendar();
+    Schedule readSchedule();
+
+  private:
+    const unsigned char* begin_;
+    const unsigned char* position_;
+    const unsigned char* end_;
+  };
+
+}
+
+#endif /* MATHFIN_SERIALIZATION_HPP */
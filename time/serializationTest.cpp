@@ -0,0 +1,252 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/serialization.hpp>
+
+using namespace MathFin;
+
+namespace {
+  void readAll(BinaryReader& reader) {
+    reader.readDates().decode();
+    reader.readCalendar();
+  }
+
+  // a calendar the registry cannot rebuild, even though it is named after
+  // a built-in one
+  class Impostor : public Calendar {
+  private:
+    class Impl : public Calendar::Impl {
+    public:
+      std::string name() const { return "TARGET"; }
+      bool isWeekend(Weekday) const { return false; }
+      bool isBusinessDay(const Date&) const { return true; }
+    };
+  public:
+    Impostor()
+    : Calendar(std::shared_ptr<Calendar::Impl>(new Impostor::Impl)) {}
+  };
+}
+
+TEST_CASE("Dates and periods round-trip through the binary encoding",
+          "[serialization]") {
+  BinaryWriter writer;
+  writer.write(Date::minDate());
+  writer.write(Date(15, Month::June, 2017));
+  writer.write(Date::maxDate());
+  const TimeUnit units[] = {
+    TimeUnit::Days, TimeUnit::Weeks, TimeUnit::Months, TimeUnit::Years,
+    TimeUnit::Hours, TimeUnit::Minutes, TimeUnit::Seconds,
+    TimeUnit::Milliseconds, TimeUnit::Microseconds
+  };
+  const Integer lengths[] = { 0, 1, -1, 6, -18, 1000, 2147483647 };
+  for (Size u = 0; u < sizeof(units) / sizeof(units[0]); ++u) {
+    for (Size l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+      writer.write(Period(lengths[l], units[u]));
+    }
+  }
+  writer.writeSigned(-42);
+  writer.writeUnsigned(300);
+  writer.write(std::string("EUR-EURIBOR-6M"));
+
+  // a month tenor packs into one byte
+  BinaryWriter single;
+  single.write(Period(3, TimeUnit::Months));
+  REQUIRE(single.size() == 5);
+
+  BinaryReader reader(writer.data(), writer.size());
+  REQUIRE(reader.readDate() == Date::minDate());
+  REQUIRE(reader.readDate() == Date(15, Month::June, 2017));
+  REQUIRE(reader.readDate() == Date::maxDate());
+  for (Size u = 0; u < sizeof(units) / sizeof(units[0]); ++u) {
+    for (Size l = 0; l < sizeof(lengths) / sizeof(lengths[0]); ++l) {
+      const Period p = reader.readPeriod();
+      REQUIRE(p.length() == lengths[l]);
+      REQUIRE(p.units() == units[u]);
+    }
+  }
+  REQUIRE(reader.readSigned() == -42);
+  REQUIRE(reader.readUnsigned() == 300);
+  REQUIRE(reader.readString() == "EUR-EURIBOR-6M");
+  REQUIRE(reader.atEnd());
+  REQUIRE(reader.position() == writer.size());
+}
+
+TEST_CASE("Date sequences are delta coded and read in place",
+          "[serialization]") {
+  std::vector<Date::serial_type> increasing;
+  for (Date::serial_type s = Date(1, Month::January, 2000).serialNumber();
+       s < Date(1, Month::January, 2010).serialNumber(); s += 91) {
+    increasing.push_back(s);
+  }
+  std::vector<Date::serial_type> unordered;
+  for (Size i = 0; i < 1000; ++i) {
+    unordered.push_back(
+      Date::serial_type(40000 + (i * 7919) % 5000 - (i % 3 == 0 ? 900 : 0)));
+  }
+  const std::vector<Date::serial_type> empty;
+  const std::vector<Date::serial_type> single(1, Date::maxDate().serialNumber());
+
+  BinaryWriter writer;
+  writer.write(increasing);
+  writer.write(unordered);
+  writer.write(empty);
+  writer.write(single);
+
+  BinaryReader reader(writer.data(), writer.size());
+  const EncodedDates first = reader.readDates();
+  REQUIRE(first.size() == increasing.size());
+  REQUIRE(first.increasing());
+  // the first date takes three bytes, each quarterly gap one
+  REQUIRE(first.bytes() == increasing.size() + 2);
+  REQUIRE(first.decode() == increasing);
+
+  const EncodedDates second = reader.readDates();
+  REQUIRE(!second.increasing());
+  REQUIRE(second.decode() == unordered);
+
+  REQUIRE(reader.readDates().decode() == empty);
+  REQUIRE(reader.readDates().decode() == single);
+  REQUIRE(reader.atEnd());
+
+  // reading the views and decoding into a buffer use no heap memory
+  std::vector<Date::serial_type> buffer(increasing.size());
+  BinaryReader again(writer.data(), writer.size());
+  REQUIRE_HOT_PATH(again.readDates());
+  REQUIRE_HOT_PATH(first.decode(&buffer[0]));
+  REQUIRE(buffer == increasing);
+
+  REQUIRE_THROWS_AS(writer.write(std::vector<Date::serial_type>(1, 0)), Error);
+}
+
+TEST_CASE("Calendars round-trip with their overrides", "[serialization]") {
+  const Calendar target = TARGET();
+  const Calendar amended = target
+    .addHoliday(Date(15, Month::June, 2017))
+    .addHoliday(Date(16, Month::June, 2017))
+    .removeHoliday(Date(25, Month::December, 2017));
+
+  BinaryWriter writer;
+  writer.write(Calendar());
+  writer.write(target);
+  writer.write(amended);
+  writer.write(UnitedStates::NYSE());
+
+  BinaryReader reader(writer.data(), writer.size());
+  REQUIRE(reader.readCalendar().empty());
+  const Calendar plain = reader.readCalendar();
+  REQUIRE(plain == target);
+  REQUIRE(plain.addedHolidays().empty());
+  const Calendar restored = reader.readCalendar();
+  REQUIRE(restored == target);
+  REQUIRE(restored.addedHolidays() == amended.addedHolidays());
+  REQUIRE(restored.removedHolidays() == amended.removedHolidays());
+  REQUIRE(!restored.isBusinessDay(Date(16, Month::June, 2017)));
+  REQUIRE(restored.isBusinessDay(Date(25, Month::December, 2017)));
+  REQUIRE(reader.readCalendar().name() == "New York stock exchange");
+  REQUIRE(reader.atEnd());
+}
+
+TEST_CASE("Calendars outside the registry are not written",
+          "[serialization]") {
+  BinaryWriter writer;
+  REQUIRE_THROWS_AS(writer.write(Impostor()), Error);
+  REQUIRE_THROWS_AS(
+    writer.write(Impostor().addHoliday(Date(15, Month::June, 2017))), Error);
+  REQUIRE(writer.size() == BinaryWriter().size());
+}
+
+TEST_CASE("Schedules round-trip through the binary encoding",
+          "[serialization]") {
+  const Schedule schedule(Date(31, Month::January, 2017),
+                          Date(31, Month::January, 2047),
+                          Period(3, TimeUnit::Months),
+                          TARGET().addHoliday(Date(28, Month::April, 2017)),
+                          BusinessDayConvention::ModifiedFollowing,
+                          BusinessDayConvention::Unadjusted,
+                          DateGeneration::Backward,
+                          true);
+  BinaryWriter writer;
+  writer.write(schedule);
+  // well under two bytes per date
+  REQUIRE(writer.size() < 2 * schedule.size());
+
+  BinaryReader reader(writer.data(), writer.size());
+  const Schedule restored = reader.readSchedule();
+  REQUIRE(reader.atEnd());
+  REQUIRE(restored.serialNumbers() == schedule.serialNumbers());
+  REQUIRE(restored.calendar() == schedule.calendar());
+  REQUIRE(restored.calendar().addedHolidays()
+          == schedule.calendar().addedHolidays());
+  REQUIRE(restored.tenor() == schedule.tenor());
+  REQUIRE(restored.convention() == schedule.convention());
+  REQUIRE(restored.terminationDateConvention()
+          == schedule.terminationDateConvention());
+  REQUIRE(restored.rule() == schedule.rule());
+  REQUIRE(restored.endOfMonth() == schedule.endOfMonth());
+  REQUIRE(restored.isRegular(1) == schedule.isRegular(1));
+
+  // a short first period stays a stub once restored
+  const Schedule stub(Date(19, Month::December, 2016),
+                      Date(15, Month::December, 2017),
+                      Period(3, TimeUnit::Months), TARGET(),
+                      BusinessDayConvention::ModifiedFollowing,
+                      BusinessDayConvention::ModifiedFollowing,
+                      DateGeneration::Backward, false);
+  BinaryWriter stubWriter;
+  stubWriter.write(stub);
+  BinaryReader stubReader(stubWriter.data(), stubWriter.size());
+  const Schedule restoredStub = stubReader.readSchedule();
+  REQUIRE(!restoredStub.isRegular(1));
+  REQUIRE(restoredStub.isRegular(restoredStub.size() - 1));
+}
+
+TEST_CASE("Malformed binary input is rejected", "[serialization]") {
+  BinaryWriter writer;
+  writer.write(std::vector<Date::serial_type>(3, 42000));
+  writer.write(TARGET());
+  const std::vector<unsigned char> good = writer.buffer();
+
+  REQUIRE_THROWS_AS(BinaryReader(good.data(), 2), Error);
+  std::vector<unsigned char> bad = good;
+  bad[0] = 'X';
+  REQUIRE_THROWS_AS(BinaryReader(bad.data(), bad.size()), Error);
+  bad = good;
+  bad[3] = BinaryWriter::version + 1;
+  REQUIRE_THROWS_AS(BinaryReader(bad.data(), bad.size()), Error);
+
+  // every truncation fails cleanly
+  for (Size n = 4; n < good.size(); ++n) {
+    BinaryReader reader(good.data(), n);
+    REQUIRE_THROWS_AS(readAll(reader), Error);
+  }
+
+  // an unknown calendar name
+  bad = good;
+  bad[bad.size() - 5] = 'Z';
+  BinaryReader reader(bad.data(), bad.size());
+  reader.readDates();
+  REQUIRE_THROWS_AS(reader.readCalendar(), Error);
+}
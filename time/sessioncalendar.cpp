@@ -0,0 +1,165 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/sessioncalendar.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+using boost::posix_time::ptime;
+using boost::posix_time::time_duration;
+
+namespace MathFin {
+
+  namespace {
+    const boost::gregorian::date& serialNumberDateReference() {
+      static const boost::gregorian::date dateReference(
+        1899, boost::gregorian::Dec, 30);
+      return dateReference;
+    }
+
+    Date::serial_type serialNumber(const ptime& t) {
+      return (t.date() - serialNumberDateReference()).days();
+    }
+
+    // New York stock exchange early closes (13:00), as currently applied:
+    // July 3rd, the day after Thanksgiving and Christmas Eve, provided
+    // that they are business days.
+    bool isNyseEarlyClose(const Date& date) {
+      Weekday w = date.weekday();
+      Day d = date.dayOfMonth();
+      Month m = date.month();
+      return (d == 3 && m == Month::July && w != Weekday::Friday)
+        || ((d >= 23 && d <= 29) && w == Weekday::Friday
+            && m == Month::November)
+        || (d == 24 && m == Month::December && w != Weekday::Friday);
+    }
+  }
+
+  SessionCalendar::SessionCalendar(
+    const Calendar& calendar,
+    const Session& regular,
+    const Date& from,
+    const Date& to,
+    const std::map<Date::serial_type, Session>& specialSessions
+    ) : calendar_(calendar), regular_(regular),
+        first_(from.serialNumber()) {
+    MF_REQUIRE(!calendar.empty(), "no calendar provided");
+    MF_REQUIRE(from <= to, "'from' date ("
+               << from << ") must not be later than 'to' date ("
+               << to << ")");
+    MF_REQUIRE(regular.open < regular.close,
+               "the regular session must open before it closes");
+
+    MF_TRACE_SPAN("SessionCalendar::SessionCalendar", "calendar");
+    const Date::serial_type last = to.serialNumber();
+    const Size n = Size(last - first_ + 1);
+    open_.resize(n);
+    close_.resize(n);
+    cumulative_.resize(n + 1);
+    cumulative_[0] = 0;
+
+    for (Size i = 0; i < n; ++i) {
+      const Date::serial_type s = first_ + Date::serial_type(i);
+      micros_type open = 0, close = 0;
+      if (calendar.isBusinessDay(Date(s))) {
+        std::map<Date::serial_type, Session>::const_iterator special =
+          specialSessions.find(s);
+        const Session& session =
+          (special != specialSessions.end() ? special->second : regular);
+        open = session.open.total_microseconds();
+        close = std::max(open, micros_type(session.close.total_microseconds()));
+      }
+      open_[i] = open;
+      close_[i] = close;
+      cumulative_[i + 1] = cumulative_[i] + (close - open);
+    }
+  }
+
+  SessionCalendar SessionCalendar::NYSE(const Date& from, const Date& to) {
+    const Calendar nyse = UnitedStates::NYSE();
+    const Session regular(time_duration(9, 30, 0), time_duration(16, 0, 0));
+    const Session earlyClose(time_duration(9, 30, 0), time_duration(13, 0, 0));
+
+    std::map<Date::serial_type, Session> earlyCloses;
+    const Date::serial_type last = to.serialNumber();
+    for (Date::serial_type s = from.serialNumber(); s <= last; ++s) {
+      const Date d(s);
+      if (isNyseEarlyClose(d) && nyse.isBusinessDay(d)) {
+        earlyCloses.insert(std::make_pair(s, earlyClose));
+      }
+    }
+
+    return SessionCalendar(nyse, regular, from, to, earlyCloses);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  Size SessionCalendar::dayIndex(const ptime& t) const {
+    const Date::serial_type s = serialNumber(t);
+    MF_REQUIRE(s >= first_ && s < first_ + Date::serial_type(open_.size()),
+               "date " << Date(t) << " outside the session tables");
+    return Size(s - first_);
+  }
+
+  SessionCalendar::micros_type SessionCalendar::elapsed(const ptime& t) const {
+    const Size i = dayIndex(t);
+    const micros_type timeOfDay = t.time_of_day().total_microseconds();
+    const micros_type intraday =
+      std::min(std::max(timeOfDay, open_[i]), close_[i]) - open_[i];
+    return cumulative_[i] + intraday;
+  }
+
+  SessionCalendar::Session SessionCalendar::session(const Date& d) const {
+    const Size i = dayIndex(d.dateTime());
+    return Session(boost::posix_time::microseconds(open_[i]),
+                   boost::posix_time::microseconds(close_[i]));
+  }
+
+  bool SessionCalendar::isOpen(const ptime& dateTime) const {
+    const Size i = dayIndex(dateTime);
+    const micros_type timeOfDay = dateTime.time_of_day().total_microseconds();
+    return timeOfDay >= open_[i] && timeOfDay < close_[i];
+  }
+
+  Real SessionCalendar::tradingSeconds(const ptime& t1, const ptime& t2) const {
+    return (elapsed(t2) - elapsed(t1)) / 1.0e6;
+  }
+
+  Real SessionCalendar::tradingDays(const Date& t1, const Date& t2) const {
+    const micros_type length =
+      (regular_.close - regular_.open).total_microseconds();
+    return (elapsed(t2.dateTime()) - elapsed(t1.dateTime())) / Real(length);
+  }
+
+  void SessionCalendar::tradingSeconds(
+    const ptime& from,
+    const std::vector<ptime>& ticks,
+    std::vector<Real>& result) const {
+    MF_TRACE_SPAN("SessionCalendar::tradingSeconds[batch]", "calendar");
+    const micros_type start = elapsed(from);
+    result.resize(ticks.size());
+    for (Size i = 0; i < ticks.size(); ++i) {
+      result[i] = (elapsed(ticks[i]) - start) / 1.0e6;
+    }
+  }
+
+}
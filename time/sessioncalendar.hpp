@@ -0,0 +1,186 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file sessioncalendar.hpp
+ * @brief trading-session calendar and business-time measure
+ */
+
+#ifndef MATHFIN_SESSION_CALENDAR_HPP
+#define MATHFIN_SESSION_CALENDAR_HPP
+
+#include <time/calendar.hpp>
+
+#include <map>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Trading-session calendar.
+   *
+   * A session calendar refines a Calendar with the intraday trading
+   * session of every business day (open and close times, including
+   * early closes) and measures the trading time elapsed between two
+   * timestamps.
+   *
+   * The sessions for all days in the range [from, to] are expanded at
+   * construction into a table of cumulative trading time, so that the
+   * trading time between any two timestamps in the range is computed
+   * in constant time, without walking the calendar.
+   *
+   * All times are local to the exchange; no time-zone conversion is
+   * performed.  The resolution is one microsecond.
+   *
+   * @ingroup datetime
+   */
+  class SessionCalendar {
+  public:
+    /**
+     * Trading session of a day, given as times of day in exchange-local
+     * time.  A session with open >= close is a day without trading.
+     */
+    struct Session {
+      Session() {}
+      Session(const boost::posix_time::time_duration& open,
+              const boost::posix_time::time_duration& close)
+        : open(open), close(close) {}
+      boost::posix_time::time_duration open;
+      boost::posix_time::time_duration close;
+    };
+
+    /**
+     * Build the session tables for the days in [from, to].
+     *
+     * @param calendar the holiday calendar of the exchange
+     * @param regular the session of a regular business day
+     * @param from first day covered by the tables
+     * @param to last day covered by the tables
+     * @param specialSessions sessions replacing the regular one on the
+     *        given business days, keyed by serial number (e.g. early
+     *        closes).  Entries falling on holidays are ignored.
+     */
+    SessionCalendar(
+      const Calendar& calendar,
+      const Session& regular,
+      const Date& from,
+      const Date& to,
+      const std::map<Date::serial_type, Session>& specialSessions =
+        std::map<Date::serial_type, Session>());
+
+    /**
+     * New York stock exchange sessions: 9:30 to 16:00, closing at 13:00
+     * on July 3rd, on the day after Thanksgiving and on Christmas Eve
+     * when these are business days.
+     */
+    static SessionCalendar NYSE(const Date& from, const Date& to);
+
+    /**
+     * @name inspectors
+     * @{
+     */
+
+    /**
+     * The underlying holiday calendar.
+     */
+    const Calendar& calendar() const { return calendar_; }
+
+    /**
+     * The regular session.
+     */
+    const Session& regularSession() const { return regular_; }
+
+    /**
+     * The session of the given day; for holidays the returned session
+     * opens and closes at midnight.
+     */
+    Session session(const Date& d) const;
+
+    /**
+     * Returns <tt>true</tt> iff the exchange is trading at the given
+     * time; the open is included and the close is excluded.
+     */
+    bool isOpen(const boost::posix_time::ptime& dateTime) const;
+
+    /**
+     * Returns <tt>true</tt> iff the exchange is trading at the given
+     * time; the open is included and the close is excluded.
+     */
+    bool isOpen(const Date& d) const { return isOpen(d.dateTime()); }
+
+    /** @} */
+
+    /**
+     * @name business-time measure
+     * @{
+     */
+
+    /**
+     * Trading seconds elapsed between two timestamps; negative if
+     * t2 is earlier than t1.
+     */
+    Real tradingSeconds(const boost::posix_time::ptime& t1,
+                        const boost::posix_time::ptime& t2) const;
+
+    /**
+     * Trading seconds elapsed between two timestamps; negative if
+     * t2 is earlier than t1.
+     */
+    Real tradingSeconds(const Date& t1, const Date& t2) const {
+      return tradingSeconds(t1.dateTime(), t2.dateTime());
+    }
+
+    /**
+     * Trading time between two timestamps expressed in regular trading
+     * days, i.e. trading seconds over the length of the regular session.
+     */
+    Real tradingDays(const Date& t1, const Date& t2) const;
+
+    /**
+     * Batch form for tick streams: the trading seconds elapsed from
+     * <tt>from</tt> to each of the given ticks are written to
+     * <tt>result</tt>, which is resized as needed.
+     */
+    void tradingSeconds(
+      const boost::posix_time::ptime& from,
+      const std::vector<boost::posix_time::ptime>& ticks,
+      std::vector<Real>& result) const;
+
+    /** @} */
+
+  private:
+    typedef boost::int_fast64_t micros_type;
+
+    Size dayIndex(const boost::posix_time::ptime& t) const;
+    micros_type elapsed(const boost::posix_time::ptime& t) const;
+
+    Calendar calendar_;
+    Session regular_;
+    Date::serial_type first_;
+    // per-day session bounds in microseconds after midnight
+    std::vector<micros_type> open_;
+    std::vector<micros_type> close_;
+    // trading microseconds elapsed before the start of each day;
+    // it holds one more entry than the number of days covered
+    std::vector<micros_type> cumulative_;
+  };
+
+}
+
+#endif /* MATHFIN_SESSION_CALENDAR_HPP */
@@ -0,0 +1,104 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/error.hpp>
+#include <time/sessioncalendar.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("NYSE regular session", "[sessioncalendar]") {
+  SessionCalendar nyse = SessionCalendar::NYSE(
+    Date(1, Month::January, 2016), Date(31, Month::December, 2016));
+
+  // Tuesday, November 22nd 2016
+  REQUIRE(nyse.tradingSeconds(Date(22, Month::November, 2016, 0, 0, 0),
+                              Date(23, Month::November, 2016, 0, 0, 0))
+          == 23400.0);
+  REQUIRE(nyse.isOpen(Date(22, Month::November, 2016, 9, 30, 0)));
+  REQUIRE(!nyse.isOpen(Date(22, Month::November, 2016, 16, 0, 0)));
+  REQUIRE(nyse.tradingDays(Date(22, Month::November, 2016, 9, 30, 0),
+                           Date(22, Month::November, 2016, 12, 45, 0))
+          == 0.5);
+}
+
+TEST_CASE("NYSE early close and weekend", "[sessioncalendar]") {
+  SessionCalendar nyse = SessionCalendar::NYSE(
+    Date(1, Month::January, 2016), Date(31, Month::December, 2016));
+
+  // Thanksgiving is Thursday, November 24th 2016; the exchange closes
+  // at 13:00 on the following Friday.
+  Date wednesdayClose(23, Month::November, 2016, 16, 0, 0);
+  Date mondayOpen(28, Month::November, 2016, 9, 30, 0);
+  REQUIRE(nyse.tradingSeconds(wednesdayClose, mondayOpen) == 12600.0);
+  REQUIRE(nyse.tradingSeconds(mondayOpen, wednesdayClose) == -12600.0);
+  REQUIRE(!nyse.isOpen(Date(25, Month::November, 2016, 13, 30, 0)));
+
+  // ticks after hours do not add trading time
+  REQUIRE(nyse.tradingSeconds(Date(23, Month::November, 2016, 16, 0, 0),
+                              Date(23, Month::November, 2016, 23, 0, 0))
+          == 0.0);
+}
+
+TEST_CASE("Session tick stream", "[sessioncalendar]") {
+  SessionCalendar nyse = SessionCalendar::NYSE(
+    Date(1, Month::June, 2016), Date(31, Month::July, 2016));
+
+  // Independence Day falls on Monday, July 4th 2016
+  std::vector<boost::posix_time::ptime> ticks;
+  ticks.push_back(Date(1, Month::July, 2016, 12, 0, 0).dateTime());
+  ticks.push_back(Date(1, Month::July, 2016, 15, 59, 59, 500).dateTime());
+  ticks.push_back(Date(5, Month::July, 2016, 12, 0, 0).dateTime());
+
+  std::vector<Real> seconds;
+  nyse.tradingSeconds(Date(1, Month::July, 2016, 12, 0, 0).dateTime(),
+                      ticks, seconds);
+  REQUIRE(seconds.size() == 3);
+  REQUIRE(seconds[0] == 0.0);
+  REQUIRE(seconds[1] == 14399.5);
+  REQUIRE(seconds[2] == 23400.0);
+}
+
+TEST_CASE("Custom sessions", "[sessioncalendar]") {
+  typedef SessionCalendar::Session Session;
+  using boost::posix_time::time_duration;
+
+  std::map<Date::serial_type, Session> special;
+  special[Date(24, Month::December, 2015).serialNumber()] =
+    Session(time_duration(8, 0, 0), time_duration(12, 30, 0));
+
+  SessionCalendar lse(UnitedKingdom::Exchange(),
+                      Session(time_duration(8, 0, 0), time_duration(16, 30, 0)),
+                      Date(1, Month::December, 2015),
+                      Date(31, Month::January, 2016),
+                      special);
+
+  // Christmas and Boxing Day (moved to Monday 28th) are holidays
+  REQUIRE(lse.tradingSeconds(Date(24, Month::December, 2015, 0, 0, 0),
+                             Date(29, Month::December, 2015, 0, 0, 0))
+          == 4.5 * 3600.0);
+  REQUIRE(lse.session(Date(25, Month::December, 2015)).close
+          == time_duration(0, 0, 0));
+  REQUIRE_THROWS_AS(lse.tradingSeconds(Date(1, Month::March, 2016),
+                                       Date(2, Month::March, 2016)),
+                    Error);
+}
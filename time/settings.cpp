@@ -0,0 +1,77 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <time/settings.hpp>
+
+namespace MathFin {
+
+  namespace {
+    // evaluation date of the current thread; 0 outside any scope
+    thread_local Date::serial_type threadDate = 0;
+  }
+
+  // 0 until set or first read
+  std::atomic<Date::serial_type> Settings::defaultDate_(0);
+
+  Date::serial_type Settings::today() {
+    const Date::serial_type d = Date::todaysDate().serialNumber();
+    Date::serial_type expected = 0;
+    // another thread may have set or latched the date meanwhile
+    if (defaultDate_.compare_exchange_strong(expected, d,
+                                             std::memory_order_relaxed)) {
+      return d;
+    }
+    return expected;
+  }
+
+  Date Settings::evaluationDate() {
+    if (threadDate != 0) {
+      return Date::unchecked(threadDate);
+    }
+    return defaultEvaluationDate();
+  }
+
+  Date Settings::defaultEvaluationDate() {
+    const Date::serial_type d = defaultDate_.load(std::memory_order_relaxed);
+    return Date::unchecked(d != 0 ? d : today());
+  }
+
+  void Settings::setDefaultEvaluationDate(const Date& d) {
+    MF_REQUIRE(d != Date(), "null evaluation date");
+    defaultDate_.store(d.serialNumber(), std::memory_order_relaxed);
+  }
+
+  void Settings::resetDefaultEvaluationDate() {
+    defaultDate_.store(0, std::memory_order_relaxed);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  EvaluationDateScope::EvaluationDateScope(const Date& d)
+    : previous_(threadDate) {
+    MF_REQUIRE(d != Date(), "null evaluation date");
+    threadDate = d.serialNumber();
+  }
+
+  EvaluationDateScope::~EvaluationDateScope() {
+    threadDate = previous_;
+  }
+
+}
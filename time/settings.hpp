@@ -0,0 +1,98 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file settings.hpp
+ * @brief evaluation date shared by default and overridable per thread
+ */
+
+#ifndef MATHFIN_SETTINGS_HPP
+#define MATHFIN_SETTINGS_HPP
+
+#include <time/date.hpp>
+
+#include <atomic>
+
+namespace MathFin {
+
+  /**
+   * The date calculations are made "as of".
+   *
+   * Each thread sees the date of its innermost EvaluationDateScope, if
+   * any, and otherwise the process-wide default.  Unless set, the
+   * default is today's date, taken from the clock on first use and kept
+   * from then on so that a run does not change dates at midnight.
+   *
+   * Reading the evaluation date costs a thread-local and at most one
+   * relaxed atomic load: it neither queries the clock (after the first
+   * time) nor touches shared mutable state, so that threads can work as
+   * of different dates concurrently.  Tasks handed to a ThreadPool run
+   * under the default date unless they open a scope of their own.
+   */
+  class Settings {
+  public:
+    /**
+     * The evaluation date of the calling thread.
+     */
+    static Date evaluationDate();
+
+    /**
+     * The process-wide default evaluation date.
+     */
+    static Date defaultEvaluationDate();
+
+    /**
+     * Sets the process-wide default evaluation date; the time of day is
+     * dropped.
+     */
+    static void setDefaultEvaluationDate(const Date& d);
+
+    /**
+     * Makes the default evaluation date follow today's date again, as
+     * read on the next use.
+     */
+    static void resetDefaultEvaluationDate();
+
+  private:
+    static Date::serial_type today();
+
+    static std::atomic<Date::serial_type> defaultDate_;
+  };
+
+  /**
+   * Sets the evaluation date of the current thread for the lifetime of
+   * the object; scopes nest, and the enclosing date is restored on
+   * destruction.  Scopes must be destroyed in reverse order of creation
+   * on the thread that created them.
+   */
+  class EvaluationDateScope {
+  public:
+    explicit EvaluationDateScope(const Date& d);
+    ~EvaluationDateScope();
+
+  private:
+    EvaluationDateScope(const EvaluationDateScope&);
+    EvaluationDateScope& operator=(const EvaluationDateScope&);
+
+    const Date::serial_type previous_;
+  };
+
+}
+
+#endif /* MATHFIN_SETTINGS_HPP */
@@ -0,0 +1,95 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <thread>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/settings.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("The default evaluation date is today unless set", "[settings]") {
+  Settings::resetDefaultEvaluationDate();
+  const Date today = Date::todaysDate();
+  REQUIRE(Settings::evaluationDate() == today);
+  REQUIRE(Settings::defaultEvaluationDate() == today);
+
+  Settings::setDefaultEvaluationDate(Date(15, Month::June, 2017));
+  REQUIRE(Settings::evaluationDate() == Date(15, Month::June, 2017));
+  REQUIRE_THROWS_AS(Settings::setDefaultEvaluationDate(Date()), Error);
+
+  Settings::resetDefaultEvaluationDate();
+  REQUIRE(Settings::evaluationDate() == today);
+}
+
+TEST_CASE("Evaluation-date scopes nest", "[settings]") {
+  Settings::setDefaultEvaluationDate(Date(1, Month::March, 2017));
+  {
+    EvaluationDateScope outer(Date(15, Month::June, 2017));
+    REQUIRE(Settings::evaluationDate() == Date(15, Month::June, 2017));
+    {
+      EvaluationDateScope inner(Date(31, Month::December, 2010));
+      REQUIRE(Settings::evaluationDate() == Date(31, Month::December, 2010));
+      // the default does not hide an override
+      Settings::setDefaultEvaluationDate(Date(2, Month::March, 2017));
+      REQUIRE(Settings::evaluationDate() == Date(31, Month::December, 2010));
+      REQUIRE(Settings::defaultEvaluationDate()
+              == Date(2, Month::March, 2017));
+    }
+    REQUIRE(Settings::evaluationDate() == Date(15, Month::June, 2017));
+    REQUIRE_HOT_PATH(Settings::evaluationDate());
+  }
+  REQUIRE(Settings::evaluationDate() == Date(2, Month::March, 2017));
+  REQUIRE_HOT_PATH(Settings::evaluationDate());
+  Settings::resetDefaultEvaluationDate();
+}
+
+TEST_CASE("Threads see their own evaluation dates", "[settings]") {
+  Settings::setDefaultEvaluationDate(Date(1, Month::March, 2017));
+  const Date::serial_type first = Date(1, Month::January, 2000).serialNumber();
+  const Size threads = 4;
+  std::vector<Size> mismatches(threads, 0);
+  std::vector<std::thread> workers;
+  for (Size t = 0; t < threads; ++t) {
+    workers.push_back(std::thread([&mismatches, first, t]() {
+          for (Size i = 0; i < 1000; ++i) {
+            const Date d(Date::serial_type(first + 7 * i + t));
+            EvaluationDateScope scope(d);
+            for (Size k = 0; k < 10; ++k) {
+              if (Settings::evaluationDate() != d) {
+                ++mismatches[t];
+              }
+            }
+          }
+          if (Settings::evaluationDate() != Date(1, Month::March, 2017)) {
+            ++mismatches[t];
+          }
+        }));
+  }
+  for (Size t = 0; t < threads; ++t) {
+    workers[t].join();
+  }
+  for (Size t = 0; t < threads; ++t) {
+    REQUIRE(mismatches[t] == 0);
+  }
+  REQUIRE(Settings::evaluationDate() == Date(1, Month::March, 2017));
+  Settings::resetDefaultEvaluationDate();
+}
@@ -0,0 +1,368 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/civil.hpp>
+#include <time/tenor.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace MathFin {
+
+  namespace {
+
+    // guards against overflow when components are converted to months
+    // or days
+    const Integer maxComponent = 99999999;
+
+    inline char upper(char c) {
+      return (c >= 'a' && c <= 'z') ? char(c - 'a' + 'A') : c;
+    }
+
+    // rank of a unit letter, from the finest; 0 if it is not a unit
+    inline Integer unitRank(char c) {
+      switch (upper(c)) {
+      case 'D': return 1;
+      case 'W': return 2;
+      case 'M': return 3;
+      case 'Y': return 4;
+      default: return 0;
+      }
+    }
+
+    const TimeUnit rankedUnits[] = {
+      TimeUnit::Days, TimeUnit::Days, TimeUnit::Weeks,
+      TimeUnit::Months, TimeUnit::Years
+    };
+
+    inline Status parseError(const char* begin, const char* p) {
+      return Status(ErrorCode::ParseError, p - begin);
+    }
+
+    char* writeInteger(char* out, Integer n) {
+      char digits[16];
+      Size k = 0;
+      BigInteger m = n;
+      if (m < 0) {
+        *out++ = '-';
+        m = -m;
+      }
+      do {
+        digits[k++] = char('0' + m % 10);
+        m /= 10;
+      } while (m != 0);
+      while (k > 0) {
+        *out++ = digits[--k];
+      }
+      return out;
+    }
+
+    char* writeText(char* out, const char* text) {
+      while (*text != '\0') {
+        *out++ = *text++;
+      }
+      return out;
+    }
+
+    Size copyOut(const char* text, Size length, char* buffer, Size size) {
+      if (length < size) {
+        std::memcpy(buffer, text, length);
+        buffer[length] = '\0';
+      } else if (size > 0) {
+        buffer[0] = '\0';
+      }
+      return length;
+    }
+
+    // business days from the reference date to the end of a tenor
+    // counted in days
+    inline Integer businessDayCount(const Tenor& t) {
+      return t.lag() + t.period().length();
+    }
+
+  }
+
+  Expected<Period> parsePeriod(const char* begin, const char* end) {
+    const char* p = begin;
+    Integer sign = 1;
+    if (p != end && (*p == '+' || *p == '-')) {
+      sign = (*p == '-') ? -1 : 1;
+      ++p;
+    }
+    if (p == end) {
+      return parseError(begin, p);
+    }
+
+    Integer lengths[5] = { 0, 0, 0, 0, 0 };
+    Integer last = 5;
+    Size components = 0;
+    while (p != end) {
+      const char* digits = p;
+      Integer n = 0;
+      while (p != end && *p >= '0' && *p <= '9') {
+        n = 10 * n + (*p - '0');
+        if (n > maxComponent) {
+          return parseError(begin, p);
+        }
+        ++p;
+      }
+      if (p == digits || p == end) {
+        return parseError(begin, p);
+      }
+      const Integer rank = unitRank(*p);
+      // units must decrease and stay within years/months or weeks/days
+      if (rank == 0 || rank >= last
+          || (last != 5 && (rank <= 2) != (last <= 2))) {
+        return parseError(begin, p);
+      }
+      lengths[rank] = n;
+      last = rank;
+      ++components;
+      ++p;
+    }
+
+    if (components == 1) {
+      return Period(sign * lengths[last], rankedUnits[last]);
+    } else if (last == 3) {
+      return Period(sign * (12 * lengths[4] + lengths[3]), TimeUnit::Months);
+    } else {
+      return Period(sign * (7 * lengths[2] + lengths[1]), TimeUnit::Days);
+    }
+  }
+
+  Expected<Period> parsePeriod(const std::string& s) {
+    return parsePeriod(s.data(), s.data() + s.size());
+  }
+
+  Size formatPeriod(const Period& p, char* buffer, Size size) {
+    char text[32];
+    char* out = text;
+    Integer n = p.length();
+    switch (p.units()) {
+    case TimeUnit::Microseconds:
+      out = writeText(writeInteger(out, n), "us");
+      break;
+    case TimeUnit::Milliseconds:
+      out = writeText(writeInteger(out, n), "ms");
+      break;
+    case TimeUnit::Seconds:
+      out = writeText(writeInteger(out, n), "s");
+      break;
+    case TimeUnit::Minutes:
+      out = writeText(writeInteger(out, n), "m");
+      break;
+    case TimeUnit::Days:
+      if (n >= 7) {
+        out = writeText(writeInteger(out, n / 7), "W");
+        n %= 7;
+        if (n == 0) {
+          break;
+        }
+      }
+      out = writeText(writeInteger(out, n), "D");
+      break;
+    case TimeUnit::Weeks:
+      out = writeText(writeInteger(out, n), "W");
+      break;
+    case TimeUnit::Months:
+      if (n >= 12) {
+        out = writeText(writeInteger(out, n / 12), "Y");
+        n %= 12;
+        if (n == 0) {
+          break;
+        }
+      }
+      out = writeText(writeInteger(out, n), "M");
+      break;
+    case TimeUnit::Years:
+      out = writeText(writeInteger(out, n), "Y");
+      break;
+    default:
+      MF_FAIL("Unknown time unit (" << p.units() << ")");
+    }
+    return copyOut(text, Size(out - text), buffer, size);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  Date Tenor::endDate(const Date& reference,
+                      const Calendar& calendar,
+                      BusinessDayConvention convention,
+                      bool endOfMonth) const {
+    const Date start = lag_ == 0
+      ? reference
+      : calendar.advance(reference, lag_, TimeUnit::Days);
+    return calendar.advance(start, period_, convention, endOfMonth);
+  }
+
+  Expected<Tenor> parseTenor(const char* begin, const char* end) {
+    if (end - begin == 2 && upper(begin[1]) == 'N') {
+      switch (upper(begin[0])) {
+      case 'O':
+        return Tenor::overnight();
+      case 'T':
+        return Tenor::tomorrowNext();
+      case 'S':
+        return Tenor::spotNext();
+      default:
+        break;
+      }
+    }
+    const Expected<Period> period = parsePeriod(begin, end);
+    if (!period.ok()) {
+      return period.status();
+    }
+    return Tenor(period.value());
+  }
+
+  Expected<Tenor> parseTenor(const std::string& s) {
+    return parseTenor(s.data(), s.data() + s.size());
+  }
+
+  Size formatTenor(const Tenor& t, char* buffer, Size size) {
+    switch (t.lag()) {
+    case 1:
+      return copyOut("TN", 2, buffer, size);
+    case 2:
+      return copyOut("SN", 2, buffer, size);
+    default:
+      return formatPeriod(t.period(), buffer, size);
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TenorGrid::TenorGrid(const std::vector<std::string>& tenors) {
+    for (Size i = 0; i < tenors.size(); ++i) {
+      const Expected<Tenor> tenor = parseTenor(tenors[i]);
+      MF_REQUIRE(tenor.ok(), "malformed tenor '" << tenors[i] << "': "
+                 << tenor.status().message());
+      add(tenor.value());
+    }
+  }
+
+  Size TenorGrid::add(const Tenor& tenor) {
+    const Size i = find(tenor);
+    if (i != tenors_.size()) {
+      return i;
+    }
+    tenors_.push_back(tenor);
+    if (tenor.period().units() == TimeUnit::Days
+        && businessDayCount(tenor) > 0) {
+      const Integer count = businessDayCount(tenor);
+      std::vector<Size>::iterator position = businessDays_.begin();
+      while (position != businessDays_.end()
+             && businessDayCount(tenors_[*position]) <= count) {
+        ++position;
+      }
+      businessDays_.insert(position, i);
+    }
+    return i;
+  }
+
+  Size TenorGrid::find(const Tenor& tenor) const {
+    return Size(std::find(tenors_.begin(), tenors_.end(), tenor)
+                - tenors_.begin());
+  }
+
+  Size TenorGrid::find(const char* begin, const char* end) const {
+    const Expected<Tenor> tenor = parseTenor(begin, end);
+    return tenor.ok() ? find(tenor.value()) : size();
+  }
+
+  void TenorGrid::dates(const Date& reference,
+                        const Calendar& calendar,
+                        BusinessDayConvention convention,
+                        bool endOfMonth,
+                        Date::serial_type* result) const {
+    MF_REQUIRE(reference != Date(), "null date");
+    MF_TRACE_SPAN("TenorGrid::dates", "tenors");
+
+    const Date::serial_type serial = reference.serialNumber();
+    const Date start = Date::unchecked(serial);
+    Integer y, m, d;
+    detail::civilFromSerial(serial, y, m, d);
+    const bool atEndOfMonth = endOfMonth && calendar.isEndOfMonth(start);
+
+    for (Size i = 0; i < tenors_.size(); ++i) {
+      const Integer n = tenors_[i].period().length();
+      const TimeUnit units = tenors_[i].period().units();
+      if (units == TimeUnit::Days) {
+        // positive counts are filled in by the walk below
+        if (businessDayCount(tenors_[i]) <= 0) {
+          result[i] = calendar.advance(start, n, units, convention,
+                                       endOfMonth).serialNumber();
+        }
+      } else if (n == 0) {
+        result[i] = calendar.adjust(start, convention).serialNumber();
+      } else if (units == TimeUnit::Weeks) {
+        result[i] = calendar.adjust(Date(serial + 7 * n),
+                                    convention).serialNumber();
+      } else {
+        MF_REQUIRE(units == TimeUnit::Months || units == TimeUnit::Years,
+                   "Unsupported time units: " << units);
+        const Integer k = (m - 1) + (units == TimeUnit::Years ? 12 * n : n);
+        const Integer years = k >= 0 ? k / 12 : -((11 - k) / 12);
+        const Integer year = y + years;
+        const Integer month = k - 12 * years + 1;
+        const Integer day = std::min(d, detail::daysInMonth(year, month));
+        const Date target(
+          Date::serial_type(detail::serialFromCivil(year, month, day)));
+        result[i] = (atEndOfMonth
+                     ? calendar.endOfMonth(target)
+                     : calendar.adjust(target, convention)).serialNumber();
+      }
+    }
+
+    const Date::serial_type last = Date::maxDate().serialNumber();
+    Date::serial_type current = serial;
+    Integer count = 0;
+    for (Size j = 0; j < businessDays_.size(); ++j) {
+      const Size i = businessDays_[j];
+      const Integer target = businessDayCount(tenors_[i]);
+      while (count < target) {
+        do {
+          MF_REQUIRE(current < last, "date overflow");
+          ++current;
+        } while (!calendar.isBusinessDay(Date::unchecked(current)));
+        ++count;
+      }
+      result[i] = current;
+    }
+  }
+
+  std::vector<Date> TenorGrid::dates(const Date& reference,
+                                     const Calendar& calendar,
+                                     BusinessDayConvention convention,
+                                     bool endOfMonth) const {
+    std::vector<Date::serial_type> serials(tenors_.size());
+    if (!serials.empty()) {
+      dates(reference, calendar, convention, endOfMonth, &serials[0]);
+    }
+    std::vector<Date> result;
+    result.reserve(serials.size());
+    for (Size i = 0; i < serials.size(); ++i) {
+      result.push_back(Date::unchecked(serials[i]));
+    }
+    return result;
+  }
+
+}
@@ -0,0 +1,224 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file tenor.hpp
+ * @brief tenor parsing and formatting, and interned tenor grids
+ */
+
+#ifndef MATHFIN_TENOR_HPP
+#define MATHFIN_TENOR_HPP
+
+#include <base/status.hpp>
+#include <base/types.hpp>
+#include <time/businessdayconvention.hpp>
+#include <time/calendar.hpp>
+#include <time/date.hpp>
+#include <time/period.hpp>
+
+#include <string>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Parses a period such as "3M", "10Y", "2W" or the compound "1Y6M" and
+   * "1W3D".
+   *
+   * Units are D, W, M and Y, in either case; components must appear in
+   * decreasing order of unit and years and months may not be combined
+   * with weeks and days.  A compound period is expressed in the finer
+   * unit (months or days), a single component in its own unit.  A leading
+   * sign applies to the whole period.
+   *
+   * Neither allocates nor throws; on failure the status is
+   * ErrorCode::ParseError and its value is the offset of the offending
+   * character.
+   *
+   * @relates Period
+   */
+  Expected<Period> parsePeriod(const char* begin, const char* end);
+
+  /**
+   * @relates Period
+   */
+  Expected<Period> parsePeriod(const std::string& s);
+
+  /**
+   * Writes the short form of the period, as io::short_period, into the
+   * buffer followed by a terminating zero.
+   *
+   * Returns the length of the short form; if it is not smaller than the
+   * size of the buffer nothing but the terminating zero is written.
+   *
+   * @relates Period
+   */
+  Size formatPeriod(const Period& p, char* buffer, Size size);
+
+  // ---------------------------------------------------------------------------
+
+  /**
+   * A market tenor: a period counted from a number of business days
+   * after the reference date.
+   *
+   * Ordinary tenors start on the reference date itself.  The money-market
+   * tenors TN (tomorrow-next) and SN (spot-next) run for one business day
+   * starting one and two business days later; ON (overnight) is the same
+   * tenor as 1D.
+   */
+  class Tenor {
+  public:
+    Tenor() : period_(), lag_(0) {}
+    Tenor(const Period& period) : period_(period), lag_(0) {}
+
+    static Tenor overnight() { return Tenor(Period(1, TimeUnit::Days)); }
+    static Tenor tomorrowNext() { return Tenor(Period(1, TimeUnit::Days), 1); }
+    static Tenor spotNext() { return Tenor(Period(1, TimeUnit::Days), 2); }
+
+    const Period& period() const { return period_; }
+
+    /**
+     * Business days between the reference date and the start of the
+     * period.
+     */
+    Integer lag() const { return lag_; }
+
+    /**
+     * End date of the tenor for the given reference date, as given by
+     * Calendar::advance().
+     */
+    Date endDate(const Date& reference,
+                 const Calendar& calendar,
+                 BusinessDayConvention convention =
+                 BusinessDayConvention::Following,
+                 bool endOfMonth = false) const;
+
+  private:
+    Tenor(const Period& period, Integer lag) : period_(period), lag_(lag) {}
+
+    Period period_;
+    Integer lag_;
+  };
+
+  /**
+   * Whether the tenors have the same lag and period; periods are
+   * compared in the units they were given in, so that 12M and 1Y are
+   * different tenors.
+   * @relates Tenor
+   */
+  inline bool operator==(const Tenor& t1, const Tenor& t2) {
+    return t1.lag() == t2.lag()
+      && t1.period().length() == t2.period().length()
+      && t1.period().units() == t2.period().units();
+  }
+
+  /**
+   * @relates Tenor
+   */
+  inline bool operator!=(const Tenor& t1, const Tenor& t2) {
+    return !(t1 == t2);
+  }
+
+  /**
+   * Parses a tenor: ON, TN, SN (in either case) or a period as accepted
+   * by parsePeriod().  Neither allocates nor throws.
+   * @relates Tenor
+   */
+  Expected<Tenor> parseTenor(const char* begin, const char* end);
+
+  /**
+   * @relates Tenor
+   */
+  Expected<Tenor> parseTenor(const std::string& s);
+
+  /**
+   * Writes the tenor (TN, SN or the short form of its period) into the
+   * buffer as formatPeriod() does.
+   * @relates Tenor
+   */
+  Size formatTenor(const Tenor& t, char* buffer, Size size);
+
+  // ---------------------------------------------------------------------------
+
+  /**
+   * An interned set of tenors whose end dates are rolled out together.
+   *
+   * Each distinct tenor is held once and keeps the index it was first
+   * added at, so that curves and quotes can refer to pillars by index.
+   * dates() computes the end dates of all tenors for a reference date in
+   * a single pass: the reference date is decomposed into year, month and
+   * day once and shared by all month and year tenors, and day tenors are
+   * reached by one forward walk over the business days.  The result is
+   * the same as Tenor::endDate() for each tenor; the time of day of the
+   * reference date is dropped.
+   */
+  class TenorGrid {
+  public:
+    TenorGrid() {}
+
+    /**
+     * Grid of the given tenors; throws an Error on a malformed one.
+     */
+    explicit TenorGrid(const std::vector<std::string>& tenors);
+
+    /**
+     * Adds the tenor unless already present and returns its index.
+     */
+    Size add(const Tenor& tenor);
+
+    Size size() const { return tenors_.size(); }
+    bool empty() const { return tenors_.empty(); }
+    const Tenor& operator[](Size i) const { return tenors_[i]; }
+
+    /**
+     * Index of the tenor, or size() if it is not in the grid.
+     */
+    Size find(const Tenor& tenor) const;
+
+    /**
+     * Index of the tenor with the given label, or size() if it is
+     * malformed or not in the grid.  Does not allocate.
+     */
+    Size find(const char* begin, const char* end) const;
+
+    /**
+     * Writes the end date of each tenor for the given reference date
+     * into result, which must hold size() serial numbers.
+     */
+    void dates(const Date& reference,
+               const Calendar& calendar,
+               BusinessDayConvention convention,
+               bool endOfMonth,
+               Date::serial_type* result) const;
+
+    std::vector<Date> dates(const Date& reference,
+                            const Calendar& calendar,
+                            BusinessDayConvention convention =
+                            BusinessDayConvention::Following,
+                            bool endOfMonth = false) const;
+
+  private:
+    std::vector<Tenor> tenors_;
+    // indices of the tenors counted in business days, by ascending count
+    std::vector<Size> businessDays_;
+  };
+
+}
+
+#endif /* MATHFIN_TENOR_HPP */
@@ -0,0 +1,218 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <test/hotpath.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/calendars/unitedstates.hpp>
+#include <time/tenor.hpp>
+
+using namespace MathFin;
+
+namespace {
+  Period parsed(const std::string& s) {
+    return parsePeriod(s).value();
+  }
+
+  std::string formatted(const Period& p) {
+    char buffer[32];
+    formatPeriod(p, buffer, sizeof(buffer));
+    return buffer;
+  }
+
+  std::string formatted(const Tenor& t) {
+    char buffer[32];
+    formatTenor(t, buffer, sizeof(buffer));
+    return buffer;
+  }
+}
+
+TEST_CASE("Tenors parse into periods", "[tenor]") {
+  REQUIRE(parsed("3M") == Period(3, TimeUnit::Months));
+  REQUIRE(parsed("10Y") == Period(10, TimeUnit::Years));
+  REQUIRE(parsed("2w") == Period(2, TimeUnit::Weeks));
+  REQUIRE(parsed("1d") == Period(1, TimeUnit::Days));
+  REQUIRE(parsed("1Y6M") == Period(18, TimeUnit::Months));
+  REQUIRE(parsed("1W3D") == Period(10, TimeUnit::Days));
+  REQUIRE(parsed("-1Y6M") == Period(-18, TimeUnit::Months));
+  REQUIRE(parsed("+0D") == Period(0, TimeUnit::Days));
+  REQUIRE(parsed("2Y0M").units() == TimeUnit::Months);
+}
+
+TEST_CASE("Malformed tenors report the offending offset", "[tenor]") {
+  const char* malformed[] = {
+    "", "-", "M", "3", "3X", "3M ", " 3M", "1M1Y", "1M1M", "1Y2W", "1W1M",
+    "3M-", "1000000000Y", "ON1"
+  };
+  const BigInteger offsets[] = {
+    0, 1, 0, 1, 1, 2, 0, 3, 3, 3, 3, 2, 8, 0
+  };
+  for (Size i = 0; i < sizeof(malformed) / sizeof(malformed[0]); ++i) {
+    INFO(malformed[i]);
+    const Expected<Period> p = parsePeriod(malformed[i]);
+    REQUIRE(!p.ok());
+    REQUIRE(p.status().code() == ErrorCode::ParseError);
+    REQUIRE(p.status().value() == offsets[i]);
+    REQUIRE(!parseTenor(malformed[i]).ok());
+  }
+  REQUIRE_THROWS_AS(parsed("3Q"), Error);
+}
+
+TEST_CASE("Periods format as their short form", "[tenor]") {
+  const TimeUnit units[] = {
+    TimeUnit::Days, TimeUnit::Weeks, TimeUnit::Months, TimeUnit::Years,
+    TimeUnit::Minutes, TimeUnit::Seconds
+  };
+  for (Size u = 0; u < sizeof(units) / sizeof(units[0]); ++u) {
+    for (Integer n = -30; n <= 30; ++n) {
+      const Period p(n, units[u]);
+      std::ostringstream expected;
+      expected << io::short_period(p);
+      REQUIRE(formatted(p) == expected.str());
+      if (n > 0 && u < 4) {
+        REQUIRE(parsed(formatted(p)) == p);
+      }
+    }
+  }
+
+  // too small a buffer receives an empty string
+  char buffer[4] = { 'x', 'x', 'x', 'x' };
+  REQUIRE(formatPeriod(Period(18, TimeUnit::Months), buffer, 4) == 4);
+  REQUIRE(buffer[0] == '\0');
+  REQUIRE(formatPeriod(Period(18, TimeUnit::Months), buffer, 0) == 4);
+}
+
+TEST_CASE("Money-market tenors", "[tenor]") {
+  REQUIRE(parseTenor("ON").value() == Tenor(Period(1, TimeUnit::Days)));
+  REQUIRE(parseTenor("tn").value() == Tenor::tomorrowNext());
+  REQUIRE(parseTenor("SN").value() == Tenor::spotNext());
+  REQUIRE(parseTenor("3M").value() == Tenor(Period(3, TimeUnit::Months)));
+  REQUIRE(Tenor(Period(12, TimeUnit::Months))
+          != Tenor(Period(1, TimeUnit::Years)));
+
+  REQUIRE(formatted(Tenor::overnight()) == "1D");
+  REQUIRE(formatted(Tenor::tomorrowNext()) == "TN");
+  REQUIRE(formatted(Tenor::spotNext()) == "SN");
+  REQUIRE(formatted(parseTenor("1Y6M").value()) == "1Y6M");
+
+  // Friday 16 June 2017
+  const Calendar calendar = TARGET();
+  const Date friday(16, Month::June, 2017);
+  REQUIRE(Tenor::overnight().endDate(friday, calendar)
+          == Date(19, Month::June, 2017));
+  REQUIRE(Tenor::tomorrowNext().endDate(friday, calendar)
+          == Date(20, Month::June, 2017));
+  REQUIRE(Tenor::spotNext().endDate(friday, calendar)
+          == Date(21, Month::June, 2017));
+}
+
+TEST_CASE("Tenor parsing and formatting do not allocate", "[tenor][hotpath]") {
+  const char label[] = "1Y6M";
+  const char* end = label + std::strlen(label);
+  char buffer[16];
+  TenorGrid grid(std::vector<std::string>(1, "1Y6M"));
+
+  REQUIRE_HOT_PATH(parsePeriod(label, end));
+  REQUIRE_HOT_PATH(parsePeriod(label, end - 1));
+  REQUIRE_HOT_PATH(parseTenor(label, end));
+  REQUIRE_HOT_PATH(formatPeriod(Period(18, TimeUnit::Months), buffer, 16));
+  REQUIRE_HOT_PATH(grid.find(label, end));
+}
+
+TEST_CASE("Tenor grids intern tenors", "[tenor]") {
+  const char* labels[] = {
+    "ON", "TN", "SN", "1W", "2W", "1M", "3M", "6M", "1Y", "1Y6M", "2Y"
+  };
+  TenorGrid grid(std::vector<std::string>(
+                   labels, labels + sizeof(labels) / sizeof(labels[0])));
+  REQUIRE(grid.size() == 11);
+
+  REQUIRE(grid.add(parseTenor("1D").value()) == 0);
+  REQUIRE(grid.add(parseTenor("18M").value()) == 9);
+  REQUIRE(grid.add(parseTenor("12M").value()) == 11);
+  REQUIRE(grid.size() == 12);
+
+  for (Size i = 0; i < sizeof(labels) / sizeof(labels[0]); ++i) {
+    const char* label = labels[i];
+    REQUIRE(grid.find(label, label + std::strlen(label)) == i);
+  }
+  const char missing[] = "5Y";
+  REQUIRE(grid.find(missing, missing + 2) == grid.size());
+  const char malformed[] = "5Q";
+  REQUIRE(grid.find(malformed, malformed + 2) == grid.size());
+  REQUIRE_THROWS_AS(TenorGrid(std::vector<std::string>(1, "1Y2W")), Error);
+}
+
+TEST_CASE("Tenor grid dates match Calendar::advance", "[tenor]") {
+  const char* labels[] = {
+    "ON", "TN", "SN", "0D", "-1D", "3D", "1W", "1W3D", "2W", "0M", "1M",
+    "2M", "3M", "6M", "9M", "1Y", "1Y6M", "2Y", "5Y", "10Y", "30Y", "-1M",
+    "-1Y", "-1W"
+  };
+  const TenorGrid grid(std::vector<std::string>(
+                         labels, labels + sizeof(labels) / sizeof(labels[0])));
+
+  std::vector<Calendar> calendars;
+  calendars.push_back(TARGET());
+  calendars.push_back(UnitedKingdom());
+  calendars.push_back(UnitedStates());
+
+  const BusinessDayConvention conventions[] = {
+    BusinessDayConvention::Following,
+    BusinessDayConvention::ModifiedFollowing,
+    BusinessDayConvention::Preceding,
+    BusinessDayConvention::Unadjusted
+  };
+
+  std::vector<Date> references;
+  for (Date::serial_type s = Date(20, Month::December, 2015).serialNumber();
+       s <= Date(10, Month::March, 2016).serialNumber(); ++s) {
+    references.push_back(Date(s));
+  }
+  references.push_back(Date(29, Month::February, 2016));
+  references.push_back(Date(30, Month::April, 2017));
+  references.push_back(Date(31, Month::August, 2017));
+
+  for (Size c = 0; c < calendars.size(); ++c) {
+    for (Size k = 0; k < sizeof(conventions) / sizeof(conventions[0]); ++k) {
+      for (Size e = 0; e < 2; ++e) {
+        for (Size r = 0; r < references.size(); ++r) {
+          const std::vector<Date> dates =
+            grid.dates(references[r], calendars[c], conventions[k], e == 1);
+          REQUIRE(dates.size() == grid.size());
+          for (Size i = 0; i < grid.size(); ++i) {
+            const Date expected = grid[i].endDate(
+              references[r], calendars[c], conventions[k], e == 1);
+            if (dates[i] != expected) {
+              FAIL(calendars[c].name() << " " << labels[i] << " from "
+                   << references[r] << ": " << dates[i]
+                   << " instead of " << expected);
+            }
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/stats.hpp>
+#include <base/trace.hpp>
+#include <time/civil.hpp>
+#include <time/tickconverter.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+using boost::posix_time::ptime;
+
+namespace MathFin {
+
+  namespace {
+    const BigInteger nanosecondsPerDay = 86400LL * 1000000000LL;
+  }
+
+  TickTimeConverter::TickTimeConverter(
+    const Date& reference,
+    const DayCounter& dayCounter,
+    const Date& from,
+    const Date& to
+    ) : reference_(reference), dayCounter_(dayCounter) {
+    MF_REQUIRE(!dayCounter.empty(), "no day counter provided");
+    MF_REQUIRE(from <= to, "'from' date ("
+               << from << ") must not be later than 'to' date ("
+               << to << ")");
+
+    MF_TRACE_SPAN("TickTimeConverter::TickTimeConverter", "ticks");
+    const Date::serial_type first = from.serialNumber();
+    const Date::serial_type last = to.serialNumber();
+    first_ = BigInteger(first - detail::epochSerialNumber) * nanosecondsPerDay;
+
+    const Size n = Size(last - first + 1);
+    base_.resize(n);
+    slope_.resize(n);
+    for (Size i = 0; i < n; ++i) {
+      const Date dayStart(first + Date::serial_type(i));
+      const Date midDay(dayStart.dateTime() + boost::posix_time::hours(12));
+      base_[i] = dayCounter.yearFraction(reference, dayStart);
+      slope_[i] = (dayCounter.yearFraction(reference, midDay) - base_[i])
+        / (nanosecondsPerDay / 2);
+    }
+  }
+
+  BigInteger TickTimeConverter::nanoseconds(const ptime& t) {
+    static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return (t - epoch).ticks()
+      * (1000000000LL / boost::posix_time::time_duration::ticks_per_second());
+  }
+
+  Size TickTimeConverter::dayIndex(BigInteger nanoseconds) const {
+    MF_REQUIRE(nanoseconds >= first_
+               && nanoseconds - first_ < BigInteger(base_.size())
+               * nanosecondsPerDay,
+               "tick (" << nanoseconds << "ns) outside the converter range");
+    return Size((nanoseconds - first_) / nanosecondsPerDay);
+  }
+
+  Time TickTimeConverter::operator()(BigInteger nanoseconds) const {
+    const Size i = dayIndex(nanoseconds);
+    const BigInteger intraday =
+      nanoseconds - first_ - BigInteger(i) * nanosecondsPerDay;
+    return base_[i] + slope_[i] * intraday;
+  }
+
+  void TickTimeConverter::convert(const BigInteger* ticks,
+                                  Size n,
+                                  Time* result) const {
+    MF_TRACE_SPAN("TickTimeConverter::convert", "ticks");
+    for (Size k = 0; k < n; ++k) {
+      result[k] = (*this)(ticks[k]);
+    }
+  }
+
+  void TickTimeConverter::convert(const std::vector<BigInteger>& ticks,
+                                  std::vector<Time>& result) const {
+    result.resize(ticks.size());
+    if (!ticks.empty()) {
+      convert(&ticks[0], ticks.size(), &result[0]);
+    }
+  }
+
+  void TickTimeConverter::convert(const std::vector<ptime>& ticks,
+                                  std::vector<Time>& result) const {
+    MF_TRACE_SPAN("TickTimeConverter::convert", "ticks");
+    result.resize(ticks.size());
+    for (Size k = 0; k < ticks.size(); ++k) {
+      result[k] = (*this)(nanoseconds(ticks[k]));
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TickTimeConverter::Cursor::Cursor(const TickTimeConverter& converter)
+    : converter_(converter), dayStart_(0), dayEnd_(0), base_(0.0), slope_(0.0)
+  {}
+
+  void TickTimeConverter::Cursor::seek(BigInteger nanoseconds) {
+    const Size i = converter_.dayIndex(nanoseconds);
+    dayStart_ = converter_.first_ + BigInteger(i) * nanosecondsPerDay;
+    dayEnd_ = dayStart_ + nanosecondsPerDay;
+    base_ = converter_.base_[i];
+    slope_ = converter_.slope_[i];
+  }
+
+  Time TickTimeConverter::Cursor::operator()(BigInteger nanoseconds) {
+    if (nanoseconds < dayStart_ || nanoseconds >= dayEnd_) {
+      MF_COUNT(TickCursorMisses);
+      seek(nanoseconds);
+    } else {
+      MF_COUNT(TickCursorHits);
+    }
+    return base_ + slope_ * (nanoseconds - dayStart_);
+  }
+
+  void TickTimeConverter::Cursor::convert(const BigInteger* ticks,
+                                          Size n,
+                                          Time* result) {
+    for (Size k = 0; k < n; ++k) {
+      result[k] = (*this)(ticks[k]);
+    }
+  }
+
+}
@@ -0,0 +1,150 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file tickconverter.hpp
+ * @brief tick-timestamp to year-fraction conversion
+ */
+
+#ifndef MATHFIN_TICK_CONVERTER_HPP
+#define MATHFIN_TICK_CONVERTER_HPP
+
+#include <time/daycounter.hpp>
+
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Converts tick timestamps to year fractions from a fixed reference date.
+   *
+   * The year fraction measured by the day counter from the reference date
+   * is tabulated once for the start of every day in the range [from, to],
+   * together with its rate of change within the day.  A tick, given as
+   * nanoseconds since 1970-01-01T00:00:00 or as a posix time, is then
+   * converted with one integer division and one multiply-add, without
+   * constructing any Date.
+   *
+   * The conversion is exact for day counters whose year fraction is linear
+   * within each day, which covers the actual-based conventions as well as
+   * the 30/360 and business/252 conventions (whose year fraction does not
+   * change within a day).
+   *
+   * The converter is immutable and can be shared between threads; the
+   * incremental Cursor keeps per-stream state and must not.
+   *
+   * @ingroup datetime
+   */
+  class TickTimeConverter {
+  public:
+    /**
+     * @param reference the date (and time) from which year fractions are
+     *        measured
+     * @param dayCounter the day counter measuring the year fractions
+     * @param from first day of the range of supported ticks
+     * @param to last day of the range of supported ticks
+     */
+    TickTimeConverter(const Date& reference,
+                      const DayCounter& dayCounter,
+                      const Date& from,
+                      const Date& to);
+
+    const Date& reference() const { return reference_; }
+    const DayCounter& dayCounter() const { return dayCounter_; }
+
+    /**
+     * Year fraction of the tick given in nanoseconds since the epoch.
+     */
+    Time operator()(BigInteger nanoseconds) const;
+
+    /**
+     * Year fraction of the tick given as a posix time.
+     */
+    Time operator()(const boost::posix_time::ptime& tick) const {
+      return (*this)(nanoseconds(tick));
+    }
+
+    /**
+     * Batch conversion of <tt>n</tt> ticks, given in nanoseconds since the
+     * epoch, into the buffer pointed to by <tt>result</tt>.
+     */
+    void convert(const BigInteger* ticks, Size n, Time* result) const;
+
+    /**
+     * Batch conversion; <tt>result</tt> is resized as needed.
+     */
+    void convert(const std::vector<BigInteger>& ticks,
+                 std::vector<Time>& result) const;
+
+    /**
+     * Batch conversion; <tt>result</tt> is resized as needed.
+     */
+    void convert(const std::vector<boost::posix_time::ptime>& ticks,
+                 std::vector<Time>& result) const;
+
+    /**
+     * Nanoseconds elapsed between 1970-01-01T00:00:00 and the given time.
+     */
+    static BigInteger nanoseconds(const boost::posix_time::ptime& t);
+
+    /**
+     * Incremental conversion of a stream of ticks.
+     *
+     * The cursor remembers the day of the last tick, so that consecutive
+     * ticks falling on the same day need neither a division nor a table
+     * lookup.  Ticks are expected to be non-decreasing; an out-of-order
+     * tick is still converted correctly, at the cost of a new lookup.
+     */
+    class Cursor {
+    public:
+      explicit Cursor(const TickTimeConverter& converter);
+
+      /**
+       * Year fraction of the next tick in the stream.
+       */
+      Time operator()(BigInteger nanoseconds);
+
+      /**
+       * Converts the next <tt>n</tt> ticks of the stream.
+       */
+      void convert(const BigInteger* ticks, Size n, Time* result);
+
+    private:
+      void seek(BigInteger nanoseconds);
+
+      const TickTimeConverter& converter_;
+      BigInteger dayStart_, dayEnd_;
+      Time base_, slope_;
+    };
+
+  private:
+    Size dayIndex(BigInteger nanoseconds) const;
+
+    Date reference_;
+    DayCounter dayCounter_;
+    BigInteger first_;   // nanoseconds since the epoch at the start of `from'
+    // year fraction at the start of each day and its rate of change
+    // per nanosecond within the day
+    std::vector<Time> base_;
+    std::vector<Time> slope_;
+  };
+
+}
+
+#endif /* MATHFIN_TICK_CONVERTER_HPP */
@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cmath>
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/error.hpp>
+#include <time/tickconverter.hpp>
+#include <time/daycounters/actual360.hpp>
+#include <time/daycounters/actual365fixed.hpp>
+#include <time/daycounters/actualactual.hpp>
+#include <time/daycounters/thirty360.hpp>
+
+using namespace MathFin;
+
+#define EPS 1.0E-12
+
+namespace {
+  void checkAgainstDayCounter(const DayCounter& dayCounter) {
+    Date reference(30, Month::December, 2016, 9, 30, 0);
+    TickTimeConverter converter(reference, dayCounter,
+                                Date(29, Month::December, 2016),
+                                Date(3, Month::January, 2017));
+
+    // one tick every 7 minutes and 13.5 seconds across the year end
+    std::vector<boost::posix_time::ptime> ticks;
+    boost::posix_time::ptime t = Date(29, Month::December, 2016).dateTime();
+    while (t < Date(4, Month::January, 2017).dateTime()) {
+      ticks.push_back(t);
+      t += boost::posix_time::milliseconds(433500);
+    }
+
+    std::vector<Time> times;
+    converter.convert(ticks, times);
+    REQUIRE(times.size() == ticks.size());
+    for (Size i = 0; i < ticks.size(); ++i) {
+      Time expected = dayCounter.yearFraction(reference, Date(ticks[i]));
+      REQUIRE(std::fabs(times[i] - expected) < EPS);
+    }
+  }
+}
+
+TEST_CASE("Tick conversion matches day counters", "[tickconverter]") {
+  checkAgainstDayCounter(Actual360());
+  checkAgainstDayCounter(Actual365Fixed());
+  checkAgainstDayCounter(ActualActual(ActualActual::Convention::ISDA));
+  checkAgainstDayCounter(Thirty360());
+}
+
+TEST_CASE("Tick conversion from epoch nanoseconds", "[tickconverter]") {
+  Date reference(3, Month::January, 2017);
+  TickTimeConverter converter(reference, Actual365Fixed(),
+                              reference, Date(31, Month::January, 2017));
+
+  Date noon(3, Month::January, 2017, 12, 0, 0);
+  BigInteger ns = TickTimeConverter::nanoseconds(noon.dateTime());
+  REQUIRE(ns == 1483444800LL * 1000000000LL);
+  REQUIRE(std::fabs(converter(ns) - 0.5 / 365.0) < EPS);
+  REQUIRE(std::fabs(converter(noon.dateTime()) - 0.5 / 365.0) < EPS);
+
+  REQUIRE_THROWS_AS(converter(ns - 86400LL * 1000000000LL), Error);
+  REQUIRE_THROWS_AS(converter(Date(1, Month::February, 2017).dateTime()),
+                    Error);
+}
+
+TEST_CASE("Incremental tick conversion", "[tickconverter]") {
+  Date reference(3, Month::January, 2017);
+  TickTimeConverter converter(reference, Actual360(),
+                              reference, Date(31, Month::January, 2017));
+
+  std::vector<BigInteger> ticks;
+  BigInteger start = TickTimeConverter::nanoseconds(reference.dateTime());
+  for (BigInteger i = 0; i < 10000; ++i) {
+    ticks.push_back(start + i * 123456789012LL);
+  }
+  // an out-of-order tick is still handled
+  ticks.push_back(start);
+
+  std::vector<Time> batch;
+  converter.convert(ticks, batch);
+
+  std::vector<Time> streamed(ticks.size());
+  TickTimeConverter::Cursor cursor(converter);
+  cursor.convert(&ticks[0], ticks.size(), &streamed[0]);
+
+  for (Size i = 0; i < ticks.size(); ++i) {
+    REQUIRE(streamed[i] == batch[i]);
+  }
+  REQUIRE(std::fabs(batch[1] - 123456789012.0 / 86400.0e9 / 360.0) < EPS);
+  REQUIRE(streamed.back() == 0.0);
+}
@@ -0,0 +1,550 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <base/error.hpp>
+#include <base/mappedfile.hpp>
+#include <base/trace.hpp>
+#include <time/serialization.hpp>
+#include <time/timeseries.hpp>
+#include <time/varint.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ostream>
+
+namespace MathFin {
+
+  using detail::TimeSeriesBlock;
+
+  namespace {
+
+    const unsigned char magic[] = { 'M', 'F', 'T', 'S' };
+    const boost::uint32_t byteOrderMark = 0x01020304;
+    const Size headerSize = 16;
+
+    // A step between consecutive dates is encoded as 2k when the later
+    // date is the (k + 1)-th business day after the earlier one, and as
+    // 2g + 1 for a gap of g calendar days otherwise; equal steps are
+    // run-length encoded as (step, run) pairs.
+    void encodeDates(const Calendar& calendar,
+                     const Date::serial_type* dates,
+                     Size n,
+                     std::vector<unsigned char>& out) {
+      BigNatural step = 0, run = 0;
+      for (Size i = 1; i < n; ++i) {
+        BigNatural current;
+        if (calendar.isBusinessDayUnchecked(Date::unchecked(dates[i]))) {
+          BigNatural skipped = 0;
+          for (Date::serial_type d = dates[i - 1] + 1; d < dates[i]; ++d) {
+            if (calendar.isBusinessDayUnchecked(Date::unchecked(d))) {
+              ++skipped;
+            }
+          }
+          current = 2 * skipped;
+        } else {
+          current = 2 * BigNatural(dates[i] - dates[i - 1]) + 1;
+        }
+        if (run > 0 && current == step) {
+          ++run;
+        } else {
+          if (run > 0) {
+            detail::putVarint(out, step);
+            detail::putVarint(out, run);
+          }
+          step = current;
+          run = 1;
+        }
+      }
+      if (run > 0) {
+        detail::putVarint(out, step);
+        detail::putVarint(out, run);
+      }
+    }
+
+    inline boost::uint64_t bitsOf(Real x) {
+      boost::uint64_t bits;
+      std::memcpy(&bits, &x, sizeof(bits));
+      return bits;
+    }
+
+    // Each value is xored with the previous one and written as a byte
+    // holding the numbers of leading (high nibble) and trailing (low
+    // nibble) zero bytes of the result, followed by its remaining bytes
+    // from the least significant.
+    void encodeValues(const Real* values,
+                      Size n,
+                      std::vector<unsigned char>& out) {
+      boost::uint64_t previous = 0;
+      for (Size i = 0; i < n; ++i) {
+        const boost::uint64_t bits = bitsOf(values[i]);
+        const boost::uint64_t x = bits ^ previous;
+        previous = bits;
+        if (x == 0) {
+          out.push_back(0x80);
+          continue;
+        }
+        unsigned int leading = 0, trailing = 0;
+        while (((x >> (56 - 8 * leading)) & 0xff) == 0) {
+          ++leading;
+        }
+        while (((x >> (8 * trailing)) & 0xff) == 0) {
+          ++trailing;
+        }
+        out.push_back(static_cast<unsigned char>(leading << 4 | trailing));
+        for (unsigned int b = trailing; b < 8 - leading; ++b) {
+          out.push_back(static_cast<unsigned char>(x >> (8 * b)));
+        }
+      }
+    }
+
+    void appendBlock(const Calendar& calendar,
+                     const Date::serial_type* dates,
+                     const Real* values,
+                     Size n,
+                     std::vector<TimeSeriesBlock>& blocks,
+                     std::vector<unsigned char>& encodedDates,
+                     std::vector<unsigned char>& encodedValues) {
+      const Size limit = std::numeric_limits<boost::uint32_t>::max();
+      MF_REQUIRE(encodedDates.size() < limit && encodedValues.size() < limit,
+                 "time series too large");
+      TimeSeriesBlock block;
+      block.first = boost::int32_t(dates[0]);
+      block.last = boost::int32_t(dates[n - 1]);
+      block.size = boost::uint32_t(n);
+      block.dateOffset = boost::uint32_t(encodedDates.size());
+      block.valueOffset = boost::uint32_t(encodedValues.size());
+      block.reserved = 0;
+      blocks.push_back(block);
+      encodeDates(calendar, dates, n, encodedDates);
+      encodeValues(values, n, encodedValues);
+    }
+
+    template <class T>
+    void putRaw(std::vector<unsigned char>& out, const T& x) {
+      const unsigned char* p = reinterpret_cast<const unsigned char*>(&x);
+      out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    bool earlierLast(const TimeSeriesBlock& block, Date::serial_type d) {
+      return block.last < d;
+    }
+
+    bool laterFirst(Date::serial_type d, const TimeSeriesBlock& block) {
+      return d < block.first;
+    }
+
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TimeSeriesView::TimeSeriesView()
+    : blocks_(0), blockCount_(0), dates_(0), dateBytes_(0),
+      values_(0), valueBytes_(0), tailDates_(0), tailValues_(0),
+      tailSize_(0), size_(0) {}
+
+  TimeSeriesView::TimeSeriesView(const Calendar& calendar,
+                                 const TimeSeriesBlock* blocks,
+                                 Size blockCount,
+                                 const unsigned char* dates,
+                                 Size dateBytes,
+                                 const unsigned char* values,
+                                 Size valueBytes,
+                                 const Date::serial_type* tailDates,
+                                 const Real* tailValues,
+                                 Size tailSize)
+    : calendar_(calendar), blocks_(blocks), blockCount_(blockCount),
+      dates_(dates), dateBytes_(dateBytes), values_(values),
+      valueBytes_(valueBytes), tailDates_(tailDates), tailValues_(tailValues),
+      tailSize_(tailSize), size_(tailSize) {
+    for (Size b = 0; b < blockCount; ++b) {
+      size_ += blocks[b].size;
+    }
+  }
+
+  Date TimeSeriesView::firstDate() const {
+    MF_REQUIRE(!empty(), "empty time series");
+    return Date::unchecked(blockCount_ > 0 ? blocks_[0].first : tailDates_[0]);
+  }
+
+  Date TimeSeriesView::lastDate() const {
+    MF_REQUIRE(!empty(), "empty time series");
+    return Date::unchecked(tailSize_ > 0 ? tailDates_[tailSize_ - 1]
+                           : blocks_[blockCount_ - 1].last);
+  }
+
+  Size TimeSeriesView::bytes() const {
+    return blockCount_ * sizeof(TimeSeriesBlock) + dateBytes_ + valueBytes_
+      + tailSize_ * (sizeof(Date::serial_type) + sizeof(Real));
+  }
+
+  void TimeSeriesView::decodeDates(Size b, Date::serial_type* dates) const {
+    const TimeSeriesBlock& block = blocks_[b];
+    const Size end = b + 1 < blockCount_ ? blocks_[b + 1].dateOffset
+                                         : dateBytes_;
+    MF_REQUIRE(block.size > 0 && block.size <= TimeSeries::blockCapacity
+               && block.dateOffset <= end && end <= dateBytes_,
+               "malformed time-series block");
+    const unsigned char* p = dates_ + block.dateOffset;
+    const unsigned char* stop = dates_ + end;
+
+    Date::serial_type d = block.first;
+    dates[0] = d;
+    for (Size i = 1; i < block.size; ) {
+      const BigNatural step = detail::getVarint(p, stop);
+      const BigNatural run = detail::getVarint(p, stop);
+      MF_REQUIRE(run > 0 && run <= block.size - i,
+                 "malformed time-series block");
+      for (BigNatural r = 0; r < run; ++r) {
+        if (step & 1) {
+          MF_REQUIRE(step >> 1 <= BigNatural(block.last - d),
+                     "malformed time-series block");
+          d += Date::serial_type(step >> 1);
+        } else {
+          for (BigNatural k = step / 2 + 1; k > 0; ) {
+            MF_REQUIRE(d < block.last, "time-series dates do not match "
+                       "the calendar " << calendar_.name());
+            ++d;
+            if (calendar_.isBusinessDayUnchecked(Date::unchecked(d))) {
+              --k;
+            }
+          }
+        }
+        dates[i++] = d;
+      }
+    }
+    MF_REQUIRE(d == block.last, "time-series dates do not match the "
+               "calendar " << calendar_.name());
+  }
+
+  void TimeSeriesView::decodeValues(Size b, Real* values, Size n) const {
+    const TimeSeriesBlock& block = blocks_[b];
+    const Size end = b + 1 < blockCount_ ? blocks_[b + 1].valueOffset
+                                         : valueBytes_;
+    MF_REQUIRE(n <= block.size && block.valueOffset <= end
+               && end <= valueBytes_, "malformed time-series block");
+    const unsigned char* p = values_ + block.valueOffset;
+    const unsigned char* stop = values_ + end;
+
+    boost::uint64_t bits = 0;
+    for (Size i = 0; i < n; ++i) {
+      MF_REQUIRE(p != stop, "truncated time-series block");
+      const unsigned int leading = *p >> 4;
+      const unsigned int trailing = *p & 0xf;
+      ++p;
+      MF_REQUIRE(leading + trailing <= 8, "malformed time-series block");
+      MF_REQUIRE(Size(stop - p) >= 8 - leading - trailing,
+                 "truncated time-series block");
+      boost::uint64_t x = 0;
+      for (unsigned int k = trailing; k < 8 - leading; ++k) {
+        x |= boost::uint64_t(*p++) << (8 * k);
+      }
+      bits ^= x;
+      std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+  }
+
+  bool TimeSeriesView::find(const Date& d, Real& value) const {
+    const Date::serial_type s = d.serialNumber();
+    if (tailSize_ > 0 && s >= tailDates_[0]) {
+      const Date::serial_type* i =
+        std::lower_bound(tailDates_, tailDates_ + tailSize_, s);
+      if (i == tailDates_ + tailSize_ || *i != s) {
+        return false;
+      }
+      value = tailValues_[i - tailDates_];
+      return true;
+    }
+
+    const TimeSeriesBlock* block =
+      std::lower_bound(blocks_, blocks_ + blockCount_, s, earlierLast);
+    if (block == blocks_ + blockCount_ || block->first > s) {
+      return false;
+    }
+    const Size b = Size(block - blocks_);
+    Date::serial_type dates[TimeSeries::blockCapacity];
+    decodeDates(b, dates);
+    const Date::serial_type* i = std::lower_bound(dates, dates + block->size, s);
+    if (*i != s) {
+      return false;
+    }
+    const Size n = Size(i - dates) + 1;
+    Real values[TimeSeries::blockCapacity];
+    decodeValues(b, values, n);
+    value = values[n - 1];
+    return true;
+  }
+
+  bool TimeSeriesView::findLatest(const Date& d,
+                                  Date::serial_type& date,
+                                  Real& value) const {
+    const Date::serial_type s = d.serialNumber();
+    if (tailSize_ > 0 && s >= tailDates_[0]) {
+      const Size i = Size(std::upper_bound(tailDates_, tailDates_ + tailSize_,
+                                           s) - tailDates_) - 1;
+      date = tailDates_[i];
+      value = tailValues_[i];
+      return true;
+    }
+
+    // the last block starting on or before the date
+    const TimeSeriesBlock* block =
+      std::upper_bound(blocks_, blocks_ + blockCount_, s, laterFirst);
+    if (block == blocks_) {
+      return false;
+    }
+    const Size b = Size(--block - blocks_);
+    Date::serial_type dates[TimeSeries::blockCapacity];
+    decodeDates(b, dates);
+    const Size n = Size(std::upper_bound(dates, dates + block->size, s)
+                        - dates);
+    Real values[TimeSeries::blockCapacity];
+    decodeValues(b, values, n);
+    date = dates[n - 1];
+    value = values[n - 1];
+    return true;
+  }
+
+  Real TimeSeriesView::value(const Date& d) const {
+    Real x;
+    MF_REQUIRE(find(d, x), "no observation at " << d);
+    return x;
+  }
+
+  Size TimeSeriesView::scan(const Date& from,
+                            const Date& to,
+                            std::vector<Date::serial_type>& dates,
+                            std::vector<Real>& values) const {
+    MF_TRACE_SPAN("TimeSeriesView::scan", "timeseries");
+    const Date::serial_type first = from.serialNumber();
+    const Date::serial_type last = to.serialNumber();
+    const Size initial = dates.size();
+
+    Date::serial_type blockDates[TimeSeries::blockCapacity];
+    Real blockValues[TimeSeries::blockCapacity];
+    for (Size b = Size(std::lower_bound(blocks_, blocks_ + blockCount_,
+                                        first, earlierLast) - blocks_);
+         b < blockCount_ && blocks_[b].first <= last; ++b) {
+      const Size n = blocks_[b].size;
+      decodeDates(b, blockDates);
+      decodeValues(b, blockValues, n);
+      for (Size i = 0; i < n; ++i) {
+        if (blockDates[i] >= first && blockDates[i] <= last) {
+          dates.push_back(blockDates[i]);
+          values.push_back(blockValues[i]);
+        }
+      }
+    }
+    for (Size i = 0; i < tailSize_; ++i) {
+      if (tailDates_[i] >= first && tailDates_[i] <= last) {
+        dates.push_back(tailDates_[i]);
+        values.push_back(tailValues_[i]);
+      }
+    }
+    return dates.size() - initial;
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TimeSeries::TimeSeries(const Calendar& calendar)
+    : calendar_(calendar), size_(0) {
+    MF_REQUIRE(!calendar.empty(), "no calendar provided");
+    tailDates_.reserve(blockCapacity);
+    tailValues_.reserve(blockCapacity);
+  }
+
+  void TimeSeries::append(const Date& d, Real value) {
+    const Date::serial_type s = d.serialNumber();
+    if (size_ > 0) {
+      const Date::serial_type last = tailDates_.empty()
+        ? blocks_.back().last : tailDates_.back();
+      MF_REQUIRE(s > last, "observation at " << d
+                 << " not later than the last one ("
+                 << Date::unchecked(last) << ")");
+    }
+    tailDates_.push_back(s);
+    tailValues_.push_back(value);
+    ++size_;
+    if (tailDates_.size() == blockCapacity) {
+      seal();
+    }
+  }
+
+  void TimeSeries::append(const Date::serial_type* dates,
+                          const Real* values,
+                          Size n) {
+    MF_TRACE_SPAN("TimeSeries::append", "timeseries");
+    for (Size i = 0; i < n; ++i) {
+      append(Date(dates[i]), values[i]);
+    }
+  }
+
+  void TimeSeries::seal() {
+    appendBlock(calendar_, &tailDates_[0], &tailValues_[0],
+                tailDates_.size(), blocks_, dates_, values_);
+    tailDates_.clear();
+    tailValues_.clear();
+  }
+
+  TimeSeriesView TimeSeries::view() const {
+    return TimeSeriesView(calendar_,
+                          blocks_.empty() ? 0 : &blocks_[0], blocks_.size(),
+                          dates_.empty() ? 0 : &dates_[0], dates_.size(),
+                          values_.empty() ? 0 : &values_[0], values_.size(),
+                          tailDates_.empty() ? 0 : &tailDates_[0],
+                          tailValues_.empty() ? 0 : &tailValues_[0],
+                          tailDates_.size());
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TimeSeriesStore::TimeSeriesStore(const void* data, Size size) {
+    open(static_cast<const unsigned char*>(data), size);
+  }
+
+  TimeSeriesStore::TimeSeriesStore(const std::string& path)
+    : file_(new MappedFile(path)) {
+    open(file_->data(), file_->size());
+  }
+
+  void TimeSeriesStore::open(const unsigned char* data, Size size) {
+    MF_TRACE_SPAN("TimeSeriesStore::open", "timeseries");
+    MF_REQUIRE(size >= headerSize
+               && std::equal(magic, magic + sizeof(magic), data),
+               "not a time-series store");
+    MF_REQUIRE(reinterpret_cast<std::size_t>(data) % 8 == 0,
+               "time-series store not aligned on 8 bytes");
+    boost::uint32_t byteOrder;
+    boost::uint64_t directory;
+    std::memcpy(&byteOrder, data + 4, sizeof(byteOrder));
+    std::memcpy(&directory, data + 8, sizeof(directory));
+    MF_REQUIRE(byteOrder == byteOrderMark,
+               "time-series store written with a different byte order");
+    MF_REQUIRE(directory >= headerSize && directory <= size,
+               "malformed time-series store");
+
+    BinaryReader reader(data + directory, size - Size(directory));
+    const BigNatural count = reader.readUnsigned();
+    MF_REQUIRE(count <= size, "malformed time-series store");
+    names_.reserve(Size(count));
+    series_.reserve(Size(count));
+    for (BigNatural k = 0; k < count; ++k) {
+      const std::string name = reader.readString();
+      MF_REQUIRE(names_.empty() || names_.back() < name,
+                 "time series not in increasing name order");
+      const Calendar calendar = reader.readCalendar();
+      const BigNatural observations = reader.readUnsigned();
+      const BigNatural blockCount = reader.readUnsigned();
+      const BigNatural blockOffset = reader.readUnsigned();
+      const BigNatural dateOffset = reader.readUnsigned();
+      const BigNatural dateBytes = reader.readUnsigned();
+      const BigNatural valueOffset = reader.readUnsigned();
+      const BigNatural valueBytes = reader.readUnsigned();
+      MF_REQUIRE(blockOffset % alignof(TimeSeriesBlock) == 0
+                 && blockCount <= directory / sizeof(TimeSeriesBlock)
+                 && blockOffset <= directory
+                    - blockCount * sizeof(TimeSeriesBlock)
+                 && dateOffset <= directory
+                 && dateBytes <= directory - dateOffset
+                 && valueOffset <= directory
+                 && valueBytes <= directory - valueOffset,
+                 "malformed directory entry for time series '"
+                 << name << "'");
+
+      const TimeSeriesView view(
+        calendar,
+        reinterpret_cast<const TimeSeriesBlock*>(data + blockOffset),
+        Size(blockCount), data + dateOffset, Size(dateBytes),
+        data + valueOffset, Size(valueBytes), 0, 0, 0);
+      MF_REQUIRE(view.size() == observations,
+                 "malformed block index for time series '" << name << "'");
+      names_.push_back(name);
+      series_.push_back(view);
+    }
+  }
+
+  bool TimeSeriesStore::contains(const std::string& name) const {
+    return std::binary_search(names_.begin(), names_.end(), name);
+  }
+
+  TimeSeriesView TimeSeriesStore::series(const std::string& name) const {
+    const std::vector<std::string>::const_iterator i =
+      std::lower_bound(names_.begin(), names_.end(), name);
+    MF_REQUIRE(i != names_.end() && *i == name,
+               "no time series named '" << name << "'");
+    return series_[i - names_.begin()];
+  }
+
+  TimeSeriesView TimeSeriesStore::series(Size i) const {
+    MF_REQUIRE(i < size(), "time series " << i << " out of range [0, "
+               << size() << ")");
+    return series_[i];
+  }
+
+  void TimeSeriesStore::write(std::ostream& out,
+                              const std::map<std::string, TimeSeries>& series) {
+    MF_TRACE_SPAN("TimeSeriesStore::write", "timeseries");
+    std::vector<unsigned char> buffer(magic, magic + sizeof(magic));
+    putRaw(buffer, byteOrderMark);
+    putRaw(buffer, boost::uint64_t(0));
+
+    BinaryWriter directory;
+    directory.writeUnsigned(series.size());
+    for (std::map<std::string, TimeSeries>::const_iterator i = series.begin();
+         i != series.end(); ++i) {
+      const TimeSeries& s = i->second;
+      std::vector<TimeSeriesBlock> blocks(s.blocks_);
+      std::vector<unsigned char> dates(s.dates_);
+      std::vector<unsigned char> values(s.values_);
+      if (!s.tailDates_.empty()) {
+        appendBlock(s.calendar_, &s.tailDates_[0], &s.tailValues_[0],
+                    s.tailDates_.size(), blocks, dates, values);
+      }
+
+      buffer.resize((buffer.size() + 7) / 8 * 8, 0);
+      const Size blockOffset = buffer.size();
+      for (Size b = 0; b < blocks.size(); ++b) {
+        putRaw(buffer, blocks[b]);
+      }
+      const Size dateOffset = buffer.size();
+      buffer.insert(buffer.end(), dates.begin(), dates.end());
+      const Size valueOffset = buffer.size();
+      buffer.insert(buffer.end(), values.begin(), values.end());
+
+      directory.write(i->first);
+      directory.write(s.calendar_);
+      directory.writeUnsigned(s.size());
+      directory.writeUnsigned(blocks.size());
+      directory.writeUnsigned(blockOffset);
+      directory.writeUnsigned(dateOffset);
+      directory.writeUnsigned(dates.size());
+      directory.writeUnsigned(valueOffset);
+      directory.writeUnsigned(values.size());
+    }
+
+    const boost::uint64_t directoryOffset = buffer.size();
+    std::memcpy(&buffer[8], &directoryOffset, sizeof(directoryOffset));
+    buffer.insert(buffer.end(), directory.buffer().begin(),
+                  directory.buffer().end());
+    out.write(reinterpret_cast<const char*>(&buffer[0]),
+              std::streamsize(buffer.size()));
+    MF_REQUIRE(out, "failed to write the time-series store");
+  }
+
+}
@@ -0,0 +1,283 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file timeseries.hpp
+ * @brief compressed historical time series and their file store
+ */
+
+#ifndef MATHFIN_TIMESERIES_HPP
+#define MATHFIN_TIMESERIES_HPP
+
+#include <time/calendar.hpp>
+#include <time/calendars/nullcalendar.hpp>
+#include <time/date.hpp>
+
+#include <boost/cstdint.hpp>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MathFin {
+
+  class MappedFile;
+
+  namespace detail {
+
+    /**
+     * Index entry of a block of observations, laid out identically in
+     * memory and in store files.
+     */
+    struct TimeSeriesBlock {
+      boost::int32_t first;        // serial number of the first date
+      boost::int32_t last;         // serial number of the last date
+      boost::uint32_t size;        // number of observations
+      boost::uint32_t dateOffset;  // start of the encoded dates
+      boost::uint32_t valueOffset; // start of the encoded values
+      boost::uint32_t reserved;
+    };
+
+  }
+
+  /**
+   * Read-only access to the observations of a time series.
+   *
+   * Observations are grouped into blocks of up to
+   * TimeSeries::blockCapacity consecutive dates.  Within a block the dates
+   * are run-length encoded business-day steps on the calendar of the
+   * series, so that a daily series of business days takes a couple of
+   * bytes per block, and each value is stored as its exclusive or with
+   * the previous one, stripped of its leading and trailing zero bytes, so
+   * that repeated values take one byte.  Random access searches the
+   * block index and decodes a single block; range scans decode the
+   * blocks they cover.  Neither allocates memory except to append to the
+   * given vectors.
+   *
+   * A view refers to the memory of the TimeSeries or TimeSeriesStore it
+   * was obtained from, which must outlive it and, for a TimeSeries, not
+   * be appended to meanwhile.
+   *
+   * @ingroup datetime
+   */
+  class TimeSeriesView {
+  public:
+    TimeSeriesView();
+
+    Size size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const Calendar& calendar() const { return calendar_; }
+    Date firstDate() const;
+    Date lastDate() const;
+
+    /**
+     * Sets <tt>value</tt> to the observation at the given date and
+     * returns whether there is one.
+     */
+    bool find(const Date& d, Real& value) const;
+
+    /**
+     * Sets <tt>date</tt> and <tt>value</tt> to the latest observation
+     * dated on or before <tt>d</tt> and returns whether there is one.
+     */
+    bool findLatest(const Date& d,
+                    Date::serial_type& date,
+                    Real& value) const;
+
+    /**
+     * The observation at the given date; throws an Error if there is
+     * none.
+     */
+    Real value(const Date& d) const;
+
+    /**
+     * Appends the observations dated between <tt>from</tt> and
+     * <tt>to</tt>, both included, and returns their number.
+     */
+    Size scan(const Date& from,
+              const Date& to,
+              std::vector<Date::serial_type>& dates,
+              std::vector<Real>& values) const;
+
+    /**
+     * Number of blocks, a not yet full last one included.
+     */
+    Size blocks() const { return blockCount_ + (tailSize_ > 0 ? 1 : 0); }
+
+    /**
+     * Bytes taken by the encoded observations and the block index.
+     */
+    Size bytes() const;
+
+  private:
+    friend class TimeSeries;
+    friend class TimeSeriesStore;
+
+    TimeSeriesView(const Calendar& calendar,
+                   const detail::TimeSeriesBlock* blocks,
+                   Size blockCount,
+                   const unsigned char* dates,
+                   Size dateBytes,
+                   const unsigned char* values,
+                   Size valueBytes,
+                   const Date::serial_type* tailDates,
+                   const Real* tailValues,
+                   Size tailSize);
+
+    // decode the dates of block b and its first n values
+    void decodeDates(Size b, Date::serial_type* dates) const;
+    void decodeValues(Size b, Real* values, Size n) const;
+
+    Calendar calendar_;
+    const detail::TimeSeriesBlock* blocks_;
+    Size blockCount_;
+    const unsigned char* dates_;
+    Size dateBytes_;
+    const unsigned char* values_;
+    Size valueBytes_;
+    // observations not yet encoded
+    const Date::serial_type* tailDates_;
+    const Real* tailValues_;
+    Size tailSize_;
+    Size size_;
+  };
+
+  /**
+   * Time series of daily observations with streaming append.
+   *
+   * Observations must be appended in increasing date order; they are
+   * encoded a block at a time as described for TimeSeriesView, the
+   * latest ones being kept as given until their block is full.  The
+   * encoding of dates depends on the holidays of the calendar; the
+   * calendar should be the one the series is observed on, a
+   * NullCalendar (the default) encoding calendar-day steps.
+   *
+   * @ingroup datetime
+   */
+  class TimeSeries {
+  public:
+    /**
+     * Maximum number of observations in a block.
+     */
+    static const Size blockCapacity = 128;
+
+    explicit TimeSeries(const Calendar& calendar = NullCalendar());
+
+    /**
+     * Appends an observation dated after the last one.
+     */
+    void append(const Date& d, Real value);
+
+    /**
+     * Appends <tt>n</tt> observations dated in increasing order, after
+     * the last one.
+     */
+    void append(const Date::serial_type* dates, const Real* values, Size n);
+
+    Size size() const { return size_; }
+    const Calendar& calendar() const { return calendar_; }
+
+    /**
+     * Read-only access to the observations appended so far.
+     */
+    TimeSeriesView view() const;
+
+  private:
+    friend class TimeSeriesStore;
+
+    void seal();
+
+    Calendar calendar_;
+    std::vector<detail::TimeSeriesBlock> blocks_;
+    std::vector<unsigned char> dates_;
+    std::vector<unsigned char> values_;
+    std::vector<Date::serial_type> tailDates_;
+    std::vector<Real> tailValues_;
+    Size size_;
+  };
+
+  /**
+   * Named time series read in place from a buffer or a file.
+   *
+   * A store starts with the bytes 'M', 'F', 'T', 'S', a byte-order mark
+   * and the offset of its directory; then come, for each series, its
+   * block index followed by its encoded dates and values, exactly as
+   * held in memory by TimeSeries; the directory, in the encoding of
+   * BinaryWriter, gives the name, calendar, size and sections of each
+   * series.  Opening a store reads the directory only: series are read
+   * directly from the buffer, which is why a store file is mapped into
+   * memory rather than read.  Store files are not portable between
+   * platforms of different byte order.
+   *
+   * @ingroup datetime
+   */
+  class TimeSeriesStore {
+  public:
+    /**
+     * Store held in the given buffer, which must outlive the store and
+     * the views obtained from it and be aligned on 8 bytes; throws an
+     * Error if the buffer is malformed.
+     */
+    TimeSeriesStore(const void* data, Size size);
+
+    /**
+     * Store held in the given file, which is mapped into memory.
+     */
+    explicit TimeSeriesStore(const std::string& path);
+
+    /**
+     * Number of series.
+     */
+    Size size() const { return names_.size(); }
+
+    /**
+     * Series names, in increasing order.
+     */
+    const std::vector<std::string>& names() const { return names_; }
+
+    bool contains(const std::string& name) const;
+
+    /**
+     * The series of the given name; throws an Error if there is none.
+     */
+    TimeSeriesView series(const std::string& name) const;
+
+    /**
+     * The series of the given index in names().
+     */
+    TimeSeriesView series(Size i) const;
+
+    /**
+     * Writes the given series in the store format.
+     */
+    static void write(std::ostream& out,
+                      const std::map<std::string, TimeSeries>& series);
+
+  private:
+    void open(const unsigned char* data, Size size);
+
+    std::shared_ptr<MappedFile> file_;
+    std::vector<std::string> names_;
+    std::vector<TimeSeriesView> series_;
+  };
+
+}
+
+#endif /* MATHFIN_TIMESERIES_HPP */
@@ -0,0 +1,226 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include <test/catch.hpp>
+#include <time/calendars/target.hpp>
+#include <time/calendars/unitedkingdom.hpp>
+#include <time/timeseries.hpp>
+
+using namespace MathFin;
+
+namespace {
+
+  // daily fixings on the business days of the calendar, with a few
+  // observations on holidays, a rate moving by steps and a noisy close
+  void makeHistory(const Calendar& calendar,
+                   const Date& from,
+                   const Date& to,
+                   bool steps,
+                   std::map<Date::serial_type, Real>& history) {
+    Real rate = 0.0125;
+    boost::uint32_t state = 12345;
+    for (Date::serial_type s = from.serialNumber(); s <= to.serialNumber();
+         ++s) {
+      const bool business = calendar.isBusinessDay(Date(s));
+      if (!business && s % 97 != 0) {
+        continue;
+      }
+      state = state * 1664525u + 1013904223u;
+      if (steps) {
+        if (state % 64 == 0) {
+          rate += 0.0025 * ((state >> 8) % 3) - 0.0025;
+        }
+        history[s] = rate;
+      } else {
+        history[s] = 100.0 + (state >> 8) % 100000 / 1000.0;
+      }
+    }
+  }
+
+  TimeSeries makeSeries(const Calendar& calendar,
+                        const std::map<Date::serial_type, Real>& history) {
+    TimeSeries series(calendar);
+    for (std::map<Date::serial_type, Real>::const_iterator i =
+           history.begin(); i != history.end(); ++i) {
+      series.append(Date(i->first), i->second);
+    }
+    return series;
+  }
+
+  void checkSeries(const TimeSeriesView& series,
+                   const std::map<Date::serial_type, Real>& history,
+                   const Date& from,
+                   const Date& to) {
+    REQUIRE(series.size() == history.size());
+    REQUIRE(series.firstDate().serialNumber() == history.begin()->first);
+    REQUIRE(series.lastDate().serialNumber() == history.rbegin()->first);
+    for (Date::serial_type s = from.serialNumber() - 5;
+         s <= to.serialNumber() + 5; ++s) {
+      Real value = 0.0;
+      const std::map<Date::serial_type, Real>::const_iterator i =
+        history.find(s);
+      REQUIRE(series.find(Date(s), value) == (i != history.end()));
+      if (i != history.end()) {
+        REQUIRE(value == i->second);
+      }
+
+      Date::serial_type latest = 0;
+      std::map<Date::serial_type, Real>::const_iterator j =
+        history.upper_bound(s);
+      REQUIRE(series.findLatest(Date(s), latest, value)
+              == (j != history.begin()));
+      if (j != history.begin()) {
+        --j;
+        REQUIRE(latest == j->first);
+        REQUIRE(value == j->second);
+      }
+    }
+
+    // ranges within a block, across blocks and beyond the series
+    const Date::serial_type starts[] = {
+      from.serialNumber() - 10, from.serialNumber() + 3,
+      from.serialNumber() + 1000, to.serialNumber() - 40 };
+    const Date::serial_type lengths[] = { 0, 6, 200, 5000 };
+    for (Size a = 0; a < 4; ++a) {
+      for (Size b = 0; b < 4; ++b) {
+        const Date::serial_type first = starts[a];
+        const Date::serial_type last = starts[a] + lengths[b];
+        std::vector<Date::serial_type> dates(1, 0);
+        std::vector<Real> values(1, 0.0);
+        const Size n = series.scan(Date(first), Date(last), dates, values);
+        std::vector<Date::serial_type> expectedDates(1, 0);
+        std::vector<Real> expectedValues(1, 0.0);
+        for (std::map<Date::serial_type, Real>::const_iterator i =
+               history.lower_bound(first);
+             i != history.end() && i->first <= last; ++i) {
+          expectedDates.push_back(i->first);
+          expectedValues.push_back(i->second);
+        }
+        REQUIRE(n == expectedDates.size() - 1);
+        REQUIRE(dates == expectedDates);
+        REQUIRE(values == expectedValues);
+      }
+    }
+  }
+
+}
+
+TEST_CASE("Time series give back the appended observations",
+          "[timeseries]") {
+  const Date from(4, Month::January, 1999);
+  const Date to(31, Month::December, 2018);
+  std::map<Date::serial_type, Real> fixings, closes;
+  makeHistory(TARGET(), from, to, true, fixings);
+  makeHistory(UnitedKingdom(), from, to, false, closes);
+
+  const TimeSeries fixingSeries = makeSeries(TARGET(), fixings);
+  const TimeSeries closeSeries = makeSeries(UnitedKingdom(), closes);
+  checkSeries(fixingSeries.view(), fixings, from, to);
+  checkSeries(closeSeries.view(), closes, from, to);
+
+  // business-day dates and a rate moving by steps take a fraction of
+  // the twelve bytes per observation of a serial and a value
+  const TimeSeriesView view = fixingSeries.view();
+  REQUIRE(view.blocks() ==
+          (fixings.size() + TimeSeries::blockCapacity - 1)
+          / TimeSeries::blockCapacity);
+  REQUIRE(view.bytes() < 3 * fixings.size());
+
+  SECTION("series without a calendar encode calendar-day steps") {
+    const TimeSeries series = makeSeries(NullCalendar(), closes);
+    checkSeries(series.view(), closes, from, to);
+  }
+
+  SECTION("observations can be appended to a series being read") {
+    TimeSeries series = TimeSeries(TARGET());
+    std::map<Date::serial_type, Real> partial;
+    for (std::map<Date::serial_type, Real>::const_iterator i =
+           fixings.begin(); partial.size() < 1000; ++i) {
+      series.append(Date(i->first), i->second);
+      partial.insert(*i);
+      if (partial.size() % 250 == 0) {
+        checkSeries(series.view(), partial, from,
+                    Date(partial.rbegin()->first));
+      }
+    }
+    REQUIRE_THROWS_AS(series.append(Date(partial.rbegin()->first), 1.0),
+                      Error);
+    REQUIRE_THROWS_AS(series.view().value(Date(1, Month::January, 1999)),
+                      Error);
+  }
+}
+
+TEST_CASE("Time-series stores are read in place", "[timeseries]") {
+  const Date from(2, Month::January, 2012);
+  const Date to(28, Month::December, 2018);
+  std::map<Date::serial_type, Real> fixings, closes;
+  makeHistory(TARGET(), from, to, true, fixings);
+  makeHistory(UnitedKingdom(), from, to, false, closes);
+
+  std::map<std::string, TimeSeries> series;
+  series.insert(std::make_pair("EURIBOR6M", makeSeries(TARGET(), fixings)));
+  series.insert(std::make_pair("FTSE", makeSeries(UnitedKingdom(), closes)));
+  series.insert(std::make_pair("EMPTY", TimeSeries()));
+
+  std::ostringstream out;
+  TimeSeriesStore::write(out, series);
+  const std::string bytes = out.str();
+
+  // the buffer must be aligned as a mapped file is
+  std::vector<boost::uint64_t> buffer((bytes.size() + 7) / 8);
+  std::memcpy(&buffer[0], bytes.data(), bytes.size());
+  const TimeSeriesStore store(&buffer[0], bytes.size());
+  REQUIRE(store.size() == 3);
+  REQUIRE(store.names()[0] == "EMPTY");
+  REQUIRE(store.contains("FTSE"));
+  REQUIRE(!store.contains("FTSE100"));
+  REQUIRE(store.series("EMPTY").empty());
+  REQUIRE(store.series(1).calendar() == TARGET());
+  checkSeries(store.series("EURIBOR6M"), fixings, from, to);
+  checkSeries(store.series("FTSE"), closes, from, to);
+  REQUIRE_THROWS_AS(store.series("FTSE100"), Error);
+
+  SECTION("from a mapped file") {
+    const std::string path = "timeseriesTest.mfts";
+    {
+      std::ofstream file(path.c_str(), std::ios::binary);
+      TimeSeriesStore::write(file, series);
+    }
+    const TimeSeriesStore mapped(path);
+    checkSeries(mapped.series("FTSE"), closes, from, to);
+    std::remove(path.c_str());
+  }
+
+  SECTION("malformed stores are rejected") {
+    std::vector<boost::uint64_t> corrupt(buffer);
+    reinterpret_cast<unsigned char*>(&corrupt[0])[0] = 'X';
+    REQUIRE_THROWS_AS(TimeSeriesStore(&corrupt[0], bytes.size()), Error);
+    REQUIRE_THROWS_AS(TimeSeriesStore(&buffer[0], bytes.size() - 1), Error);
+  }
+}
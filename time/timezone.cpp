@@ -0,0 +1,409 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <base/error.hpp>
+#include <base/trace.hpp>
+#include <time/civil.hpp>
+#include <time/timezone.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+namespace MathFin {
+
+  namespace {
+
+    struct Transition {
+      BigInteger utc;   // seconds since 1970-01-01T00:00:00 UTC
+      Integer offset;   // offset from UTC in force from utc onwards
+    };
+
+    /*
+      Recurring daylight-saving rule, in the POSIX TZ format: the clocks
+      change on the given weekday (0 = Sunday) of the given week of the
+      month (5 = last), at the given number of seconds after local
+      midnight.
+    */
+    struct Rule {
+      Integer firstYear;
+      Integer standardOffset, daylightOffset;
+      Integer startMonth, startWeek, startWeekday, startTime;
+      Integer endMonth, endWeek, endWeekday, endTime;
+    };
+
+    const Integer firstIndexedYear = 1970;
+    const Integer lastIndexedYear = 2199;
+
+    // Transition tables generated from the IANA time-zone database
+    // (release 2025b); transitions explained by the rule of the zone are
+    // omitted.
+
+    // America/New_York, explicit transitions since 1970
+    const Transition newYorkTransitions[] = {
+      {   9961200, -14400}, {  25682400, -18000}, {  41410800, -14400},
+      {  57736800, -18000}, {  73465200, -14400}, {  89186400, -18000},
+      { 104914800, -14400}, { 120636000, -18000}, { 126687600, -14400},
+      { 152085600, -18000}, { 162370800, -14400}, { 183535200, -18000},
+      { 199263600, -14400}, { 215589600, -18000}, { 230713200, -14400},
+      { 247039200, -18000}, { 262767600, -14400}, { 278488800, -18000},
+      { 294217200, -14400}, { 309938400, -18000}, { 325666800, -14400},
+      { 341388000, -18000}, { 357116400, -14400}, { 372837600, -18000},
+      { 388566000, -14400}, { 404892000, -18000}, { 420015600, -14400},
+      { 436341600, -18000}, { 452070000, -14400}, { 467791200, -18000},
+      { 483519600, -14400}, { 499240800, -18000}, { 514969200, -14400},
+      { 530690400, -18000}, { 544604400, -14400}, { 562140000, -18000},
+      { 576054000, -14400}, { 594194400, -18000}, { 607503600, -14400},
+      { 625644000, -18000}, { 638953200, -14400}, { 657093600, -18000},
+      { 671007600, -14400}, { 688543200, -18000}, { 702457200, -14400},
+      { 719992800, -18000}, { 733906800, -14400}, { 752047200, -18000},
+      { 765356400, -14400}, { 783496800, -18000}, { 796806000, -14400},
+      { 814946400, -18000}, { 828860400, -14400}, { 846396000, -18000},
+      { 860310000, -14400}, { 877845600, -18000}, { 891759600, -14400},
+      { 909295200, -18000}, { 923209200, -14400}, { 941349600, -18000},
+      { 954658800, -14400}, { 972799200, -18000}, { 986108400, -14400},
+      {1004248800, -18000}, {1018162800, -14400}, {1035698400, -18000},
+      {1049612400, -14400}, {1067148000, -18000}, {1081062000, -14400},
+      {1099202400, -18000}, {1112511600, -14400}, {1130652000, -18000},
+      {1143961200, -14400}, {1162101600, -18000}
+    };
+    // Europe/London, explicit transitions since 1970
+    const Transition londonTransitions[] = {
+      {  57722400,      0}, {  69818400,   3600}, {  89172000,      0},
+      { 101268000,   3600}, { 120621600,      0}, { 132717600,   3600},
+      { 152071200,      0}, { 164167200,   3600}, { 183520800,      0},
+      { 196221600,   3600}, { 214970400,      0}, { 227671200,   3600},
+      { 246420000,      0}, { 259120800,   3600}, { 278474400,      0},
+      { 290570400,   3600}, { 309924000,      0}, { 322020000,   3600},
+      { 341373600,      0}, { 354675600,   3600}, { 372819600,      0},
+      { 386125200,   3600}, { 404269200,      0}, { 417574800,   3600},
+      { 435718800,      0}, { 449024400,   3600}, { 467773200,      0},
+      { 481078800,   3600}, { 499222800,      0}, { 512528400,   3600},
+      { 530672400,      0}, { 543978000,   3600}, { 562122000,      0},
+      { 575427600,   3600}, { 593571600,      0}, { 606877200,   3600},
+      { 625626000,      0}, { 638326800,   3600}, { 657075600,      0},
+      { 670381200,   3600}, { 688525200,      0}, { 701830800,   3600},
+      { 719974800,      0}, { 733280400,   3600}, { 751424400,      0},
+      { 764730000,   3600}, { 782874000,      0}, { 796179600,   3600},
+      { 814323600,      0}
+    };
+    // America/Sao_Paulo, explicit transitions since 1970
+    const Transition saoPauloTransitions[] = {
+      { 499748400,  -7200}, { 511236000, -10800}, { 530593200,  -7200},
+      { 540266400, -10800}, { 562129200,  -7200}, { 571197600, -10800},
+      { 592974000,  -7200}, { 602042400, -10800}, { 624423600,  -7200},
+      { 634701600, -10800}, { 656478000,  -7200}, { 666756000, -10800},
+      { 687927600,  -7200}, { 697600800, -10800}, { 719982000,  -7200},
+      { 728445600, -10800}, { 750826800,  -7200}, { 761709600, -10800},
+      { 782276400,  -7200}, { 793159200, -10800}, { 813726000,  -7200},
+      { 824004000, -10800}, { 844570800,  -7200}, { 856058400, -10800},
+      { 876106800,  -7200}, { 888717600, -10800}, { 908074800,  -7200},
+      { 919562400, -10800}, { 938919600,  -7200}, { 951616800, -10800},
+      { 970974000,  -7200}, { 982461600, -10800}, {1003028400,  -7200},
+      {1013911200, -10800}, {1036292400,  -7200}, {1045360800, -10800},
+      {1066532400,  -7200}, {1076810400, -10800}, {1099364400,  -7200},
+      {1108864800, -10800}, {1129431600,  -7200}, {1140314400, -10800},
+      {1162695600,  -7200}, {1172368800, -10800}, {1192330800,  -7200},
+      {1203213600, -10800}, {1224385200,  -7200}, {1234663200, -10800},
+      {1255834800,  -7200}, {1266717600, -10800}, {1287284400,  -7200},
+      {1298167200, -10800}, {1318734000,  -7200}, {1330221600, -10800},
+      {1350788400,  -7200}, {1361066400, -10800}, {1382238000,  -7200},
+      {1392516000, -10800}, {1413687600,  -7200}, {1424570400, -10800},
+      {1445137200,  -7200}, {1456020000, -10800}, {1476586800,  -7200},
+      {1487469600, -10800}, {1508036400,  -7200}, {1518919200, -10800},
+      {1541300400,  -7200}, {1550368800, -10800}
+    };
+    // Europe/Berlin, explicit transitions since 1970
+    const Transition frankfurtTransitions[] = {
+      { 323830800,   7200}, { 338950800,   3600}, { 354675600,   7200},
+      { 370400400,   3600}, { 386125200,   7200}, { 401850000,   3600},
+      { 417574800,   7200}, { 433299600,   3600}, { 449024400,   7200},
+      { 465354000,   3600}, { 481078800,   7200}, { 496803600,   3600},
+      { 512528400,   7200}, { 528253200,   3600}, { 543978000,   7200},
+      { 559702800,   3600}, { 575427600,   7200}, { 591152400,   3600},
+      { 606877200,   7200}, { 622602000,   3600}, { 638326800,   7200},
+      { 654656400,   3600}, { 670381200,   7200}, { 686106000,   3600},
+      { 701830800,   7200}, { 717555600,   3600}, { 733280400,   7200},
+      { 749005200,   3600}, { 764730000,   7200}, { 780454800,   3600},
+      { 796179600,   7200}, { 811904400,   3600}
+    };
+    // Australia/Sydney, explicit transitions since 1970
+    const Transition sydneyTransitions[] = {
+      {  57686400,  39600}, {  67968000,  36000}, {  89136000,  39600},
+      { 100022400,  36000}, { 120585600,  39600}, { 131472000,  36000},
+      { 152035200,  39600}, { 162921600,  36000}, { 183484800,  39600},
+      { 194976000,  36000}, { 215539200,  39600}, { 226425600,  36000},
+      { 246988800,  39600}, { 257875200,  36000}, { 278438400,  39600},
+      { 289324800,  36000}, { 309888000,  39600}, { 320774400,  36000},
+      { 341337600,  39600}, { 352224000,  36000}, { 372787200,  39600},
+      { 386697600,  36000}, { 404841600,  39600}, { 415728000,  36000},
+      { 436291200,  39600}, { 447177600,  36000}, { 467740800,  39600},
+      { 478627200,  36000}, { 499190400,  39600}, { 511286400,  36000},
+      { 530035200,  39600}, { 542736000,  36000}, { 562089600,  39600},
+      { 574790400,  36000}, { 594144000,  39600}, { 606240000,  36000},
+      { 625593600,  39600}, { 636480000,  36000}, { 657043200,  39600},
+      { 667929600,  36000}, { 688492800,  39600}, { 699379200,  36000},
+      { 719942400,  39600}, { 731433600,  36000}, { 751996800,  39600},
+      { 762883200,  36000}, { 783446400,  39600}, { 794332800,  36000},
+      { 814896000,  39600}, { 828201600,  36000}, { 846345600,  39600},
+      { 859651200,  36000}, { 877795200,  39600}, { 891100800,  36000},
+      { 909244800,  39600}, { 922550400,  36000}, { 941299200,  39600},
+      { 954000000,  36000}, { 967305600,  39600}, { 985449600,  36000},
+      {1004198400,  39600}, {1017504000,  36000}, {1035648000,  39600},
+      {1048953600,  36000}, {1067097600,  39600}, {1080403200,  36000},
+      {1099152000,  39600}, {1111852800,  36000}, {1130601600,  39600},
+      {1143907200,  36000}, {1162051200,  39600}, {1174752000,  36000},
+      {1193500800,  39600}
+    };
+
+    const Rule newYorkRule = {
+      2007, -18000, -14400, 3, 2, 0, 7200, 11, 1, 0, 7200 };
+    const Rule londonRule = {
+      1996, 0, 3600, 3, 5, 0, 3600, 10, 5, 0, 7200 };
+    const Rule frankfurtRule = {
+      1996, 3600, 7200, 3, 5, 0, 7200, 10, 5, 0, 10800 };
+    const Rule sydneyRule = {
+      2008, 36000, 39600, 10, 1, 0, 7200, 4, 1, 0, 10800 };
+
+    // ------------------------------------------------------------------------
+
+    BigInteger floorDivide(BigInteger a, BigInteger b) {
+      return a / b - (a % b < 0 ? 1 : 0);
+    }
+
+    // year of the given number of days since 1970-01-01
+    Integer yearFromDays(BigInteger days) {
+      Integer y, m, d;
+      detail::civilFromDays(days, y, m, d);
+      return y;
+    }
+
+    // day of the week (0 = Sunday) of the given number of days since
+    // 1970-01-01
+    Integer weekday(BigInteger days) {
+      return detail::weekdayFromSerial(days + detail::epochSerialNumber) - 1;
+    }
+
+    // days since 1970-01-01 of the n-th (5 = last) given weekday of the month
+    BigInteger nthWeekday(Integer y, Integer m, Integer n, Integer w) {
+      if (n == 5) {
+        const BigInteger last =
+          detail::daysFromCivil(y, m, detail::daysInMonth(y, m));
+        return last - (weekday(last) - w + 7) % 7;
+      }
+      const BigInteger first = detail::daysFromCivil(y, m, 1);
+      return first + (w - weekday(first) + 7) % 7 + 7 * (n - 1);
+    }
+
+    bool earlier(BigInteger t, const Transition& tr) {
+      return t < tr.utc;
+    }
+
+    bool transitionEarlier(const Transition& t1, const Transition& t2) {
+      return t1.utc < t2.utc;
+    }
+  }
+
+  class TimeZone::Impl {
+  public:
+    Impl(const std::string& name,
+         Integer initialOffset,
+         const Transition* begin,
+         const Transition* end,
+         const Rule* rule)
+      : name_(name), initialOffset_(initialOffset), transitions_(begin, end) {
+      if (rule) {
+        for (Integer y = rule->firstYear; y <= lastIndexedYear; ++y) {
+          Transition start = {
+            nthWeekday(y, rule->startMonth, rule->startWeek, rule->startWeekday)
+            * 86400 + rule->startTime - rule->standardOffset,
+            rule->daylightOffset };
+          Transition end = {
+            nthWeekday(y, rule->endMonth, rule->endWeek, rule->endWeekday)
+            * 86400 + rule->endTime - rule->daylightOffset,
+            rule->standardOffset };
+          transitions_.push_back(start);
+          transitions_.push_back(end);
+        }
+        std::sort(transitions_.begin(), transitions_.end(), transitionEarlier);
+      }
+
+      // yearIndex_[k] is the first transition on or after January 1st of
+      // year firstIndexedYear + k
+      yearIndex_.resize(lastIndexedYear - firstIndexedYear + 2);
+      Size i = 0;
+      for (Size k = 0; k < yearIndex_.size(); ++k) {
+        const BigInteger yearStart =
+          detail::daysFromCivil(firstIndexedYear + Integer(k), 1, 1) * 86400;
+        while (i < transitions_.size() && transitions_[i].utc < yearStart) {
+          ++i;
+        }
+        yearIndex_[k] = i;
+      }
+    }
+
+    const std::string& name() const { return name_; }
+
+    Integer utcOffset(BigInteger t) const {
+      if (transitions_.empty() || t < transitions_.front().utc) {
+        return initialOffset_;
+      }
+      // the first transition is after 1970, hence y >= firstIndexedYear
+      const Integer y = yearFromDays(floorDivide(t, 86400));
+      Size lo, hi;
+      if (y > lastIndexedYear) {
+        lo = yearIndex_.back();
+        hi = transitions_.size();
+      } else {
+        lo = yearIndex_[y - firstIndexedYear];
+        hi = yearIndex_[y - firstIndexedYear + 1];
+      }
+      const Size pos = std::upper_bound(transitions_.begin() + lo,
+                                        transitions_.begin() + hi,
+                                        t, earlier) - transitions_.begin();
+      return pos == 0 ? initialOffset_ : transitions_[pos - 1].offset;
+    }
+
+    Integer localOffset(BigInteger local) const {
+      // transitions are months apart: the offsets in force a day before
+      // and a day after are the only candidates.
+      const Integer before = utcOffset(local - 86400);
+      const Integer after = utcOffset(local + 86400);
+      if (before == after) {
+        return before;
+      }
+      const bool beforeValid = utcOffset(local - before) == before;
+      const bool afterValid = utcOffset(local - after) == after;
+      if (beforeValid && afterValid) {
+        // repeated local time: take the earlier instant
+        return before > after ? before : after;
+      } else if (afterValid) {
+        return after;
+      }
+      // valid with the earlier offset, or skipped local time
+      return before;
+    }
+
+  private:
+    std::string name_;
+    Integer initialOffset_;
+    std::vector<Transition> transitions_;
+    std::vector<Size> yearIndex_;
+  };
+
+  // ---------------------------------------------------------------------------
+
+#define MF_TRANSITIONS(table) table, table + sizeof(table) / sizeof(table[0])
+
+  TimeZone TimeZone::UTC() {
+    static const std::shared_ptr<const Impl> impl(
+      new Impl("UTC", 0, 0, 0, 0));
+    return TimeZone(impl);
+  }
+
+  TimeZone TimeZone::NewYork() {
+    static const std::shared_ptr<const Impl> impl(
+      new Impl("America/New_York", -18000,
+               MF_TRANSITIONS(newYorkTransitions), &newYorkRule));
+    return TimeZone(impl);
+  }
+
+  TimeZone TimeZone::London() {
+    static const std::shared_ptr<const Impl> impl(
+      new Impl("Europe/London", 3600,
+               MF_TRANSITIONS(londonTransitions), &londonRule));
+    return TimeZone(impl);
+  }
+
+  TimeZone TimeZone::SaoPaulo() {
+    static const std::shared_ptr<const Impl> impl(
+      new Impl("America/Sao_Paulo", -10800,
+               MF_TRANSITIONS(saoPauloTransitions), 0));
+    return TimeZone(impl);
+  }
+
+  TimeZone TimeZone::Frankfurt() {
+    static const std::shared_ptr<const Impl> impl(
+      new Impl("Europe/Berlin", 3600,
+               MF_TRANSITIONS(frankfurtTransitions), &frankfurtRule));
+    return TimeZone(impl);
+  }
+
+  TimeZone TimeZone::Sydney() {
+    static const std::shared_ptr<const Impl> impl(
+      new Impl("Australia/Sydney", 36000,
+               MF_TRANSITIONS(sydneyTransitions), &sydneyRule));
+    return TimeZone(impl);
+  }
+
+#undef MF_TRANSITIONS
+
+  // ---------------------------------------------------------------------------
+
+  std::string TimeZone::name() const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    return impl_->name();
+  }
+
+  Integer TimeZone::utcOffset(BigInteger utcSeconds) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    return impl_->utcOffset(utcSeconds);
+  }
+
+  Integer TimeZone::localOffset(BigInteger localSeconds) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    return impl_->localOffset(localSeconds);
+  }
+
+  Date TimeZone::toLocal(const Date& utc) const {
+    return Date(utc.dateTime()
+                + boost::posix_time::seconds(utcOffset(epochSeconds(utc))));
+  }
+
+  Date TimeZone::toUniversal(const Date& local) const {
+    return Date(local.dateTime()
+                - boost::posix_time::seconds(localOffset(epochSeconds(local))));
+  }
+
+  void TimeZone::toLocal(const std::vector<BigInteger>& utc,
+                         std::vector<BigInteger>& local) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    MF_TRACE_SPAN("TimeZone::toLocal[batch]", "timezone");
+    local.resize(utc.size());
+    for (Size i = 0; i < utc.size(); ++i) {
+      local[i] = utc[i] + impl_->utcOffset(utc[i]);
+    }
+  }
+
+  void TimeZone::toUniversal(const std::vector<BigInteger>& local,
+                             std::vector<BigInteger>& utc) const {
+    MF_REQUIRE(impl_, "no implementation provided");
+    MF_TRACE_SPAN("TimeZone::toUniversal[batch]", "timezone");
+    utc.resize(local.size());
+    for (Size i = 0; i < local.size(); ++i) {
+      utc[i] = local[i] - impl_->localOffset(local[i]);
+    }
+  }
+
+  BigInteger TimeZone::epochSeconds(const Date& d) {
+    static const boost::gregorian::date epoch(1970, boost::gregorian::Jan, 1);
+    const boost::posix_time::ptime& dt = d.dateTime();
+    return BigInteger((dt.date() - epoch).days()) * 86400
+      + dt.time_of_day().total_seconds();
+  }
+
+}
@@ -0,0 +1,200 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file timezone.hpp
+ * @brief embedded time-zone rules for exchange-local timestamps
+ */
+
+#ifndef MATHFIN_TIMEZONE_HPP
+#define MATHFIN_TIMEZONE_HPP
+
+#include <time/date.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MathFin {
+
+  /**
+   * Time zone of an exchange.
+   *
+   * The UTC offsets of the supported zones are compiled into the library
+   * from the IANA time-zone database, so that no tzdata file is needed at
+   * runtime.  Each zone is stored as a compact list of the transitions
+   * observed since 1970 followed by the recurring daylight-saving rule
+   * currently in force; the rule is expanded up to 2199 the first time the
+   * zone is used.  Offsets are looked up in constant time through a per-year
+   * index into the sorted transition table, followed by a binary search
+   * over the (at most few) transitions of that year.
+   *
+   * Timestamps before 1970 are given the offset in force on January 1st,
+   * 1970.
+   *
+   * The zones of the exchanges covered by the library calendars are
+   * provided:
+   *
+   * - UnitedStates::NYSE(): TimeZone::NewYork()
+   * - UnitedKingdom::Exchange(), UnitedKingdom::Metals(): TimeZone::London()
+   * - Brazil::Exchange(): TimeZone::SaoPaulo()
+   * - TARGET(): TimeZone::Frankfurt()
+   * - Australia(): TimeZone::Sydney()
+   *
+   * Integer timestamps are seconds since 1970-01-01T00:00:00 in the
+   * corresponding time scale (UTC or local).
+   *
+   * @ingroup datetime
+   */
+  class TimeZone {
+  public:
+    /**
+     * The default constructor returns a time zone with a null
+     * implementation, which is therefore unusable except as a
+     * placeholder.
+     */
+    TimeZone() {}
+
+    /**
+     * @name exchange time zones
+     * @{
+     */
+    static TimeZone UTC();
+    static TimeZone NewYork();   //!< America/New_York
+    static TimeZone London();    //!< Europe/London
+    static TimeZone SaoPaulo();  //!< America/Sao_Paulo
+    static TimeZone Frankfurt(); //!< Europe/Berlin
+    static TimeZone Sydney();    //!< Australia/Sydney
+    /** @} */
+
+    /**
+     * Returns whether or not the time zone is initialized
+     */
+    bool empty() const { return !impl_; }
+
+    /**
+     * Returns the IANA name of the time zone.
+     */
+    std::string name() const;
+
+    /**
+     * @name offsets
+     * @{
+     */
+
+    /**
+     * Offset from UTC in seconds (positive east of Greenwich) in force
+     * at the given UTC timestamp.
+     */
+    Integer utcOffset(BigInteger utcSeconds) const;
+
+    /**
+     * Offset from UTC in seconds in force at the given UTC date-time.
+     */
+    Integer utcOffset(const Date& utc) const {
+      return utcOffset(epochSeconds(utc));
+    }
+
+    /**
+     * Offset from UTC in seconds that applies to the given local
+     * timestamp.  Local times repeated when clocks go back resolve to the
+     * earlier instant; local times skipped when clocks go forward are
+     * interpreted with the offset in force before the change.
+     */
+    Integer localOffset(BigInteger localSeconds) const;
+
+    /** @} */
+
+    /**
+     * @name conversions
+     * @{
+     */
+
+    BigInteger toLocal(BigInteger utcSeconds) const {
+      return utcSeconds + utcOffset(utcSeconds);
+    }
+
+    BigInteger toUniversal(BigInteger localSeconds) const {
+      return localSeconds - localOffset(localSeconds);
+    }
+
+    /**
+     * Converts a UTC date-time to local time, keeping the sub-second part.
+     */
+    Date toLocal(const Date& utc) const;
+
+    /**
+     * Converts a local date-time to UTC, keeping the sub-second part.
+     */
+    Date toUniversal(const Date& local) const;
+
+    /**
+     * Batch conversion of UTC timestamps to local time; <tt>local</tt> is
+     * resized as needed and may not alias <tt>utc</tt>.
+     */
+    void toLocal(const std::vector<BigInteger>& utc,
+                 std::vector<BigInteger>& local) const;
+
+    /**
+     * Batch conversion of local timestamps to UTC; <tt>utc</tt> is resized
+     * as needed and may not alias <tt>local</tt>.
+     */
+    void toUniversal(const std::vector<BigInteger>& local,
+                     std::vector<BigInteger>& utc) const;
+
+    /** @} */
+
+    /**
+     * Whole seconds elapsed between 1970-01-01T00:00:00 and the given
+     * date-time; the sub-second part is discarded.
+     */
+    static BigInteger epochSeconds(const Date& d);
+
+  private:
+    class Impl;
+    TimeZone(const std::shared_ptr<const Impl>& impl) : impl_(impl) {}
+
+    std::shared_ptr<const Impl> impl_;
+  };
+
+  /**
+   * @relates TimeZone
+   */
+  inline bool operator==(const TimeZone& z1, const TimeZone& z2) {
+    return (z1.empty() && z2.empty())
+      || (!z1.empty() && !z2.empty() && z1.name() == z2.name());
+  }
+
+  /**
+   * @relates TimeZone
+   */
+  inline bool operator!=(const TimeZone& z1, const TimeZone& z2) {
+    return !(z1 == z2);
+  }
+
+  /**
+   * @relates TimeZone
+   */
+  inline std::ostream& operator<<(std::ostream& out, const TimeZone& z) {
+    return out << z.name();
+  }
+
+}
+
+#endif /* MATHFIN_TIMEZONE_HPP */
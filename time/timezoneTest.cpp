@@ -0,0 +1,97 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+
+#include <test/catch.hpp>
+#include <base/error.hpp>
+#include <time/timezone.hpp>
+
+using namespace MathFin;
+
+TEST_CASE("Epoch seconds", "[timezone]") {
+  REQUIRE(TimeZone::epochSeconds(Date(1, Month::January, 1970, 0, 0, 0)) == 0);
+  REQUIRE(TimeZone::epochSeconds(Date(13, Month::March, 2016, 7, 0, 0, 999))
+          == 1457852400);
+  REQUIRE(TimeZone::epochSeconds(Date(31, Month::December, 1969, 23, 0, 0))
+          == -3600);
+}
+
+TEST_CASE("Daylight-saving transitions", "[timezone]") {
+  TimeZone newYork = TimeZone::NewYork();
+  // clocks go forward at 2016-03-13T07:00:00Z
+  REQUIRE(newYork.utcOffset(1457852399) == -18000);
+  REQUIRE(newYork.utcOffset(1457852400) == -14400);
+  // and back at 2016-11-06T06:00:00Z
+  REQUIRE(newYork.utcOffset(1478411999) == -14400);
+  REQUIRE(newYork.utcOffset(1478412000) == -18000);
+
+  // London, 2016-03-27T01:00:00Z
+  REQUIRE(TimeZone::London().utcOffset(1459040399) == 0);
+  REQUIRE(TimeZone::London().utcOffset(1459040400) == 3600);
+  // Sydney, 2016-10-01T16:00:00Z
+  REQUIRE(TimeZone::Sydney().utcOffset(1475337599) == 36000);
+  REQUIRE(TimeZone::Sydney().utcOffset(1475337600) == 39600);
+  // Sao Paulo, 2018-11-04T03:00:00Z; no daylight saving since 2019
+  REQUIRE(TimeZone::SaoPaulo().utcOffset(1541300400) == -7200);
+  REQUIRE(TimeZone::SaoPaulo().utcOffset(
+            Date(1, Month::January, 2020, 12, 0, 0)) == -10800);
+  // rules are extended to the end of the supported date range
+  REQUIRE(TimeZone::Frankfurt().utcOffset(
+            Date(1, Month::July, 2150, 12, 0, 0)) == 7200);
+  REQUIRE(TimeZone::UTC().utcOffset(1457852400) == 0);
+}
+
+TEST_CASE("Local to universal time", "[timezone]") {
+  TimeZone newYork = TimeZone::NewYork();
+
+  Date utc(13, Month::March, 2016, 12, 0, 0, 250);
+  Date local = newYork.toLocal(utc);
+  REQUIRE(local == Date(13, Month::March, 2016, 8, 0, 0, 250));
+  REQUIRE(newYork.toUniversal(local) == utc);
+
+  // 01:30 occurs twice on 2016-11-06: the earlier instant is chosen
+  REQUIRE(newYork.toUniversal(Date(6, Month::November, 2016, 1, 30, 0))
+          == Date(6, Month::November, 2016, 5, 30, 0));
+  // 02:30 does not exist on 2016-03-13
+  REQUIRE(newYork.toUniversal(Date(13, Month::March, 2016, 2, 30, 0))
+          == Date(13, Month::March, 2016, 7, 30, 0));
+}
+
+TEST_CASE("Batch conversion", "[timezone]") {
+  TimeZone london = TimeZone::London();
+  std::vector<BigInteger> utc;
+  utc.push_back(1459040399);
+  utc.push_back(1459040400);
+  utc.push_back(1459040400 + 86400);
+
+  std::vector<BigInteger> local, back;
+  london.toLocal(utc, local);
+  REQUIRE(local.size() == 3);
+  REQUIRE(local[0] == 1459040399);
+  REQUIRE(local[1] == 1459040400 + 3600);
+  REQUIRE(local[2] == 1459040400 + 86400 + 3600);
+
+  london.toUniversal(local, back);
+  REQUIRE(back == utc);
+
+  REQUIRE(london == TimeZone::London());
+  REQUIRE(london != TimeZone::Frankfurt());
+  REQUIRE_THROWS_AS(TimeZone().utcOffset(0), Error);
+}
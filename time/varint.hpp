@@ -0,0 +1,84 @@
+/*
+  Copyright (C) 2017 Ahmed Riza
+
+  This file is part of MathFin.
+
+  This program is free software: you  can redistribute it and/or modify it
+  under the  terms of the GNU  General Public License as  published by the
+  Free Software Foundation,  either version 3 of the License,  or (at your
+  option) any later version.
+
+  This  program  is distributed  in  the  hope  that  it will  be  useful,
+  but  WITHOUT  ANY  WARRANTY;  without   even  the  implied  warranty  of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+  Public License for more details.
+
+  You should have received a copy  of the GNU General Public License along
+  with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file varint.hpp
+ * @brief LEB128 varints and zig-zag encoding of integers
+ */
+
+#ifndef MATHFIN_VARINT_HPP
+#define MATHFIN_VARINT_HPP
+
+#include <base/error.hpp>
+#include <base/types.hpp>
+
+#include <vector>
+
+namespace MathFin {
+
+  namespace detail {
+
+    inline void putVarint(std::vector<unsigned char>& out, BigNatural n) {
+      while (n >= 0x80) {
+        out.push_back(static_cast<unsigned char>(n | 0x80));
+        n >>= 7;
+      }
+      out.push_back(static_cast<unsigned char>(n));
+    }
+
+    inline Size varintSize(BigNatural n) {
+      Size size = 1;
+      while (n >= 0x80) {
+        n >>= 7;
+        ++size;
+      }
+      return size;
+    }
+
+    /**
+     * Reads a varint at <tt>p</tt>, advancing it; throws an Error if the
+     * input ends before <tt>end</tt> or the varint is malformed.
+     */
+    inline BigNatural getVarint(const unsigned char*& p,
+                                const unsigned char* end) {
+      BigNatural n = 0;
+      for (Size shift = 0; ; shift += 7) {
+        MF_REQUIRE(p != end, "truncated binary input");
+        MF_REQUIRE(shift < 64, "malformed varint in binary input");
+        const unsigned char byte = *p++;
+        n |= BigNatural(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+          return n;
+        }
+      }
+    }
+
+    inline BigNatural zigzag(BigInteger n) {
+      return n < 0 ? ~(BigNatural(n) << 1) : BigNatural(n) << 1;
+    }
+
+    inline BigInteger unzigzag(BigNatural n) {
+      return (n & 1) ? -BigInteger(n >> 1) - 1 : BigInteger(n >> 1);
+    }
+
+  }
+
+}
+
+#endif /* MATHFIN_VARINT_HPP */